@@ -0,0 +1,187 @@
+#include "almacenparticulas.h"
+
+namespace {
+
+// Permuta a través de 'trabajo', que queda con el arreglo viejo: con la
+// capacidad ya reservada, reordenar periódicamente no pide memoria
+template <typename U>
+void aplicarOrden(std::vector<U>& arreglo, const std::vector<int>& orden, std::vector<U>& trabajo) {
+    trabajo.resize(orden.size());
+    for (size_t k = 0; k < orden.size(); k++) trabajo[k] = arreglo[orden[k]];
+    arreglo.swap(trabajo);
+}
+
+} // namespace
+
+// --- Gestión ---
+template <typename T>
+int AlmacenParticulasT<T>::agregar(int nuevoId, T px, T py, T pvx, T pvy, T m, T r) {
+    // Reciclar un slot libre si lo hay
+    int slot;
+    if (!slotsLibres.empty()) {
+        slot = slotsLibres.back();
+        slotsLibres.pop_back();
+    } else {
+        slot = densoDeSlot.size();
+        densoDeSlot.push_back(-1);
+        generacion.push_back(0);
+    }
+
+    int indice = tamano();
+    densoDeSlot[slot] = indice;
+    slotDe.push_back(slot);
+
+    id.push_back(nuevoId);
+    x.push_back(px);
+    y.push_back(py);
+    vx.push_back(pvx);
+    vy.push_back(pvy);
+    masa.push_back(m);
+    radio.push_back(r);
+    activa.push_back(1);
+    contactoParedes.push_back(0);
+    contactoObstaculo.push_back(-1);
+    return indice;
+}
+
+template <typename T>
+int AlmacenParticulasT<T>::compactar() {
+    int n = tamano();
+    int escritura = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (activa[i]) {
+            if (escritura != i) moverEntrada(i, escritura);
+            escritura++;
+        } else {
+            // Liberar el slot: los manejadores viejos quedan inválidos
+            int slot = slotDe[i];
+            densoDeSlot[slot] = -1;
+            generacion[slot]++;
+            slotsLibres.push_back(slot);
+        }
+    }
+
+    int eliminadas = n - escritura;
+    if (eliminadas > 0) {
+        id.resize(escritura);
+        x.resize(escritura);
+        y.resize(escritura);
+        vx.resize(escritura);
+        vy.resize(escritura);
+        masa.resize(escritura);
+        radio.resize(escritura);
+        activa.resize(escritura);
+        contactoParedes.resize(escritura);
+        contactoObstaculo.resize(escritura);
+        slotDe.resize(escritura);
+    }
+    return eliminadas;
+}
+
+template <typename T>
+void AlmacenParticulasT<T>::reordenar(const std::vector<int>& orden) {
+    aplicarOrden(id, orden, trabajoEntero);
+    aplicarOrden(x, orden, trabajoEscalar);
+    aplicarOrden(y, orden, trabajoEscalar);
+    aplicarOrden(vx, orden, trabajoEscalar);
+    aplicarOrden(vy, orden, trabajoEscalar);
+    aplicarOrden(masa, orden, trabajoEscalar);
+    aplicarOrden(radio, orden, trabajoEscalar);
+    aplicarOrden(activa, orden, trabajoByte);
+    aplicarOrden(contactoParedes, orden, trabajoByte);
+    aplicarOrden(contactoObstaculo, orden, trabajoEntero);
+    aplicarOrden(slotDe, orden, trabajoEntero);
+    for (int i = 0; i < tamano(); i++) densoDeSlot[slotDe[i]] = i;
+}
+
+template <typename T>
+void AlmacenParticulasT<T>::moverEntrada(int desde, int hacia) {
+    id[hacia] = id[desde];
+    x[hacia] = x[desde];
+    y[hacia] = y[desde];
+    vx[hacia] = vx[desde];
+    vy[hacia] = vy[desde];
+    masa[hacia] = masa[desde];
+    radio[hacia] = radio[desde];
+    activa[hacia] = activa[desde];
+    contactoParedes[hacia] = contactoParedes[desde];
+    contactoObstaculo[hacia] = contactoObstaculo[desde];
+    slotDe[hacia] = slotDe[desde];
+    densoDeSlot[slotDe[hacia]] = hacia;
+}
+
+template <typename T>
+void AlmacenParticulasT<T>::reservar(int capacidad) {
+    id.reserve(capacidad);
+    x.reserve(capacidad);
+    y.reserve(capacidad);
+    vx.reserve(capacidad);
+    vy.reserve(capacidad);
+    masa.reserve(capacidad);
+    radio.reserve(capacidad);
+    activa.reserve(capacidad);
+    contactoParedes.reserve(capacidad);
+    contactoObstaculo.reserve(capacidad);
+    slotDe.reserve(capacidad);
+    densoDeSlot.reserve(capacidad);
+    generacion.reserve(capacidad);
+    slotsLibres.reserve(capacidad);
+}
+
+template <typename T>
+void AlmacenParticulasT<T>::limpiar() {
+    id.clear();
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    masa.clear();
+    radio.clear();
+    activa.clear();
+    contactoParedes.clear();
+    contactoObstaculo.clear();
+    slotDe.clear();
+    densoDeSlot.clear();
+    generacion.clear();
+    slotsLibres.clear();
+}
+
+// --- Manejadores ---
+template <typename T>
+ManejadorParticula AlmacenParticulasT<T>::manejadorDe(int i) const {
+    ManejadorParticula h;
+    h.slot = slotDe[i];
+    h.generacion = generacion[h.slot];
+    return h;
+}
+
+template <typename T>
+int AlmacenParticulasT<T>::indiceDe(const ManejadorParticula& h) const {
+    if (h.slot < 0 || h.slot >= static_cast<int>(densoDeSlot.size())) return -1;
+    if (generacion[h.slot] != h.generacion) return -1;
+    return densoDeSlot[h.slot];
+}
+
+// --- Vista tipo Particula ---
+template <typename T>
+ParticulaT<T> AlmacenParticulasT<T>::obtener(int i) const {
+    ParticulaT<T> p(id[i], x[i], y[i], vx[i], vy[i], masa[i], radio[i]);
+    p.setActiva(activa[i] != 0);
+    return p;
+}
+
+template <typename T>
+void AlmacenParticulasT<T>::guardar(int i, const ParticulaT<T>& p) {
+    VectorT<T> pos = p.getPosicion();
+    VectorT<T> vel = p.getVelocidad();
+    x[i] = pos.getX();
+    y[i] = pos.getY();
+    vx[i] = vel.getX();
+    vy[i] = vel.getY();
+    activa[i] = p.estaActiva() ? 1 : 0;
+}
+
+// --- Instancias ---
+template class AlmacenParticulasT<float>;
+template class AlmacenParticulasT<double>;
@@ -0,0 +1,106 @@
+#ifndef ALMACEN_PARTICULAS_H
+#define ALMACEN_PARTICULAS_H
+
+#include <vector>
+#include "particula.h"
+
+/**
+ * @brief Referencia estable a una partícula del almacén
+ *
+ * Sobrevive a la compactación del almacén. Si la partícula muere, el slot
+ * se recicla con otra generación y el manejador queda inválido.
+ */
+struct ManejadorParticula {
+    int slot = -1;
+    unsigned generacion = 0;
+};
+
+/**
+ * @brief Almacenamiento contiguo de partículas (estructura de arreglos)
+ *
+ * Cada atributo vive en su propio arreglo para que los bucles del paso
+ * (integración, paredes, broadphase) recorran memoria secuencial en lugar
+ * de seguir punteros a objetos Particula sueltos en el heap.
+ * Para el código que trabaja con Particula se ofrece una vista por copia:
+ * obtener() arma una Particula con el estado del índice i y guardar()
+ * escribe de vuelta posición, velocidad y estado.
+ * El escalar T (float o double) es el de posiciones, velocidades, masas
+ * y radios; AlmacenParticulas es la versión en double.
+ *
+ * Funciona como slot map: los arreglos densos solo contienen partículas
+ * vivas después de compactar(), y los slots de las muertas se reciclan
+ * (con la generación incrementada) para las nuevas. En régimen estable no
+ * se reserva memoria: las altas reutilizan slots y capacidad existentes.
+ * reordenar() permuta los arreglos densos (p. ej. en orden de Morton) y
+ * actualiza la tabla de slots, así que los manejadores siguen valiendo.
+ */
+template <typename T>
+class AlmacenParticulasT {
+public:
+    // --- Arreglos (SoA), acceso directo en los bucles del paso ---
+    std::vector<int> id;
+    std::vector<T> x;
+    std::vector<T> y;
+    std::vector<T> vx;
+    std::vector<T> vy;
+    std::vector<T> masa;
+    std::vector<T> radio;
+    std::vector<unsigned char> activa;   // 0 = pendiente de eliminar en compactar()
+
+    // --- Estado de contacto: solo el inicio de un contacto es un evento ---
+    std::vector<unsigned char> contactoParedes;   // Bits PARED_* tocadas en el paso anterior
+    std::vector<int> contactoObstaculo;           // Obstáculo tocado (-1 si ninguno)
+
+    static constexpr unsigned char PARED_IZQUIERDA = 1;
+    static constexpr unsigned char PARED_DERECHA = 2;
+    static constexpr unsigned char PARED_INFERIOR = 4;
+    static constexpr unsigned char PARED_SUPERIOR = 8;
+
+private:
+    // --- Tabla de slots ---
+    std::vector<int> slotDe;             // Slot de cada índice denso
+    std::vector<int> densoDeSlot;        // Índice denso de cada slot (-1 si libre)
+    std::vector<unsigned> generacion;    // Generación actual de cada slot
+    std::vector<int> slotsLibres;        // Slots reciclables
+
+    // --- Trabajo de reordenar (se reutiliza entre llamadas) ---
+    std::vector<T> trabajoEscalar;
+    std::vector<int> trabajoEntero;
+    std::vector<unsigned char> trabajoByte;
+
+public:
+    // --- Gestión ---
+    int agregar(int id, T x, T y, T vx, T vy, T masa, T radio);
+    int compactar();                     // Elimina las inactivas, conserva el orden
+    void reordenar(const std::vector<int>& orden);   // Nuevo i = viejo orden[i]
+    void reservar(int capacidad);
+    void limpiar();
+    int tamano() const { return static_cast<int>(id.size()); }
+
+    // --- Manejadores ---
+    ManejadorParticula manejadorDe(int i) const;
+    int indiceDe(const ManejadorParticula& h) const;   // -1 si el manejador caducó
+    bool esValido(const ManejadorParticula& h) const { return indiceDe(h) >= 0; }
+
+    // --- Vista tipo Particula ---
+    ParticulaT<T> obtener(int i) const;
+    void guardar(int i, const ParticulaT<T>& p);
+
+    // --- Detección (misma fórmula que Particula::colisionaCon) ---
+    bool colisionan(int i, int j) const {
+        T dx = x[j] - x[i];
+        T dy = y[j] - y[i];
+        T suma = radio[i] + radio[j];
+        return dx * dx + dy * dy <= suma * suma;
+    }
+
+private:
+    void moverEntrada(int desde, int hacia);
+};
+
+using AlmacenParticulas = AlmacenParticulasT<double>;
+
+extern template class AlmacenParticulasT<float>;
+extern template class AlmacenParticulasT<double>;
+
+#endif // ALMACEN_PARTICULAS_H
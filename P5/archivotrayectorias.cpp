@@ -0,0 +1,271 @@
+#include "archivotrayectorias.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+static_assert(sizeof(EntradaIndice) == 24, "El índice se escribe con entradas de 24 bytes");
+static_assert(sizeof(int) == sizeof(int32_t), "Los ids se guardan como int32");
+
+namespace {
+
+template <typename T>
+void agregarValor(vector<char>& buffer, const T& valor) {
+    size_t inicio = buffer.size();
+    buffer.resize(inicio + sizeof(T));
+    memcpy(buffer.data() + inicio, &valor, sizeof(T));
+}
+
+template <typename T>
+void agregarArreglo(vector<char>& buffer, const vector<T>& valores) {
+    size_t inicio = buffer.size();
+    size_t bytes = valores.size() * sizeof(T);
+    buffer.resize(inicio + bytes);
+    if (bytes > 0) memcpy(buffer.data() + inicio, valores.data(), bytes);
+}
+
+void rellenarHasta(vector<char>& buffer, size_t alineacion) {
+    buffer.resize((buffer.size() + alineacion - 1) / alineacion * alineacion, '\0');
+}
+
+template <typename T>
+T leerValor(const char* datos) {
+    T valor;
+    memcpy(&valor, datos, sizeof(T));
+    return valor;
+}
+
+size_t alinear8(size_t bytes) {
+    return (bytes + 7) / 8 * 8;
+}
+
+} // namespace
+
+// ============================================================================
+// ESCRITURA
+// ============================================================================
+
+EscritorArchivo::EscritorArchivo(double dt, double ancho, double alto, int framesPorBloque)
+    : EscritorTrayectorias(), framesEnBloque(0), offsetBloque(0),
+    framesPorBloque(framesPorBloque < 1 ? 1 : framesPorBloque),
+    dt(dt), ancho(ancho), alto(alto) {}
+
+EscritorArchivo::~EscritorArchivo() {
+    cerrar();
+}
+
+bool EscritorArchivo::abrir() {
+    archivo.open("trayectorias.p5a", ios::binary);
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir trayectorias.p5a" << endl;
+        return false;
+    }
+
+    vector<char> cabecera;
+    cabecera.insert(cabecera.end(), MAGIA, MAGIA + sizeof(MAGIA));
+    agregarValor(cabecera, VERSION);
+    agregarValor(cabecera, static_cast<uint32_t>(framesPorBloque));
+    agregarValor(cabecera, ALINEACION);
+    agregarValor(cabecera, static_cast<uint32_t>(0));
+    agregarValor(cabecera, dt);
+    agregarValor(cabecera, ancho);
+    agregarValor(cabecera, alto);
+    rellenarHasta(cabecera, ALINEACION);   // El primer bloque queda alineado
+
+    archivo.write(cabecera.data(), cabecera.size());
+    bytesEscritos += cabecera.size();
+    offsetBloque = cabecera.size();
+
+    bloque.assign(BYTES_CABECERA_BLOQUE, '\0');
+    return true;
+}
+
+void EscritorArchivo::escribirFrame(const FrameTrayectoria& frame) {
+    if (!archivo.is_open()) return;
+
+    uint32_t cantidad = frame.cantidad();
+
+    // Con muchas partículas el tope lo pone la memoria y no framesPorBloque:
+    // el frame que no cabe abre un bloque nuevo (el índice guarda su offset)
+    size_t bytesFrame = 16 + alinear8(cantidad * sizeof(int32_t)) + 4 * cantidad * sizeof(double);
+    if (framesEnBloque > 0 && bloque.size() + bytesFrame > BYTES_MAXIMOS_BLOQUE) cerrarBloque();
+
+    EntradaIndice entrada;
+    entrada.paso = frame.paso;
+    entrada.cantidad = cantidad;
+    entrada.tiempo = frame.tiempo;
+    entrada.offset = offsetBloque + bloque.size();
+    indice.push_back(entrada);
+
+    agregarValor(bloque, static_cast<int32_t>(frame.paso));
+    agregarValor(bloque, cantidad);
+    agregarValor(bloque, frame.tiempo);
+    agregarArreglo(bloque, frame.id);
+    rellenarHasta(bloque, 8);
+    agregarArreglo(bloque, frame.x);
+    agregarArreglo(bloque, frame.y);
+    agregarArreglo(bloque, frame.vx);
+    agregarArreglo(bloque, frame.vy);
+
+    if (++framesEnBloque >= framesPorBloque) cerrarBloque();
+}
+
+void EscritorArchivo::cerrarBloque() {
+    if (framesEnBloque == 0) return;
+
+    uint32_t numFrames = framesEnBloque;
+    uint64_t bytes = bloque.size();
+    memcpy(bloque.data(), &numFrames, sizeof(numFrames));
+    memcpy(bloque.data() + 8, &bytes, sizeof(bytes));
+    rellenarHasta(bloque, ALINEACION);
+
+    archivo.write(bloque.data(), bloque.size());
+    bytesEscritos += bloque.size();
+    offsetBloque += bloque.size();
+
+    bloque.assign(BYTES_CABECERA_BLOQUE, '\0');
+    framesEnBloque = 0;
+}
+
+void EscritorArchivo::cerrar() {
+    if (!archivo.is_open()) return;
+    cerrarBloque();
+
+    // Índice y cola al final del archivo
+    uint64_t offsetIndice = offsetBloque;
+    uint64_t numFrames = indice.size();
+    vector<char> pie;
+    for (const EntradaIndice& e : indice) {
+        agregarValor(pie, e.paso);
+        agregarValor(pie, e.cantidad);
+        agregarValor(pie, e.tiempo);
+        agregarValor(pie, e.offset);
+    }
+    agregarValor(pie, offsetIndice);
+    agregarValor(pie, numFrames);
+    pie.insert(pie.end(), MAGIA_INDICE, MAGIA_INDICE + sizeof(MAGIA_INDICE));
+
+    archivo.write(pie.data(), pie.size());
+    bytesEscritos += pie.size();
+    archivo.close();
+    indice.clear();
+}
+
+// ============================================================================
+// LECTURA
+// ============================================================================
+
+LectorArchivo::LectorArchivo() : framesPorBloque(0), dt(0), ancho(0), alto(0) {}
+
+bool LectorArchivo::abrir(const string& ruta) {
+    cerrar();
+    archivo.open(ruta, ios::binary);
+    if (!archivo.is_open()) return false;
+
+    // Cabecera
+    char cabecera[EscritorArchivo::BYTES_CABECERA];
+    if (!archivo.read(cabecera, sizeof(cabecera)) ||
+        memcmp(cabecera, EscritorArchivo::MAGIA, 8) != 0) {
+        cerrar();
+        return false;
+    }
+    framesPorBloque = leerValor<uint32_t>(cabecera + 12);
+    dt = leerValor<double>(cabecera + 24);
+    ancho = leerValor<double>(cabecera + 32);
+    alto = leerValor<double>(cabecera + 40);
+
+    // Cola -> índice
+    char cola[EscritorArchivo::BYTES_COLA];
+    archivo.seekg(-static_cast<streamoff>(sizeof(cola)), ios::end);
+    if (!archivo.read(cola, sizeof(cola)) ||
+        memcmp(cola + 16, EscritorArchivo::MAGIA_INDICE, 8) != 0) {
+        cerrar();
+        return false;
+    }
+    uint64_t offsetIndice = leerValor<uint64_t>(cola);
+    uint64_t numFrames = leerValor<uint64_t>(cola + 8);
+
+    vector<char> datos(numFrames * sizeof(EntradaIndice));
+    archivo.seekg(offsetIndice);
+    archivo.read(datos.data(), datos.size());
+    indice.resize(numFrames);
+    for (uint64_t k = 0; k < numFrames; k++) {
+        const char* p = datos.data() + k * sizeof(EntradaIndice);
+        indice[k].paso = leerValor<int32_t>(p);
+        indice[k].cantidad = leerValor<uint32_t>(p + 4);
+        indice[k].tiempo = leerValor<double>(p + 8);
+        indice[k].offset = leerValor<uint64_t>(p + 16);
+    }
+    return static_cast<bool>(archivo);
+}
+
+void LectorArchivo::cerrar() {
+    if (archivo.is_open()) archivo.close();
+    archivo.clear();
+    indice.clear();
+}
+
+// --- Consultas sobre el índice ---
+int LectorArchivo::numeroFrames() const {
+    return indice.size();
+}
+
+int LectorArchivo::buscarPaso(int paso) const {
+    auto it = lower_bound(indice.begin(), indice.end(), paso,
+                          [](const EntradaIndice& e, int p) { return e.paso < p; });
+    if (it == indice.end() || it->paso != paso) return -1;
+    return it - indice.begin();
+}
+
+int LectorArchivo::buscarTiempo(double tiempo) const {
+    auto it = upper_bound(indice.begin(), indice.end(), tiempo,
+                          [](double t, const EntradaIndice& e) { return t < e.tiempo; });
+    return static_cast<int>(it - indice.begin()) - 1;
+}
+
+const EntradaIndice& LectorArchivo::getEntrada(int indiceFrame) const {
+    return indice[indiceFrame];
+}
+
+// --- Lectura ---
+bool LectorArchivo::leerFrame(int indiceFrame, FrameTrayectoria& frame) {
+    if (indiceFrame < 0 || indiceFrame >= numeroFrames()) return false;
+    const EntradaIndice& e = indice[indiceFrame];
+    size_t n = e.cantidad;
+
+    frame.limpiar();
+    frame.paso = e.paso;
+    frame.tiempo = e.tiempo;
+    frame.id.resize(n);
+    frame.x.resize(n);
+    frame.y.resize(n);
+    frame.vx.resize(n);
+    frame.vy.resize(n);
+
+    // Saltar la cabecera del frame (16 bytes) y leer los arreglos
+    archivo.clear();
+    archivo.seekg(e.offset + 16);
+    archivo.read(reinterpret_cast<char*>(frame.id.data()), n * sizeof(int32_t));
+    archivo.seekg(e.offset + 16 + alinear8(n * sizeof(int32_t)));
+    archivo.read(reinterpret_cast<char*>(frame.x.data()), n * sizeof(double));
+    archivo.read(reinterpret_cast<char*>(frame.y.data()), n * sizeof(double));
+    archivo.read(reinterpret_cast<char*>(frame.vx.data()), n * sizeof(double));
+    archivo.read(reinterpret_cast<char*>(frame.vy.data()), n * sizeof(double));
+    return static_cast<bool>(archivo);
+}
+
+int LectorArchivo::leerVentana(double t0, double t1, vector<FrameTrayectoria>& frames) {
+    frames.clear();
+    int desde = max(0, buscarTiempo(t0));
+    if (desde < numeroFrames() && indice[desde].tiempo < t0) desde++;
+
+    for (int k = desde; k < numeroFrames() && indice[k].tiempo <= t1; k++) {
+        frames.emplace_back();
+        if (!leerFrame(k, frames.back())) {
+            frames.pop_back();
+            break;
+        }
+    }
+    return frames.size();
+}
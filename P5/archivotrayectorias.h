@@ -0,0 +1,123 @@
+#ifndef ARCHIVO_TRAYECTORIAS_H
+#define ARCHIVO_TRAYECTORIAS_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include "escritortrayectorias.h"
+
+/**
+ * @brief Entrada del índice del archivo: un frame por entrada
+ */
+struct EntradaIndice {
+    int32_t paso;
+    uint32_t cantidad;
+    double tiempo;
+    uint64_t offset;       // Posición del frame dentro del archivo
+};
+
+/**
+ * @brief Archivo de trayectorias por bloques con índice (trayectorias.p5a)
+ *
+ * Pensado para leer el estado en un tiempo t o una ventana de tiempo sin
+ * recorrer todo el archivo. Orden de bytes de la máquina, sin relleno
+ * implícito entre campos.
+ *
+ * Cabecera (48 bytes):
+ *   char[8]  magia             "P5ARCH" + 2 x '\0'
+ *   uint32   version           1
+ *   uint32   framesPorBloque   máximo; un bloque también se cierra al pasar
+ *                              BYTES_MAXIMOS_BLOQUE
+ *   uint32   alineacion        4096: cada bloque empieza en múltiplo de este valor
+ *   uint32   reservado
+ *   double   dt, ancho, alto
+ *   relleno hasta 'alineacion' (el primer bloque empieza en 4096)
+ *
+ * Bloque (alineado a 'alineacion'):
+ *   uint32   numFrames, uint32 reservado, uint64 bytes del bloque
+ *   numFrames frames, cada uno alineado a 8 bytes:
+ *     int32 paso; uint32 cantidad; double tiempo;
+ *     int32  id[cantidad]      (+ relleno a 8)
+ *     double x[cantidad], y[cantidad], vx[cantidad], vy[cantidad]
+ *
+ * Índice (al final, alineado a 8): una EntradaIndice (24 bytes) por frame,
+ * ordenadas por paso y tiempo.
+ *
+ * Cola (últimos 24 bytes):
+ *   uint64 offset del índice, uint64 número de frames, char[8] "P5INDEX"
+ *
+ * Los arreglos de cada frame quedan alineados a 8 bytes, así que el archivo
+ * se puede mapear en memoria (mmap) y usar los datos sin copiarlos.
+ */
+class EscritorArchivo : public EscritorTrayectorias {
+private:
+    std::ofstream archivo;
+    std::vector<char> bloque;              // Bloque en construcción
+    std::vector<EntradaIndice> indice;
+    int framesEnBloque;
+    uint64_t offsetBloque;                 // Donde empezará el bloque actual
+    int framesPorBloque;
+    double dt;
+    double ancho;
+    double alto;
+
+public:
+    static constexpr char MAGIA[8] = {'P', '5', 'A', 'R', 'C', 'H', '\0', '\0'};
+    static constexpr char MAGIA_INDICE[8] = {'P', '5', 'I', 'N', 'D', 'E', 'X', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t BYTES_CABECERA = 48;
+    static constexpr uint32_t BYTES_CABECERA_BLOQUE = 16;
+    static constexpr uint32_t BYTES_COLA = 24;
+    static constexpr uint32_t ALINEACION = 4096;
+    static constexpr size_t BYTES_MAXIMOS_BLOQUE = 16 << 20;   // Tope de memoria del bloque
+
+    EscritorArchivo(double dt, double ancho, double alto, int framesPorBloque = 64);
+    ~EscritorArchivo() override;
+
+    bool abrir() override;
+    void escribirFrame(const FrameTrayectoria& frame) override;
+    void cerrar() override;
+
+private:
+    void cerrarBloque();
+};
+
+/**
+ * @brief Lectura con acceso aleatorio de trayectorias.p5a
+ *
+ * Solo se cargan el índice y la cabecera; cada consulta busca en el índice
+ * (O(log n)) y lee únicamente los bytes del frame pedido.
+ */
+class LectorArchivo {
+private:
+    std::ifstream archivo;
+    std::vector<EntradaIndice> indice;
+    uint32_t framesPorBloque;
+    double dt;
+    double ancho;
+    double alto;
+
+public:
+    LectorArchivo();
+
+    bool abrir(const std::string& ruta);
+    void cerrar();
+
+    // --- Consultas sobre el índice (búsqueda binaria) ---
+    int numeroFrames() const;
+    int buscarPaso(int paso) const;          // -1 si no está
+    int buscarTiempo(double tiempo) const;   // Último frame con tiempo <= t (-1 si ninguno)
+    const EntradaIndice& getEntrada(int indiceFrame) const;
+
+    // --- Lectura ---
+    bool leerFrame(int indiceFrame, FrameTrayectoria& frame);
+    int leerVentana(double t0, double t1, std::vector<FrameTrayectoria>& frames);
+
+    // --- Cabecera ---
+    double getDt() const { return dt; }
+    double getAncho() const { return ancho; }
+    double getAlto() const { return alto; }
+};
+
+#endif // ARCHIVO_TRAYECTORIAS_H
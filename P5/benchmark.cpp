@@ -0,0 +1,1811 @@
+#include "benchmark.h"
+#include "grillaespacial.h"
+#include "grillajerarquica.h"
+#include "particula.h"
+#include "simulador.h"
+#include "archivotrayectorias.h"
+#include "compresiontrayectorias.h"
+#include "eventostrayectorias.h"
+#include "kernelsparticulas.h"
+#include "bvhobstaculos.h"
+#include "campodistancia.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+using Reloj = chrono::steady_clock;
+
+double milisegundosDesde(Reloj::time_point inicio) {
+    return chrono::duration<double, milli>(Reloj::now() - inicio).count();
+}
+
+// Caja cuadrada con la misma densidad que la simulación de main.cpp
+// (20 partículas en 800 x 600)
+double ladoCajaPara(int n) {
+    return sqrt(n * (800.0 * 600.0 / 20.0));
+}
+
+vector<Particula*> crearParticulasAleatorias(int n, double lado, unsigned semilla) {
+    mt19937 gen(semilla);
+    uniform_real_distribution<double> pos(0.0, lado);
+    uniform_real_distribution<double> vel(-100.0, 100.0);
+    uniform_real_distribution<double> radio(10.0, 25.0);
+
+    vector<Particula*> particulas;
+    particulas.reserve(n);
+    for (int i = 0; i < n; i++) {
+        particulas.push_back(new Particula(i, pos(gen), pos(gen), vel(gen), vel(gen),
+                                           1.0, radio(gen)));
+    }
+    return particulas;
+}
+
+void liberar(vector<Particula*>& particulas) {
+    for (Particula* p : particulas) delete p;
+    particulas.clear();
+}
+
+// Paso con la disposición anterior: un objeto Particula por partícula en el heap
+void pasoConPunteros(vector<Particula*>& particulas, GrillaEspacial& grilla,
+                     vector<pair<int, int>>& pares, double dt, double lado) {
+    for (Particula* p : particulas) {
+        if (p->estaActiva()) p->mover(dt);
+    }
+    for (Particula* p : particulas) {
+        if (!p->estaActiva()) continue;
+        Vector pos = p->getPosicion();
+        double r = p->getRadio();
+        if (pos.getX() - r <= 0 || pos.getX() + r >= lado ||
+            pos.getY() - r <= 0 || pos.getY() + r >= lado) {
+            p->colisionarPared(lado, lado);
+        }
+    }
+    grilla.construir(particulas);
+    grilla.obtenerParesCandidatos(pares);
+    for (const auto& par : pares) {
+        particulas[par.first]->colisionaCon(*particulas[par.second]);
+    }
+}
+
+// Simulador sin mensajes por evento, poblado con partículas aleatorias
+template <typename T>
+void poblar(Simulador<T>& sim, int n, double lado, unsigned semilla) {
+    vector<Particula*> particulas = crearParticulasAleatorias(n, lado, semilla);
+    for (const Particula* p : particulas) {
+        Vector pos = p->getPosicion();
+        Vector vel = p->getVelocidad();
+        sim.agregarParticula(pos.getX(), pos.getY(), vel.getX(), vel.getY(),
+                             p->getMasa(), p->getRadio());
+    }
+    liberar(particulas);
+}
+
+// Deriva numérica de energía y momento con choques elásticos entre
+// partículas y sin paredes (ambos se conservan en aritmética exacta)
+struct Deriva {
+    double energia;      // |E - E0| / E0
+    double momento;      // |P - P0| / Σ m|v| inicial
+    long long colisiones;
+};
+
+template <typename T>
+Deriva derivaElastica(int n, int pasos, double dt, unsigned semilla) {
+    // Nube densa en el centro de una caja que nadie alcanza
+    double lado = ladoCajaPara(n) / sqrt(8.0);
+    vector<Particula*> origen = crearParticulasAleatorias(n, lado, semilla);
+    vector<ParticulaT<T>*> particulas;
+    for (const Particula* p : origen) {
+        particulas.push_back(new ParticulaT<T>(p->getId(), p->getPosicion().getX(),
+                                               p->getPosicion().getY(),
+                                               p->getVelocidad().getX(),
+                                               p->getVelocidad().getY(),
+                                               p->getMasa(), p->getRadio()));
+    }
+    liberar(origen);
+
+    // Energía y momento siempre acumulados en double
+    auto medir = [&](double& e, double& px, double& py, double& escala) {
+        e = px = py = escala = 0.0;
+        for (const ParticulaT<T>* p : particulas) {
+            double m = p->getMasa();
+            double vx = p->getVelocidad().getX();
+            double vy = p->getVelocidad().getY();
+            e += 0.5 * m * (vx * vx + vy * vy);
+            px += m * vx;
+            py += m * vy;
+            escala += m * sqrt(vx * vx + vy * vy);
+        }
+    };
+
+    double e0, px0, py0, escala;
+    medir(e0, px0, py0, escala);
+
+    ColisionElasticaT<T> motor;
+    for (int k = 0; k < pasos; k++) {
+        for (ParticulaT<T>* p : particulas) p->mover(static_cast<T>(dt));
+        motor.detectarYResolverColisiones(particulas);
+    }
+
+    double e, px, py, ignorada;
+    medir(e, px, py, ignorada);
+    for (ParticulaT<T>* p : particulas) delete p;
+
+    return Deriva{abs(e - e0) / e0, hypot(px - px0, py - py0) / escala,
+                  motor.getColisionesTotales()};
+}
+
+// Vector 2D con cada operación fuera de línea, como lo compilaba
+// vector.cpp: referencia para medir el costo de las llamadas
+struct VectorFueraDeLinea {
+    double x, y;
+
+    [[gnu::noinline]] VectorFueraDeLinea operator-(const VectorFueraDeLinea& v) const {
+        return {x - v.x, y - v.y};
+    }
+    [[gnu::noinline]] VectorFueraDeLinea operator*(double s) const { return {x * s, y * s}; }
+    [[gnu::noinline]] VectorFueraDeLinea& operator+=(const VectorFueraDeLinea& v) {
+        x += v.x;
+        y += v.y;
+        return *this;
+    }
+    [[gnu::noinline]] VectorFueraDeLinea& operator-=(const VectorFueraDeLinea& v) {
+        x -= v.x;
+        y -= v.y;
+        return *this;
+    }
+    [[gnu::noinline]] double dot(const VectorFueraDeLinea& v) const { return x * v.x + y * v.y; }
+    [[gnu::noinline]] double magnitud() const { return sqrt(x * x + y * y); }
+    [[gnu::noinline]] void normalizar() {
+        double m = magnitud();
+        if (m != 0) {
+            x /= m;
+            y /= m;
+        }
+    }
+};
+
+// El vector en línea también se evalúa en tiempo de compilación
+static_assert(Vector(3, 4).magnitudCuadrada() == 25);
+static_assert(Vector(1, 2).sumarEscalado(Vector(2, -1), 0.5) == Vector(2, 1.5));
+
+// Choque elástico de un par con la misma secuencia que ColisionElastica:
+// normal, velocidad relativa, impulso y energía cinética antes y después
+template <typename V>
+double resolverParElastico(const V& r1, const V& r2, V& v1, V& v2, double m1, double m2) {
+    V n = r2 - r1;
+    n.normalizar();
+    double vRelNormal = (v1 - v2).dot(n);
+    if (vRelNormal <= 0) return 0;
+
+    double energiaAntes = 0.5 * m1 * v1.magnitud() * v1.magnitud() +
+                          0.5 * m2 * v2.magnitud() * v2.magnitud();
+    V impulso = n * (-2 * vRelNormal / (1 / m1 + 1 / m2));
+    v1 += impulso * (1 / m1);
+    v2 -= impulso * (1 / m2);
+    return 0.5 * m1 * v1.magnitud() * v1.magnitud() +
+           0.5 * m2 * v2.magnitud() * v2.magnitud() - energiaAntes;
+}
+
+// La misma secuencia con las operaciones fusionadas del vector en línea
+double resolverParFusionado(const Vector& r1, const Vector& r2, Vector& v1, Vector& v2,
+                            double m1, double m2) {
+    Vector n = (r2 - r1).normalizadoOCero();
+    double vRelNormal = (v1 - v2).dot(n);
+    if (vRelNormal <= 0) return 0;
+
+    double energiaAntes = 0.5 * m1 * v1.magnitudCuadrada() + 0.5 * m2 * v2.magnitudCuadrada();
+    Vector impulso = n * (-2 * vRelNormal / (1 / m1 + 1 / m2));
+    v1.sumarEscalado(impulso, 1 / m1);
+    v2.sumarEscalado(impulso, -(1 / m2));
+    return 0.5 * m1 * v1.magnitudCuadrada() + 0.5 * m2 * v2.magnitudCuadrada() - energiaAntes;
+}
+
+// Energía cinética total de las partículas activas (en double)
+template <typename T>
+double energiaCinetica(const AlmacenParticulasT<T>& particulas) {
+    double e = 0.0;
+    for (int i = 0; i < particulas.tamano(); i++) {
+        if (!particulas.activa[i]) continue;
+        double vx = particulas.vx[i];
+        double vy = particulas.vy[i];
+        e += 0.5 * particulas.masa[i] * (vx * vx + vy * vy);
+    }
+    return e;
+}
+
+// Nube densa que converge al centro de la caja: montones de contactos
+// simultáneos y persistentes para el modo gas inelástico
+template <typename T>
+void poblarColapso(Simulador<T>& sim, int n, double lado, unsigned semilla) {
+    mt19937 rng(semilla);
+    uniform_real_distribution<double> posicion(0.2 * lado, 0.8 * lado);
+    uniform_real_distribution<double> rapidez(20.0, 60.0);
+    for (int i = 0; i < n; i++) {
+        double x = posicion(rng);
+        double y = posicion(rng);
+        double dx = lado / 2 - x;
+        double dy = lado / 2 - y;
+        double d = max(1.0, sqrt(dx * dx + dy * dy));
+        double v = rapidez(rng);
+        sim.agregarParticula(x, y, v * dx / d, v * dy / d, 1.0, 3.0);
+    }
+}
+
+// Los archivos de salida se escriben en un directorio temporal
+class DirectorioTemporal {
+private:
+    filesystem::path anterior;
+    filesystem::path ruta;
+
+public:
+    explicit DirectorioTemporal(const string& nombre)
+        : anterior(filesystem::current_path()),
+        ruta(filesystem::temp_directory_path() / nombre) {
+        filesystem::remove_all(ruta);
+        filesystem::create_directories(ruta);
+        filesystem::current_path(ruta);
+    }
+    ~DirectorioTemporal() {
+        filesystem::current_path(anterior);
+        filesystem::remove_all(ruta);
+    }
+};
+
+// Recorre trayectorias.bin desde el principio hasta el frame del paso pedido
+bool buscarLinealEnBinario(const string& ruta, int pasoBuscado, FrameTrayectoria& frame) {
+    ifstream archivo(ruta, ios::binary);
+    archivo.seekg(EscritorBinario::BYTES_CABECERA);
+
+    int32_t paso;
+    double tiempo;
+    uint32_t cantidad;
+    while (archivo.read(reinterpret_cast<char*>(&paso), sizeof(paso)) &&
+           archivo.read(reinterpret_cast<char*>(&tiempo), sizeof(tiempo)) &&
+           archivo.read(reinterpret_cast<char*>(&cantidad), sizeof(cantidad))) {
+        if (paso != pasoBuscado) {
+            archivo.seekg(static_cast<streamoff>(cantidad) * EscritorBinario::BYTES_POR_PARTICULA,
+                          ios::cur);
+            continue;
+        }
+        frame.limpiar();
+        frame.paso = paso;
+        frame.tiempo = tiempo;
+        for (uint32_t k = 0; k < cantidad; k++) {
+            int32_t id;
+            double valores[4];
+            archivo.read(reinterpret_cast<char*>(&id), sizeof(id));
+            archivo.read(reinterpret_cast<char*>(valores), sizeof(valores));
+            frame.id.push_back(id);
+            frame.x.push_back(valores[0]);
+            frame.y.push_back(valores[1]);
+            frame.vx.push_back(valores[2]);
+            frame.vy.push_back(valores[3]);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Partículas del frame ordenadas por id (como las reconstruye LectorEventos)
+void ordenarPorId(FrameTrayectoria& frame) {
+    vector<int> orden(frame.cantidad());
+    for (int k = 0; k < frame.cantidad(); k++) orden[k] = k;
+    sort(orden.begin(), orden.end(), [&](int a, int b) { return frame.id[a] < frame.id[b]; });
+
+    FrameTrayectoria ordenado;
+    ordenado.paso = frame.paso;
+    ordenado.tiempo = frame.tiempo;
+    for (int k : orden) {
+        ordenado.id.push_back(frame.id[k]);
+        ordenado.x.push_back(frame.x[k]);
+        ordenado.y.push_back(frame.y[k]);
+        ordenado.vx.push_back(frame.vx[k]);
+        ordenado.vy.push_back(frame.vy[k]);
+    }
+    swap(frame, ordenado);
+}
+
+bool framesIguales(const FrameTrayectoria& a, const FrameTrayectoria& b) {
+    return a.paso == b.paso && a.tiempo == b.tiempo && a.id == b.id &&
+           a.x == b.x && a.y == b.y && a.vx == b.vx && a.vy == b.vy;
+}
+
+bool estadosIguales(const AlmacenParticulas& a, const AlmacenParticulas& b) {
+    return a.id == b.id && a.x == b.x && a.y == b.y && a.vx == b.vx && a.vy == b.vy &&
+           a.masa == b.masa && a.radio == b.radio;
+}
+
+// Una fila de keyframesEventos con el núcleo en T: la predicción del
+// escritor usa la misma precisión, así que float también comprime
+template <typename T>
+bool keyframesEventosCon(int n, const char* nombre, int& comparados) {
+    const double dt = 0.016;
+    const int pasos = 2000;
+    double lado = ladoCajaPara(n);
+    DirectorioTemporal directorio("p5_benchmark_eventos");
+
+    long long bytes[2] = {0, 0};
+    long long eventos = 0;
+    const FormatoSalida formatos[] = {FormatoSalida::BINARIO, FormatoSalida::EVENTOS};
+    for (int f = 0; f < 2; f++) {
+        Simulador<T> sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        sim.setDetallesConsola(false);
+        sim.setFormatoSalida(formatos[f]);
+        poblar(sim, n, lado, 42);
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+        }
+        sim.cerrarArchivos();
+        bytes[f] = sim.getBytesTrayectorias();
+        eventos = sim.getTotalColisiones();
+    }
+
+    // La reconstrucción debe coincidir bit a bit con el binario
+    bool exacto = true;
+    LectorEventos lector;
+    lector.abrir("trayectorias.p5e");
+    FrameTrayectoria reconstruido;
+    FrameTrayectoria original;
+    for (int paso : {0, 1, 17, 250, 999, 1500, 1999, 3}) {
+        if (!lector.estadoEnPaso(paso, reconstruido)) continue;
+        if (!buscarLinealEnBinario("trayectorias.bin", paso, original)) continue;
+        ordenarPorId(original);
+        exacto = exacto && framesIguales(reconstruido, original);
+        comparados++;
+    }
+
+    cout << setw(10) << n << setw(10) << nombre << setw(10) << pasos << setw(12) << eventos
+         << setw(16) << bytes[0] << setw(16) << bytes[1]
+         << setw(12) << fixed << setprecision(1)
+         << static_cast<double>(bytes[0]) / max(bytes[1], 1LL)
+         << setw(14) << static_cast<double>(bytes[1]) / max(eventos, 1LL) << endl;
+    return exacto;
+}
+
+// Contador de hardware del hilo actual (perf_event_open, solo Linux). Sin
+// soporte o sin permiso (perf_event_paranoid) queda no disponible y el
+// benchmark sigue midiendo tiempos
+enum class EventoHardware { FALLOS_CACHE, REFERENCIAS_CACHE };
+
+class ContadorHardware {
+private:
+    int descriptor = -1;
+
+public:
+    explicit ContadorHardware(EventoHardware evento) {
+#ifdef __linux__
+        perf_event_attr atributos{};
+        atributos.type = PERF_TYPE_HARDWARE;
+        atributos.size = sizeof(atributos);
+        atributos.config = (evento == EventoHardware::FALLOS_CACHE)
+                               ? PERF_COUNT_HW_CACHE_MISSES : PERF_COUNT_HW_CACHE_REFERENCES;
+        atributos.disabled = 1;
+        atributos.exclude_kernel = 1;
+        atributos.exclude_hv = 1;
+        descriptor = static_cast<int>(syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0));
+#else
+        (void)evento;
+#endif
+    }
+    ~ContadorHardware() {
+#ifdef __linux__
+        if (descriptor >= 0) close(descriptor);
+#endif
+    }
+    ContadorHardware(const ContadorHardware&) = delete;
+    ContadorHardware& operator=(const ContadorHardware&) = delete;
+
+    bool disponible() const { return descriptor >= 0; }
+
+    void iniciar() {
+#ifdef __linux__
+        if (descriptor < 0) return;
+        ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long detener() {
+        long long valor = 0;
+#ifdef __linux__
+        if (descriptor < 0) return 0;
+        ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(descriptor, &valor, sizeof(valor)) != sizeof(valor)) valor = 0;
+#endif
+        return valor;
+    }
+};
+
+} // namespace
+
+void Benchmark::ejecutar(const string& nombre) {
+    bool todos = nombre.empty() || nombre == "todos";
+
+    if (todos || nombre == "broadphase") escalamientoBroadphase();
+    if (todos || nombre == "almacen") almacenSoAvsPunteros();
+    if (todos || nombre == "salida") formatosSalida();
+    if (todos || nombre == "asincrona") salidaAsincrona();
+    if (todos || nombre == "archivo") accesoAleatorioArchivo();
+    if (todos || nombre == "compresion") compresionTrayectorias();
+    if (todos || nombre == "eventos") keyframesEventos();
+    if (todos || nombre == "texto") formateoTexto();
+    if (todos || nombre == "hilos") escalamientoHilos();
+    if (todos || nombre == "dominios") dominiosRebalanceo();
+    if (todos || nombre == "simd") kernelsSimd();
+    if (todos || nombre == "fasefina") faseFinaPorLotes();
+    if (todos || nombre == "precision") precisionNucleo();
+    if (todos || nombre == "vector") vectorEnLinea();
+    if (todos || nombre == "gas") modoGas();
+    if (todos || nombre == "contactos") solverContactos();
+    if (todos || nombre == "obstaculos") consultaObstaculos();
+    if (todos || nombre == "campo") campoDistancia();
+    if (todos || nombre == "verlet") listasVecinos();
+    if (todos || nombre == "morton") ordenMorton();
+    if (todos || nombre == "jerarquica") grillaJerarquica();
+}
+
+// --- Broadphase: pares evaluados vs N ---
+void Benchmark::escalamientoBroadphase() {
+    cout << "=== Broadphase de grilla uniforme ===" << endl;
+    cout << setw(10) << "N" << setw(16) << "pares grilla" << setw(12) << "pares/N"
+         << setw(18) << "pares O(N^2)" << setw(12) << "contactos"
+         << setw(14) << "tiempo (ms)" << endl;
+
+    for (int n : {1000, 10000, 100000, 1000000}) {
+        vector<Particula*> particulas = crearParticulasAleatorias(n, ladoCajaPara(n), 42);
+        GrillaEspacial grilla;
+        vector<pair<int, int>> pares;
+
+        auto inicio = Reloj::now();
+        grilla.construir(particulas);
+        grilla.obtenerParesCandidatos(pares);
+        int colisiones = 0;
+        for (const auto& par : pares) {
+            if (particulas[par.first]->colisionaCon(*particulas[par.second])) colisiones++;
+        }
+        double ms = milisegundosDesde(inicio);
+
+        long long evaluados = grilla.getParesEvaluados();
+        cout << setw(10) << n << setw(16) << evaluados
+             << setw(12) << fixed << setprecision(2) << double(evaluados) / n
+             << setw(18) << (static_cast<long long>(n) * (n - 1) / 2)
+             << setw(12) << colisiones
+             << setw(14) << setprecision(2) << ms << endl;
+
+        liberar(particulas);
+    }
+    cout << endl;
+}
+
+// --- Almacenamiento: SoA del Simulador vs vector<Particula*> ---
+void Benchmark::almacenSoAvsPunteros() {
+    cout << "=== Tiempo de paso: SoA vs vector<Particula*> ===" << endl;
+    cout << setw(10) << "N" << setw(18) << "punteros (ms)" << setw(14) << "SoA (ms)"
+         << setw(12) << "mejora" << endl;
+
+    const double dt = 0.016;
+    const int pasos = 10;
+
+    for (int n : {10000, 100000, 1000000}) {
+        double lado = ladoCajaPara(n);
+
+        // Disposición anterior
+        vector<Particula*> punteros = crearParticulasAleatorias(n, lado, 42);
+        GrillaEspacial grilla;
+        vector<pair<int, int>> pares;
+        auto inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            pasoConPunteros(punteros, grilla, pares, dt, lado);
+        }
+        double msPunteros = milisegundosDesde(inicio) / pasos;
+
+        // Simulador sobre la estructura de arreglos
+        Simulador sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        sim.setSalidaArchivos(false);
+        sim.setDetallesConsola(false);
+        liberar(punteros);
+        poblar(sim, n, lado, 42);
+
+        inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+        }
+        double msSoA = milisegundosDesde(inicio) / pasos;
+
+        cout << setw(10) << n << setw(18) << fixed << setprecision(2) << msPunteros
+             << setw(14) << msSoA << setw(11) << msPunteros / msSoA << "x" << endl;
+    }
+    cout << endl;
+}
+
+// --- Salida: texto por partícula vs binario multiplexado ---
+void Benchmark::formatosSalida() {
+    cout << "=== Formatos de salida de trayectorias ===" << endl;
+    cout << setw(10) << "formato" << setw(10) << "N" << setw(16) << "bytes/paso"
+         << setw(16) << "paso (ms)" << endl;
+
+    const double dt = 0.016;
+    const int pasos = 200;
+    const int n = 1000;
+    double lado = ladoCajaPara(n);
+
+    for (FormatoSalida formato : {FormatoSalida::TEXTO, FormatoSalida::BINARIO}) {
+        DirectorioTemporal directorio("p5_benchmark_salida");
+        Simulador sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        sim.setDetallesConsola(false);
+        sim.setFormatoSalida(formato);
+        poblar(sim, n, lado, 42);
+
+        auto inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+        }
+        sim.cerrarArchivos();
+        double ms = milisegundosDesde(inicio) / pasos;
+
+        cout << setw(10) << (formato == FormatoSalida::TEXTO ? "texto" : "binario")
+             << setw(10) << n
+             << setw(16) << sim.getBytesTrayectorias() / pasos
+             << setw(16) << fixed << setprecision(3) << ms << endl;
+    }
+    cout << endl;
+}
+
+// --- Salida síncrona vs hilo de escritura ---
+void Benchmark::salidaAsincrona() {
+    cout << "=== Escritura en hilo aparte ===" << endl;
+    cout << setw(10) << "formato" << setw(14) << "modo" << setw(14) << "paso (ms)"
+         << setw(18) << "en salida (ms)" << setw(16) << "descartados" << endl;
+
+    struct Caso {
+        const char* nombre;
+        bool asincrona;
+        PoliticaCola politica;
+    };
+    const Caso casos[] = {
+        {"sincrono", false, PoliticaCola::BLOQUEAR},
+        {"bloquear", true, PoliticaCola::BLOQUEAR},
+        {"descartar", true, PoliticaCola::DESCARTAR},
+        {"crecer", true, PoliticaCola::CRECER},
+    };
+
+    const double dt = 0.016;
+    const int pasos = 200;
+
+    for (FormatoSalida formato : {FormatoSalida::TEXTO, FormatoSalida::BINARIO}) {
+        int n = (formato == FormatoSalida::TEXTO) ? 1000 : 20000;
+        double lado = ladoCajaPara(n);
+
+        for (const Caso& caso : casos) {
+            DirectorioTemporal directorio("p5_benchmark_asincrona");
+            Simulador sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+            sim.setDetallesConsola(false);
+            sim.setFormatoSalida(formato);
+            sim.setSalidaAsincrona(caso.asincrona, caso.politica, 2);
+            poblar(sim, n, lado, 42);
+
+            auto inicio = Reloj::now();
+            for (int k = 0; k < pasos; k++) {
+                sim.ejecutarPaso();
+            }
+            double ms = milisegundosDesde(inicio) / pasos;
+            long long descartados = sim.getFramesDescartados();
+            sim.cerrarArchivos();
+
+            cout << setw(10) << (formato == FormatoSalida::TEXTO ? "texto" : "binario")
+                 << setw(14) << caso.nombre
+                 << setw(14) << fixed << setprecision(3) << ms
+                 << setw(18) << sim.getSegundosEnSalida() * 1000.0 / pasos
+                 << setw(16) << descartados << endl;
+        }
+    }
+    cout << endl;
+}
+
+// --- Archivo por bloques: acceso aleatorio vs recorrido lineal ---
+void Benchmark::accesoAleatorioArchivo() {
+    cout << "=== Acceso a un frame por tiempo ===" << endl;
+
+    const double dt = 0.016;
+    const int pasos = 3000;
+    const int n = 500;
+    const int consultas = 200;
+    double lado = ladoCajaPara(n);
+    DirectorioTemporal directorio("p5_benchmark_archivo");
+
+    // La misma simulación guardada en ambos formatos
+    for (FormatoSalida formato : {FormatoSalida::BINARIO, FormatoSalida::ARCHIVO}) {
+        Simulador sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        sim.setDetallesConsola(false);
+        sim.setFormatoSalida(formato);
+        poblar(sim, n, lado, 42);
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+        }
+        sim.cerrarArchivos();
+    }
+
+    LectorArchivo lector;
+    if (!lector.abrir("trayectorias.p5a")) {
+        cout << "No se pudo abrir trayectorias.p5a" << endl;
+        return;
+    }
+
+    mt19937 gen(7);
+    uniform_real_distribution<double> tiempoAleatorio(0.0, pasos * dt);
+    vector<double> tiempos(consultas);
+    for (double& t : tiempos) t = tiempoAleatorio(gen);
+
+    FrameTrayectoria frame;
+    auto inicio = Reloj::now();
+    for (double t : tiempos) {
+        lector.leerFrame(lector.buscarTiempo(t), frame);
+    }
+    double msIndice = milisegundosDesde(inicio) / consultas;
+
+    FrameTrayectoria lineal;
+    int coinciden = 0;
+    inicio = Reloj::now();
+    for (double t : tiempos) {
+        int paso = lector.getEntrada(lector.buscarTiempo(t)).paso;
+        buscarLinealEnBinario("trayectorias.bin", paso, lineal);
+    }
+    double msLineal = milisegundosDesde(inicio) / consultas;
+
+    for (int k = 0; k < 20; k++) {
+        int indiceFrame = lector.buscarTiempo(tiempos[k]);
+        lector.leerFrame(indiceFrame, frame);
+        buscarLinealEnBinario("trayectorias.bin", frame.paso, lineal);
+        if (framesIguales(frame, lineal)) coinciden++;
+    }
+
+    cout << "Frames: " << lector.numeroFrames() << ", partículas iniciales: " << n << endl;
+    cout << "Con índice (.p5a):      " << fixed << setprecision(3) << msIndice << " ms/consulta" << endl;
+    cout << "Recorrido lineal (.bin): " << msLineal << " ms/consulta" << endl;
+    cout << "Frames idénticos en ambos formatos: " << coinciden << " / 20" << endl;
+    cout << endl;
+}
+
+// --- Formato comprimido: tamaño, costo y error de reconstrucción ---
+void Benchmark::compresionTrayectorias() {
+    cout << "=== Trayectorias comprimidas (delta + varint) ===" << endl;
+    cout << setw(12) << "formato" << setw(16) << "bytes/paso" << setw(12) << "razón"
+         << setw(16) << "paso (ms)" << endl;
+
+    const double dt = 0.016;
+    const int pasos = 1000;
+    const int n = 1000;
+    const double precision = 1e-3;
+    double lado = ladoCajaPara(n);
+    DirectorioTemporal directorio("p5_benchmark_compresion");
+
+    // La misma simulación en cada formato (el binario sirve de referencia)
+    long long bytesBinario = 0;
+    const FormatoSalida formatos[] = {FormatoSalida::BINARIO, FormatoSalida::TEXTO,
+                                      FormatoSalida::COMPRIMIDO};
+    const char* nombres[] = {"binario", "texto", "comprimido"};
+    double msSinSalida = 0.0;
+
+    for (int f = -1; f < 3; f++) {
+        Simulador sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        sim.setDetallesConsola(false);
+        if (f < 0) {
+            sim.setSalidaArchivos(false);
+        } else {
+            sim.setFormatoSalida(formatos[f]);
+            sim.setPrecisionSalida(precision, precision);
+        }
+        poblar(sim, n, lado, 42);
+
+        auto inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+        }
+        sim.cerrarArchivos();
+        double ms = milisegundosDesde(inicio) / pasos;
+        if (f < 0) {
+            msSinSalida = ms;
+            continue;
+        }
+
+        long long bytes = sim.getBytesTrayectorias();
+        if (formatos[f] == FormatoSalida::BINARIO) bytesBinario = bytes;
+        cout << setw(12) << nombres[f] << setw(16) << bytes / pasos
+             << setw(12) << fixed << setprecision(1)
+             << (bytesBinario > 0 ? static_cast<double>(bytesBinario) / bytes : 0.0)
+             << setw(16) << setprecision(3) << ms << endl;
+    }
+    cout << "Paso sin salida: " << fixed << setprecision(3) << msSinSalida << " ms" << endl;
+
+    // Reconstrucción: el error debe quedar dentro de media precisión
+    LectorComprimido lector;
+    if (!lector.abrir("trayectorias.p5z")) {
+        cout << "No se pudo abrir trayectorias.p5z" << endl;
+        return;
+    }
+    FrameTrayectoria comprimido;
+    FrameTrayectoria original;
+    double errorMaximo = 0.0;
+    int frames = 0;
+    bool idsIguales = true;
+    auto inicio = Reloj::now();
+    while (lector.leerFrame(comprimido)) {
+        frames++;
+    }
+    double msDecodificar = milisegundosDesde(inicio) / max(frames, 1);
+
+    lector.abrir("trayectorias.p5z");
+    for (int paso = 0; paso < pasos; paso += 97) {
+        lector.saltarHastaPaso(paso);
+        do {
+            if (!lector.leerFrame(comprimido)) break;
+        } while (comprimido.paso < paso);
+        if (!buscarLinealEnBinario("trayectorias.bin", comprimido.paso, original)) continue;
+
+        idsIguales = idsIguales && comprimido.id == original.id;
+        for (int k = 0; k < original.cantidad() && k < comprimido.cantidad(); k++) {
+            errorMaximo = max({errorMaximo, fabs(comprimido.x[k] - original.x[k]),
+                               fabs(comprimido.y[k] - original.y[k]),
+                               fabs(comprimido.vx[k] - original.vx[k]),
+                               fabs(comprimido.vy[k] - original.vy[k])});
+        }
+    }
+
+    cout << "Frames decodificados: " << frames << " (" << setprecision(3) << msDecodificar
+         << " ms/frame)" << endl;
+    cout << "Error máximo: " << scientific << setprecision(2) << errorMaximo
+         << " (límite " << precision / 2 << "), ids "
+         << (idsIguales ? "iguales" : "distintos") << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Keyframes por evento: tamaño O(eventos) y reconstrucción exacta ---
+void Benchmark::keyframesEventos() {
+    cout << "=== Trayectorias por eventos (keyframes) ===" << endl;
+    cout << setw(10) << "N" << setw(10) << "escalar" << setw(10) << "pasos" << setw(12) << "eventos"
+         << setw(16) << "binario (B)" << setw(16) << "eventos (B)" << setw(12) << "razón"
+         << setw(14) << "B/evento" << endl;
+
+    bool exacto = true;
+    int comparados = 0;
+    for (int n : {100, 1000}) {
+        exacto = keyframesEventosCon<double>(n, "double", comparados) && exacto;
+        exacto = keyframesEventosCon<float>(n, "float", comparados) && exacto;
+    }
+    cout << "Frames reconstruidos idénticos al binario: " << (exacto ? "sí" : "no")
+         << " (" << comparados << " comparados)" << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Texto: ostream con setprecision y endl vs to_chars en un buffer ---
+void Benchmark::formateoTexto() {
+    cout << "=== Formateo de líneas de texto ===" << endl;
+
+    const int lineas = 500000;
+    DirectorioTemporal directorio("p5_benchmark_texto");
+
+    mt19937 gen(3);
+    uniform_real_distribution<double> valor(-50.0, 1500.0);
+    vector<double> xs(lineas);
+    vector<double> ys(lineas);
+    for (int k = 0; k < lineas; k++) {
+        xs[k] = valor(gen);
+        ys[k] = valor(gen);
+    }
+    xs[0] = -0.0004;   // Casos de redondeo y signo
+    ys[0] = 0.0005;
+    xs[1] = 2.0005;
+    ys[1] = -1e-9;
+
+    // Antes: como escribía EscritorTexto hasta ahora
+    auto inicio = Reloj::now();
+    {
+        ofstream archivo("ostream.txt");
+        for (int k = 0; k < lineas; k++) {
+            archivo << fixed << setprecision(3) << xs[k] << " " << ys[k] << endl;
+        }
+    }
+    double sOstream = milisegundosDesde(inicio) / 1000.0;
+
+    // Ahora: BufferTexto, vaciado en bloques
+    inicio = Reloj::now();
+    {
+        ofstream archivo("to_chars.txt");
+        BufferTexto buffer;
+        for (int k = 0; k < lineas; k++) {
+            buffer.agregar(xs[k], 3);
+            buffer.agregar(' ');
+            buffer.agregar(ys[k], 3);
+            buffer.agregar('\n');
+            if (buffer.tamano() >= EscritorTexto::TAMANO_BUFFER) buffer.vaciarEn(archivo);
+        }
+        buffer.vaciarEn(archivo);
+    }
+    double sBuffer = milisegundosDesde(inicio) / 1000.0;
+
+    ifstream a("ostream.txt", ios::binary);
+    ifstream b("to_chars.txt", ios::binary);
+    string contenidoA((istreambuf_iterator<char>(a)), istreambuf_iterator<char>());
+    string contenidoB((istreambuf_iterator<char>(b)), istreambuf_iterator<char>());
+
+    cout << "ostream + endl:       " << fixed << setprecision(0) << lineas / sOstream
+         << " líneas/s" << endl;
+    cout << "to_chars + buffer:    " << lineas / sBuffer << " líneas/s ("
+         << setprecision(1) << sOstream / sBuffer << "x)" << endl;
+    cout << "Archivos idénticos: " << (contenidoA == contenidoB ? "sí" : "no") << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Paso en paralelo: escalamiento fuerte ---
+void Benchmark::escalamientoHilos() {
+    cout << "=== Paso en paralelo (pool con robo de trabajo) ===" << endl;
+    cout << setw(10) << "N" << setw(8) << "hilos" << setw(14) << "paso (ms)"
+         << setw(15) << "aceleración" << setw(12) << "eficiencia" << setw(13) << "idéntico"
+         << endl;
+
+    const double dt = 0.016;
+    int nucleos = max(1u, thread::hardware_concurrency());
+    vector<int> hilos;
+    for (int h = 1; h < nucleos; h *= 2) hilos.push_back(h);
+    hilos.push_back(nucleos);
+
+    for (int n : {100000, 1000000}) {
+        int pasos = (n >= 1000000) ? 5 : 20;
+        double lado = ladoCajaPara(n);
+        double msSerial = 0.0;
+        AlmacenParticulas referencia;
+
+        for (int h : hilos) {
+            Simulador sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+            sim.setDetallesConsola(false);
+            sim.setSalidaArchivos(false);
+            sim.setHilos(h);
+            poblar(sim, n, lado, 42);
+            sim.ejecutarPaso();   // Las fusiones iniciales no entran en la medición
+
+            auto inicio = Reloj::now();
+            for (int k = 0; k < pasos; k++) {
+                sim.ejecutarPaso();
+            }
+            double ms = milisegundosDesde(inicio) / pasos;
+
+            bool identico = true;
+            if (h == 1) {
+                msSerial = ms;
+                referencia = sim.getParticulas();
+            } else {
+                identico = estadosIguales(referencia, sim.getParticulas());
+            }
+
+            cout << setw(10) << n << setw(8) << h
+                 << setw(14) << fixed << setprecision(2) << ms
+                 << setw(14) << msSerial / ms
+                 << setw(12) << msSerial / ms / h
+                 << setw(12) << (identico ? "sí" : "no") << endl;
+        }
+    }
+    cout << defaultfloat << endl;
+}
+
+// --- Descomposición en franjas: fijas vs rebalanceadas ---
+void Benchmark::dominiosRebalanceo() {
+    cout << "=== Descomposición en dominios con rebalanceo ===" << endl;
+
+    const double dt = 0.016;
+    const int n = 100000;
+    const int pasos = 30;
+    int numDominios = max(4u, thread::hardware_concurrency());
+    double lado = ladoCajaPara(n);
+
+    // 80% de las partículas en la quinta parte izquierda de la caja
+    auto poblarAgrupado = [&](Simulador<>& sim) {
+        mt19937 gen(11);
+        uniform_real_distribution<double> pos(0.0, lado);
+        uniform_real_distribution<double> izquierda(0.0, lado * 0.2);
+        uniform_real_distribution<double> vel(-100.0, 100.0);
+        uniform_real_distribution<double> radio(10.0, 25.0);
+        for (int i = 0; i < n; i++) {
+            double x = (i % 5 == 0) ? pos(gen) : izquierda(gen);
+            sim.agregarParticula(x, pos(gen), vel(gen), vel(gen), 1.0, radio(gen));
+        }
+    };
+
+    cout << setw(16) << "modo" << setw(14) << "paso (ms)" << setw(14) << "desbalance"
+         << setw(14) << "rebalanceos" << setw(13) << "idéntico" << endl;
+
+    AlmacenParticulas referencia;
+    const char* modos[] = {"una grilla", "franjas fijas", "rebalanceadas"};
+    for (int modo = 0; modo < 3; modo++) {
+        Simulador sim(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        sim.setDetallesConsola(false);
+        sim.setSalidaArchivos(false);
+        sim.setHilos(numDominios);
+        if (modo > 0) sim.setDominios(numDominios, modo == 2);
+        poblarAgrupado(sim);
+
+        double desbalance = 0.0;
+        auto inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+            if (sim.getDominios()) desbalance += sim.getDominios()->getDesbalance();
+        }
+        double ms = milisegundosDesde(inicio) / pasos;
+
+        if (modo == 0) referencia = sim.getParticulas();
+        bool identico = estadosIguales(referencia, sim.getParticulas());
+        const DescomposicionDominios* dominios = sim.getDominios();
+
+        cout << setw(16) << modos[modo] << setw(14) << fixed << setprecision(2) << ms
+             << setw(14) << (dominios ? desbalance / pasos : 1.0)
+             << setw(14) << (dominios ? dominios->getRebalanceos() : 0)
+             << setw(13) << (identico ? "sí" : "no") << endl;
+        if (dominios) dominios->mostrarEstadisticas();
+    }
+    cout << "Desbalance: tiempo del dominio más lento / promedio (1.00 = parejo)" << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Kernels SIMD: integración y rebote en paredes por ISA ---
+void Benchmark::kernelsSimd() {
+    cout << "=== Kernels de integración y paredes ===" << endl;
+    cout << setw(10) << "N" << setw(10) << "ISA" << setw(20) << "integrar (M/s)"
+         << setw(20) << "paredes (M/s)" << setw(13) << "idéntico" << endl;
+
+    const double dt = 0.016;
+    for (int n : {10000, 1000000}) {
+        // Caja chica para que muchas partículas toquen las paredes
+        double lado = ladoCajaPara(n) * 0.5;
+        mt19937 gen(21);
+        uniform_real_distribution<double> pos(-20.0, lado + 20.0);
+        uniform_real_distribution<double> vel(-100.0, 100.0);
+        uniform_real_distribution<double> radio(10.0, 25.0);
+        vector<double> x0(n), y0(n), vx0(n), vy0(n), r(n);
+        vector<unsigned char> activa(n);
+        for (int i = 0; i < n; i++) {
+            x0[i] = pos(gen);
+            y0[i] = pos(gen);
+            vx0[i] = vel(gen);
+            vy0[i] = vel(gen);
+            r[i] = radio(gen);
+            activa[i] = (i % 17 != 0);
+        }
+
+        int repeticiones = max(10, 20000000 / n);
+        vector<double> referencia;
+        for (IsaSimd isa : {IsaSimd::ESCALAR, IsaSimd::SSE2, IsaSimd::AVX2}) {
+            if (!isaDisponible(isa)) {
+                cout << setw(10) << n << setw(10) << nombreIsa(isa) << "  (no disponible)" << endl;
+                continue;
+            }
+            const KernelsParticulas& kernels = kernelsPara<double>(isa);
+            vector<double> x = x0, y = y0, vx = vx0, vy = vy0;
+            vector<unsigned char> paredes(n);
+
+            auto inicio = Reloj::now();
+            for (int k = 0; k < repeticiones; k++) {
+                kernels.integrar(x.data(), y.data(), vx.data(), vy.data(), activa.data(), n, dt);
+            }
+            double sIntegrar = milisegundosDesde(inicio) / 1000.0;
+
+            inicio = Reloj::now();
+            for (int k = 0; k < repeticiones; k++) {
+                kernels.reflejarParedes(x.data(), y.data(), vx.data(), vy.data(), r.data(),
+                                        activa.data(), paredes.data(), n, lado, lado);
+            }
+            double sParedes = milisegundosDesde(inicio) / 1000.0;
+
+            // Resultado de una pasada completa desde el mismo estado inicial
+            x = x0; y = y0; vx = vx0; vy = vy0;
+            kernels.integrar(x.data(), y.data(), vx.data(), vy.data(), activa.data(), n, dt);
+            kernels.reflejarParedes(x.data(), y.data(), vx.data(), vy.data(), r.data(),
+                                    activa.data(), paredes.data(), n, lado, lado);
+            vector<double> resultado = x;
+            resultado.insert(resultado.end(), y.begin(), y.end());
+            resultado.insert(resultado.end(), vx.begin(), vx.end());
+            resultado.insert(resultado.end(), vy.begin(), vy.end());
+            for (unsigned char p : paredes) resultado.push_back(p);
+            if (referencia.empty()) referencia = resultado;
+
+            double millones = static_cast<double>(n) * repeticiones / 1e6;
+            cout << setw(10) << n << setw(10) << nombreIsa(isa)
+                 << setw(20) << fixed << setprecision(1) << millones / sIntegrar
+                 << setw(20) << millones / sParedes
+                 << setw(13) << (resultado == referencia ? "sí" : "no") << endl;
+        }
+    }
+    cout << "ISA elegida en este procesador: " << nombreIsa(mejorIsaDisponible()) << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Fase fina: candidatos + sqrt por par vs kernel por lotes ---
+void Benchmark::faseFinaPorLotes() {
+    cout << "=== Fase fina por lotes (SIMD) ===" << endl;
+    cout << setw(10) << "N" << setw(10) << "densidad" << setw(12) << "contactos"
+         << setw(18) << "pares+sqrt (ms)";
+    for (IsaSimd isa : {IsaSimd::ESCALAR, IsaSimd::SSE2, IsaSimd::AVX2}) {
+        cout << setw(14) << (string(nombreIsa(isa)) + " (ms)");
+    }
+    cout << setw(13) << "idéntico" << endl;
+
+    const int repeticiones = 5;
+    for (int n : {10000, 100000, 1000000}) {
+        // Densidad de main.cpp y una caja 8 veces más poblada
+        for (double factor : {1.0, 8.0}) {
+            double lado = ladoCajaPara(n) / sqrt(factor);
+            vector<Particula*> punteros = crearParticulasAleatorias(n, lado, 42);
+            AlmacenParticulas almacen;
+            almacen.reservar(n);
+            for (const Particula* p : punteros) {
+                almacen.agregar(p->getId(), p->getPosicion().getX(), p->getPosicion().getY(),
+                                p->getVelocidad().getX(), p->getVelocidad().getY(),
+                                p->getMasa(), p->getRadio());
+            }
+            liberar(punteros);
+
+            GrillaEspacial grilla;
+            grilla.construir(almacen);
+
+            // Referencia: candidatos de la grilla y una raíz cuadrada por par
+            vector<pair<int, int>> candidatos, referencia;
+            auto inicio = Reloj::now();
+            for (int k = 0; k < repeticiones; k++) {
+                grilla.obtenerParesCandidatos(candidatos);
+                referencia.clear();
+                for (const auto& par : candidatos) {
+                    double dx = almacen.x[par.first] - almacen.x[par.second];
+                    double dy = almacen.y[par.first] - almacen.y[par.second];
+                    if (sqrt(dx * dx + dy * dy) <= almacen.radio[par.first] + almacen.radio[par.second]) {
+                        referencia.push_back(par);
+                    }
+                }
+            }
+            double msReferencia = milisegundosDesde(inicio) / repeticiones;
+
+            cout << setw(10) << n << setw(9) << fixed << setprecision(0) << factor << "x"
+                 << setw(12) << referencia.size()
+                 << setw(18) << setprecision(2) << msReferencia;
+
+            bool iguales = true;
+            vector<pair<int, int>> contactos;
+            for (IsaSimd isa : {IsaSimd::ESCALAR, IsaSimd::SSE2, IsaSimd::AVX2}) {
+                if (!isaDisponible(isa)) {
+                    cout << setw(14) << "-";
+                    continue;
+                }
+                grilla.setIsa(isa);
+                inicio = Reloj::now();
+                for (int k = 0; k < repeticiones; k++) {
+                    grilla.obtenerParesEnContacto(contactos);
+                }
+                cout << setw(14) << milisegundosDesde(inicio) / repeticiones;
+                iguales = iguales && contactos == referencia;
+            }
+            cout << setw(13) << (iguales ? "sí" : "no") << endl;
+        }
+    }
+    cout << defaultfloat << endl;
+}
+
+// --- Precisión del núcleo: Simulador<float> vs Simulador<double> ---
+void Benchmark::precisionNucleo() {
+    cout << "=== Precisión del núcleo físico (float vs double) ===" << endl;
+    cout << setw(10) << "N" << setw(18) << "double (ms/paso)" << setw(17) << "float (ms/paso)"
+         << setw(15) << "aceleración" << endl;
+
+    const double dt = 0.016;
+    for (int n : {100000, 1000000}) {
+        int pasos = (n >= 1000000) ? 5 : 20;
+        double lado = ladoCajaPara(n);
+
+        auto medir = [&](auto& sim) {
+            sim.setDetallesConsola(false);
+            sim.setSalidaArchivos(false);
+            poblar(sim, n, lado, 42);
+            sim.ejecutarPaso();   // Las fusiones iniciales no entran en la medición
+            auto inicio = Reloj::now();
+            for (int k = 0; k < pasos; k++) {
+                sim.ejecutarPaso();
+            }
+            return milisegundosDesde(inicio) / pasos;
+        };
+
+        Simulador<double> simDouble(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        double msDouble = medir(simDouble);
+        Simulador<float> simFloat(lado, lado, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+        double msFloat = medir(simFloat);
+
+        cout << setw(10) << n << setw(18) << fixed << setprecision(2) << msDouble
+             << setw(17) << msFloat << setw(14) << msDouble / msFloat << "x" << endl;
+    }
+
+    // Choques elásticos sin paredes: lo que cambie E o P es error de redondeo
+    const int n = 20000;
+    const int pasos = 500;
+    cout << endl << "Deriva con choques elásticos (" << n << " partículas, "
+         << pasos << " pasos, sin paredes):" << endl;
+    cout << setw(10) << "escalar" << setw(13) << "choques" << setw(17) << "|ΔE| / E0"
+         << setw(18) << "|ΔP| / Σm|v|" << endl;
+    Deriva enDouble = derivaElastica<double>(n, pasos, dt, 7);
+    Deriva enFloat = derivaElastica<float>(n, pasos, dt, 7);
+    cout << scientific << setprecision(2);
+    cout << setw(10) << "double" << setw(13) << enDouble.colisiones
+         << setw(16) << enDouble.energia << setw(16) << enDouble.momento << endl;
+    cout << setw(10) << "float" << setw(13) << enFloat.colisiones
+         << setw(16) << enFloat.energia << setw(16) << enFloat.momento << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Vector 2D: llamadas fuera de línea vs cabecera constexpr ---
+void Benchmark::vectorEnLinea() {
+    cout << "=== Vector 2D en línea (resolución de pares elásticos) ===" << endl;
+    cout << setw(10) << "pares" << setw(23) << "fuera de línea (ns)" << setw(16) << "en línea (ns)"
+         << setw(15) << "fusionado (ns)" << setw(15) << "aceleración" << setw(13) << "idéntico"
+         << endl;
+
+    mt19937 rng(42);
+    uniform_real_distribution<double> posicion(0.0, 100.0);
+    uniform_real_distribution<double> velocidad(-100.0, 100.0);
+    uniform_real_distribution<double> masa(0.5, 2.0);
+
+    for (int n : {1000, 100000}) {
+        vector<double> datos(n * 10);
+        for (int i = 0; i < n; i++) {
+            double* d = &datos[i * 10];
+            d[0] = posicion(rng); d[1] = posicion(rng); d[2] = posicion(rng); d[3] = posicion(rng);
+            d[4] = velocidad(rng); d[5] = velocidad(rng); d[6] = velocidad(rng); d[7] = velocidad(rng);
+            d[8] = masa(rng); d[9] = masa(rng);
+        }
+        const int repeticiones = max(1, 20000000 / n);
+
+        // Cada versión resuelve los mismos pares y devuelve la suma de
+        // velocidades finales (para comparar) y el tiempo por par
+        auto medir = [&](auto resolver, double& suma, double& deltaEnergia) {
+            double ns = 0;
+            for (int k = 0; k < repeticiones; k++) {
+                suma = deltaEnergia = 0;
+                auto inicio = Reloj::now();
+                for (int i = 0; i < n; i++) {
+                    const double* d = &datos[i * 10];
+                    deltaEnergia += resolver(d, suma);
+                }
+                ns += milisegundosDesde(inicio) * 1e6 / n;
+            }
+            return ns / repeticiones;
+        };
+
+        double sumaFuera, sumaLinea, sumaFusion, eFuera, eLinea, eFusion;
+        double nsFuera = medir([](const double* d, double& suma) {
+            VectorFueraDeLinea r1{d[0], d[1]}, r2{d[2], d[3]}, v1{d[4], d[5]}, v2{d[6], d[7]};
+            double de = resolverParElastico(r1, r2, v1, v2, d[8], d[9]);
+            suma += v1.x + v1.y + v2.x + v2.y;
+            return de;
+        }, sumaFuera, eFuera);
+        double nsLinea = medir([](const double* d, double& suma) {
+            Vector r1(d[0], d[1]), r2(d[2], d[3]), v1(d[4], d[5]), v2(d[6], d[7]);
+            double de = resolverParElastico(r1, r2, v1, v2, d[8], d[9]);
+            suma += v1.getX() + v1.getY() + v2.getX() + v2.getY();
+            return de;
+        }, sumaLinea, eLinea);
+        double nsFusion = medir([](const double* d, double& suma) {
+            Vector r1(d[0], d[1]), r2(d[2], d[3]), v1(d[4], d[5]), v2(d[6], d[7]);
+            double de = resolverParFusionado(r1, r2, v1, v2, d[8], d[9]);
+            suma += v1.getX() + v1.getY() + v2.getX() + v2.getY();
+            return de;
+        }, sumaFusion, eFusion);
+
+        // Las velocidades deben coincidir bit a bit; la energía fusionada
+        // (|v|² sin raíz) solo difiere en el redondeo
+        bool iguales = sumaFuera == sumaLinea && sumaLinea == sumaFusion && eFuera == eLinea;
+        cout << setw(10) << n << setw(22) << fixed << setprecision(2) << nsFuera
+             << setw(15) << nsLinea << setw(15) << nsFusion
+             << setw(13) << nsFuera / nsFusion << "x" << setw(13) << (iguales ? "sí" : "no")
+             << endl;
+        cout << "  ΔE total: fuera de línea " << scientific << setprecision(6) << eFuera
+             << ", fusionado " << eFusion << fixed << endl;
+    }
+    cout << defaultfloat << endl;
+}
+
+// --- Modo gas: choques elásticos e inelásticos por impulso, sin fusión ---
+void Benchmark::modoGas() {
+    cout << "=== Modo gas (choques por impulso entre partículas) ===" << endl;
+    cout << "Mchoques/s sobre el paso completo (movimiento, paredes y broadphase incluidos)"
+         << endl;
+    cout << setw(10) << "N" << setw(12) << "modelo" << setw(10) << "barrido" << setw(7) << "hilos"
+         << setw(12) << "ms/paso" << setw(15) << "choques/paso" << setw(17) << "Mchoques/s"
+         << setw(17) << "balance E / E0" << endl;
+
+    // Lista en serie, y por colores con uno y con todos los hilos
+    struct Configuracion {
+        TipoColision tipo;
+        bool colores;
+        int hilos;
+    };
+    const int maxHilos = max(2u, thread::hardware_concurrency());
+    vector<Configuracion> configuraciones;
+    for (TipoColision tipo : {TipoColision::ELASTICA, TipoColision::INELASTICA}) {
+        configuraciones.push_back({tipo, false, 1});
+        configuraciones.push_back({tipo, true, 1});
+        configuraciones.push_back({tipo, true, maxHilos});
+    }
+
+    const double dt = 0.016;
+    for (int n : {100000, 1000000}) {
+        int pasos = (n >= 1000000) ? 5 : 20;
+        // Caja 8 veces más poblada que main.cpp: muchos contactos por paso
+        double lado = ladoCajaPara(n) / sqrt(8.0);
+
+        for (const Configuracion& config : configuraciones) {
+            Simulador<> sim(lado, lado, dt, config.tipo, 0.9);
+            sim.setDetallesConsola(false);
+            sim.setSalidaArchivos(false);
+            sim.setBarridoPorColores(config.colores);
+            sim.setHilos(config.hilos);
+            poblar(sim, n, lado, 42);
+
+            double energiaInicial = energiaCinetica(sim.getParticulas());
+            long long colisionesAntes = sim.getColisionesParticulas();
+            auto inicio = Reloj::now();
+            for (int k = 0; k < pasos; k++) {
+                sim.ejecutarPaso();
+            }
+            double ms = milisegundosDesde(inicio);
+            long long choques = sim.getColisionesParticulas() - colisionesAntes;
+
+            // Las paredes son elásticas: lo que no pierden los choques se conserva
+            double balance = energiaCinetica(sim.getParticulas()) +
+                             sim.getEnergiaPerdidaParticulas() - energiaInicial;
+
+            cout << setw(10) << n
+                 << setw(12) << (config.tipo == TipoColision::ELASTICA ? "e = 1.0" : "e = 0.9")
+                 << setw(10) << (config.colores ? "colores" : "lista")
+                 << setw(7) << config.hilos
+                 << setw(12) << fixed << setprecision(2) << ms / pasos
+                 << setw(15) << choques / pasos
+                 << setw(16) << choques / (ms * 1000.0)
+                 << setw(17) << scientific << setprecision(2) << abs(balance) / energiaInicial
+                 << fixed << endl;
+        }
+    }
+    cout << defaultfloat << endl;
+}
+
+// --- Solver de contactos: barrido serial por pares vs colores con pasadas ---
+void Benchmark::solverContactos() {
+    cout << "=== Solver de contactos por colores (modo gas, e = 0.5) ===" << endl;
+    const int n = 20000;
+    const int pasos = 60;
+    const double dt = 0.016;
+    const double lado = 1000.0;
+    cout << n << " partículas colapsando al centro, " << pasos << " pasos" << endl;
+    cout << setw(24) << "configuración" << setw(12) << "ms/paso" << setw(15) << "choques/paso"
+         << setw(10) << "colores" << setw(18) << "residuo medio" << setw(17) << "residuo máx"
+         << endl;
+
+    struct Configuracion {
+        const char* nombre;
+        bool solver;
+        int iteraciones;
+        bool caliente;
+    };
+    const Configuracion configuraciones[] = {
+        {"pares en serie", false, 1, false},
+        {"colores, 1 pasada", true, 1, false},
+        {"colores, 4 pasadas", true, 4, false},
+        {"colores, 1 + caliente", true, 1, true},
+        {"colores, 4 + caliente", true, 4, true},
+        {"colores, 8 + caliente", true, 8, true},
+    };
+
+    for (const Configuracion& config : configuraciones) {
+        Simulador<> sim(lado, lado, dt, TipoColision::INELASTICA, 0.5);
+        sim.setDetallesConsola(false);
+        sim.setSalidaArchivos(false);
+        sim.setSolverContactos(config.solver, config.iteraciones, config.caliente);
+        poblarColapso(sim, n, lado, 42);
+
+        // El residuo se promedia en la segunda mitad, con el montón ya formado
+        double residuoMedio = 0.0, residuoMaximo = 0.0;
+        int colores = 0;
+        auto inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+            if (config.solver && k >= pasos / 2) {
+                double medio, maximo;
+                sim.getSolverContactos().calcularResiduo(sim.getParticulas(), medio, maximo);
+                residuoMedio += medio / (pasos - pasos / 2);
+                residuoMaximo = max(residuoMaximo, maximo);
+                colores = max(colores, sim.getSolverContactos().getNumColores());
+            }
+        }
+        double ms = milisegundosDesde(inicio) / pasos;
+
+        cout << setw(23) << config.nombre << setw(12) << fixed << setprecision(2) << ms
+             << setw(15) << sim.getColisionesParticulas() / pasos;
+        if (config.solver) {
+            cout << setw(10) << colores << setw(18) << scientific << setprecision(2)
+                 << residuoMedio << setw(16) << residuoMaximo << fixed;
+        } else {
+            cout << setw(10) << "-" << setw(18) << "-" << setw(16) << "-";
+        }
+        cout << endl;
+    }
+
+    // Los colores no comparten partículas: el resultado no depende de los hilos
+    unsigned maxHilos = max(2u, thread::hardware_concurrency());
+    AlmacenParticulas referencia;
+    bool identico = true;
+    for (unsigned h : {1u, maxHilos}) {
+        Simulador<> sim(lado, lado, dt, TipoColision::INELASTICA, 0.5);
+        sim.setDetallesConsola(false);
+        sim.setSalidaArchivos(false);
+        sim.setHilos(h);
+        sim.setSolverContactos(true, 4, true);
+        poblarColapso(sim, n, lado, 42);
+        for (int k = 0; k < 20; k++) sim.ejecutarPaso();
+        if (h == 1) referencia = sim.getParticulas();
+        else identico = estadosIguales(referencia, sim.getParticulas());
+    }
+    cout << "Mismo estado con 1 y " << maxHilos << " hilos: " << (identico ? "sí" : "no")
+         << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Obstáculos: recorrido lineal por partícula vs BVH estático ---
+void Benchmark::consultaObstaculos() {
+    cout << "=== Consulta de obstáculos: lineal vs BVH ===" << endl;
+    const int n = 10000;
+    const double lado = ladoCajaPara(n);
+    cout << n << " partículas; los obstáculos cubren ~20% de la caja" << endl;
+    cout << setw(12) << "obstáculos" << setw(14) << "nodos BVH" << setw(14) << "construir ms"
+         << setw(14) << "lineal ms" << setw(12) << "BVH ms" << setw(10) << "factor"
+         << setw(11) << "contactos" << setw(11) << "idéntico" << endl;
+
+    vector<Particula*> punteros = crearParticulasAleatorias(n, lado, 42);
+    AlmacenParticulas almacen;
+    almacen.reservar(n);
+    for (const Particula* p : punteros) {
+        almacen.agregar(p->getId(), p->getPosicion().getX(), p->getPosicion().getY(),
+                        p->getVelocidad().getX(), p->getVelocidad().getY(),
+                        p->getMasa(), p->getRadio());
+    }
+    liberar(punteros);
+
+    for (int cantidad : {10, 1000, 100000}) {
+        // Cuadrados al azar (pueden solaparse) con área total ~20% de la caja
+        double ladoObstaculo = lado * sqrt(0.2 / cantidad);
+        mt19937 gen(7);
+        uniform_real_distribution<double> pos(0.0, lado - ladoObstaculo);
+        vector<Obstaculo> obstaculos;
+        obstaculos.reserve(cantidad);
+        for (int k = 0; k < cantidad; k++) {
+            obstaculos.emplace_back(pos(gen), pos(gen), ladoObstaculo, 0.7);
+        }
+
+        auto inicio = Reloj::now();
+        BvhObstaculos bvh;
+        bvh.construir(obstaculos);
+        double msConstruir = milisegundosDesde(inicio);
+
+        // Cada "paso" consulta una vez por partícula, como detectarColisionesObstaculos
+        const int repeticiones = cantidad >= 100000 ? 1 : 5;
+        vector<int> lineal(n), arbol(n);
+        inicio = Reloj::now();
+        for (int r = 0; r < repeticiones; r++) {
+            for (int i = 0; i < n; i++) {
+                lineal[i] = -1;
+                for (int k = 0; k < cantidad; k++) {
+                    if (obstaculos[k].colisionaCon(almacen.x[i], almacen.y[i], almacen.radio[i])) {
+                        lineal[i] = k;
+                        break;
+                    }
+                }
+            }
+        }
+        double msLineal = milisegundosDesde(inicio) / repeticiones;
+
+        inicio = Reloj::now();
+        for (int r = 0; r < repeticiones; r++) {
+            for (int i = 0; i < n; i++) {
+                arbol[i] = bvh.primerContacto(almacen.x[i], almacen.y[i], almacen.radio[i],
+                                              obstaculos);
+            }
+        }
+        double msArbol = milisegundosDesde(inicio) / repeticiones;
+
+        int contactos = count_if(arbol.begin(), arbol.end(), [](int k) { return k >= 0; });
+        cout << setw(11) << cantidad << setw(14) << bvh.getNumeroNodos()
+             << setw(14) << fixed << setprecision(3) << msConstruir
+             << setw(14) << msLineal << setw(12) << msArbol
+             << setw(9) << setprecision(1) << msLineal / msArbol << "x"
+             << setw(11) << contactos << setw(12) << (lineal == arbol ? "sí" : "no") << endl;
+    }
+    cout << "El simulador usa el BVH desde " << BvhObstaculos::MIN_OBSTACULOS << " obstáculos"
+         << endl;
+    cout << defaultfloat << endl;
+}
+
+// --- Campo de distancia horneado vs BVH, por resolución y cota de error ---
+void Benchmark::campoDistancia() {
+    cout << "=== Campo de distancia con signo para obstáculos ===" << endl;
+    const int n = 10000;
+    const double lado = 2000.0;
+    const double alcance = 50.0;   // Dos veces el radio máximo de las partículas
+    cout << n << " partículas en " << lado << " x " << lado
+         << "; los obstáculos cubren ~20% de la caja" << endl;
+    cout << setw(12) << "obstáculos" << setw(11) << "celda" << setw(8) << "cota"
+         << setw(10) << "lograda" << setw(11) << "error" << setw(9) << "MB"
+         << setw(15) << "hornear ms" << setw(11) << "BVH ms" << setw(12) << "campo ms"
+         << setw(14) << "coinciden" << setw(20) << "error penetración" << endl;
+
+    vector<Particula*> punteros = crearParticulasAleatorias(n, lado, 42);
+    AlmacenParticulas almacen;
+    almacen.reservar(n);
+    for (const Particula* p : punteros) {
+        almacen.agregar(p->getId(), p->getPosicion().getX(), p->getPosicion().getY(),
+                        p->getVelocidad().getX(), p->getVelocidad().getY(),
+                        p->getMasa(), p->getRadio());
+    }
+    liberar(punteros);
+
+    struct Configuracion {
+        double resolucion;
+        double cota;
+    };
+    const Configuracion configuraciones[] = {{8.0, 4.0}, {4.0, 2.0}, {2.0, 1.0}};
+    const int repeticiones = 5;
+
+    for (int cantidad : {10, 1000, 10000}) {
+        double ladoObstaculo = lado * sqrt(0.2 / cantidad);
+        mt19937 gen(7);
+        uniform_real_distribution<double> pos(0.0, lado - ladoObstaculo);
+        vector<Obstaculo> obstaculos;
+        obstaculos.reserve(cantidad);
+        for (int k = 0; k < cantidad; k++) {
+            obstaculos.emplace_back(pos(gen), pos(gen), ladoObstaculo, 0.7);
+        }
+
+        // Referencia: BVH con la prueba exacta y la distancia exacta a la unión
+        BvhObstaculos bvh;
+        bvh.construir(obstaculos);
+        vector<int> exacto(n);
+        auto inicio = Reloj::now();
+        for (int r = 0; r < repeticiones; r++) {
+            for (int i = 0; i < n; i++) {
+                exacto[i] = bvh.primerContacto(almacen.x[i], almacen.y[i], almacen.radio[i],
+                                               obstaculos);
+            }
+        }
+        double msBvh = milisegundosDesde(inicio) / repeticiones;
+
+        vector<double> distanciaExacta(n, alcance);
+        for (int i = 0; i < n; i++) {
+            if (exacto[i] < 0) continue;
+            for (const Obstaculo& obs : obstaculos) {
+                double dx = almacen.x[i] - max(obs.getLeft(), min(almacen.x[i], obs.getRight()));
+                double dy = almacen.y[i] - max(obs.getTop(), min(almacen.y[i], obs.getBottom()));
+                double d = sqrt(dx * dx + dy * dy);
+                if (d == 0) {
+                    // Dentro: distancia (negativa) a la cara más cercana
+                    d = -min({almacen.x[i] - obs.getLeft(), obs.getRight() - almacen.x[i],
+                              almacen.y[i] - obs.getTop(), obs.getBottom() - almacen.y[i]});
+                }
+                distanciaExacta[i] = min(distanciaExacta[i], d);
+            }
+        }
+
+        for (const Configuracion& config : configuraciones) {
+            CampoDistancia campo;
+            campo.configurar(config.resolucion, config.cota);
+            inicio = Reloj::now();
+            campo.construir(obstaculos, lado, lado, alcance);
+            double msHornear = milisegundosDesde(inicio);
+
+            vector<MuestraDistancia> muestras(n);
+            inicio = Reloj::now();
+            for (int r = 0; r < repeticiones; r++) {
+                for (int i = 0; i < n; i++) {
+                    muestras[i] = campo.muestrear(almacen.x[i], almacen.y[i]);
+                }
+            }
+            double msCampo = milisegundosDesde(inicio) / repeticiones;
+
+            // Contacto sí/no igual que la prueba exacta; error de penetración
+            // en las que tocan según ambas
+            int coinciden = 0;
+            double errorPenetracion = 0.0;
+            for (int i = 0; i < n; i++) {
+                bool tocaCampo = muestras[i].distancia < almacen.radio[i];
+                bool tocaExacto = exacto[i] >= 0;
+                if (tocaCampo == tocaExacto) coinciden++;
+                if (tocaCampo && tocaExacto) {
+                    errorPenetracion = max(errorPenetracion,
+                                           abs(muestras[i].distancia - distanciaExacta[i]));
+                }
+            }
+
+            cout << setw(11) << cantidad << setw(11) << fixed << setprecision(1) << config.resolucion
+                 << setw(8) << setprecision(2) << config.cota
+                 << setw(10) << campo.getResolucion()
+                 << setw(11) << setprecision(3) << campo.getErrorMaximo()
+                 << setw(9) << setprecision(1) << campo.getBytes() / 1e6
+                 << setw(15) << setprecision(2) << msHornear << setw(11) << msBvh
+                 << setw(12) << msCampo
+                 << setw(13) << setprecision(2) << 100.0 * coinciden / n << "%"
+                 << setw(20) << setprecision(3) << errorPenetracion << endl;
+        }
+    }
+    cout << defaultfloat << endl;
+}
+
+// --- Listas de vecinos de Verlet: grilla en cada paso vs listas por piel ---
+void Benchmark::listasVecinos() {
+    cout << "=== Listas de vecinos de Verlet (modo gas, e = 0.9) ===" << endl;
+    const int n = 100000;
+    const int pasos = 40;
+    const double dt = 0.016;
+    const int pasosPrevios = 30;
+    const double lado = ladoCajaPara(n);
+    // Las posiciones aleatorias se solapan: la separación inicial mueve mucho
+    // las partículas, así que se mide después de unos pasos de asentamiento
+    cout << n << " partículas, " << pasos << " pasos tras " << pasosPrevios
+         << " de asentamiento, |v| <= 141 px/s (" << fixed << setprecision(2)
+         << 141.0 * dt << " px/paso)" << endl;
+    cout << setw(12) << "piel (px)" << setw(12) << "ms/paso" << setw(18) << "reconstrucciones"
+         << setw(19) << "pares en lista" << setw(18) << "pares/paso" << setw(11) << "idéntico"
+         << endl;
+
+    AlmacenParticulas referencia;
+    for (double piel : {-1.0, 2.0, 5.0, 10.0, 20.0, 40.0}) {
+        Simulador<> sim(lado, lado, dt, TipoColision::INELASTICA, 0.9);
+        sim.setDetallesConsola(false);
+        sim.setSalidaArchivos(false);
+        if (piel >= 0) sim.setListaVecinos(true, piel);
+        poblar(sim, n, lado, 42);
+        for (int k = 0; k < pasosPrevios; k++) sim.ejecutarPaso();
+
+        const ListaVecinos& lista = sim.getListaVecinos();
+        long long reconstruccionesAntes = lista.getReconstrucciones();
+        long long paresAntes = sim.getParesEvaluados();
+        auto inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+        }
+        double ms = milisegundosDesde(inicio) / pasos;
+        if (piel < 0) {
+            referencia = sim.getParticulas();
+            cout << setw(12) << "grilla" << setw(12) << setprecision(2) << ms
+                 << setw(18) << "-" << setw(19) << "-";
+        } else {
+            cout << setw(12) << setprecision(1) << piel << setw(12) << setprecision(2) << ms
+                 << setw(11) << lista.getReconstrucciones() - reconstruccionesAntes
+                 << " / " << setw(4) << pasos
+                 << setw(19) << lista.getParesEnLista();
+        }
+        cout << setw(18) << (sim.getParesEvaluados() - paresAntes) / pasos
+             << setw(12) << (estadosIguales(referencia, sim.getParticulas()) ? "sí" : "no") << endl;
+    }
+    cout << defaultfloat << endl;
+}
+
+// --- Reorden de Morton: fallos de caché y tiempo de paso ---
+void Benchmark::ordenMorton() {
+    cout << "=== Reorden del almacén por código de Morton ===" << endl;
+    const int n = 200000;
+    const int pasos = 30;
+    const double dt = 0.016;
+    const double lado = ladoCajaPara(n) / sqrt(4.0);
+    cout << n << " partículas (modo gas, un hilo), " << pasos
+         << " pasos; las altas van en orden aleatorio en el espacio" << endl;
+
+    ContadorHardware fallos(EventoHardware::FALLOS_CACHE);
+    ContadorHardware referencias(EventoHardware::REFERENCIAS_CACHE);
+    if (!fallos.disponible()) {
+        cout << "Contadores de hardware no disponibles (perf_event_open); solo tiempos" << endl;
+    }
+    cout << setw(18) << "reorden" << setw(12) << "ms/paso" << setw(16) << "reordenamientos"
+         << setw(20) << "fallos caché/paso" << setw(22) << "referencias/paso"
+         << setw(14) << "tasa fallos" << endl;
+
+    struct Configuracion {
+        const char* nombre;
+        int cadaPasos;
+    };
+    const Configuracion configuraciones[] = {
+        {"sin reorden", 0},
+        {"solo al inicio", 1000000},
+        {"cada 10 pasos", 10},
+        {"cada paso", 1},
+    };
+
+    for (const Configuracion& config : configuraciones) {
+        Simulador<> sim(lado, lado, dt, TipoColision::INELASTICA, 0.9);
+        sim.setDetallesConsola(false);
+        sim.setSalidaArchivos(false);
+        sim.setReordenMorton(config.cadaPasos);
+        poblar(sim, n, lado, 42);
+
+        fallos.iniciar();
+        referencias.iniciar();
+        auto inicio = Reloj::now();
+        for (int k = 0; k < pasos; k++) {
+            sim.ejecutarPaso();
+        }
+        double ms = milisegundosDesde(inicio) / pasos;
+        long long totalFallos = fallos.detener();
+        long long totalReferencias = referencias.detener();
+
+        cout << setw(17) << config.nombre << setw(12) << fixed << setprecision(2) << ms
+             << setw(16) << sim.getReordenamientos();
+        if (fallos.disponible() && referencias.disponible()) {
+            cout << setw(20) << totalFallos / pasos << setw(22) << totalReferencias / pasos
+                 << setw(13) << setprecision(1)
+                 << (totalReferencias > 0 ? 100.0 * totalFallos / totalReferencias : 0.0) << "%";
+        } else {
+            cout << setw(20) << "n/d" << setw(22) << "n/d" << setw(14) << "n/d";
+        }
+        cout << endl;
+    }
+    cout << defaultfloat << endl;
+}
+
+// --- Grilla jerárquica: radios dispares (sintéticos y por fusión) ---
+void Benchmark::grillaJerarquica() {
+    cout << "=== Grilla jerárquica vs grilla única ===" << endl;
+    cout << "Partículas chicas (radio 2-5) con unas pocas gigantes:" << endl;
+    cout << setw(10) << "N" << setw(11) << "gigantes" << setw(9) << "radio"
+         << setw(10) << "niveles" << setw(14) << "única ms" << setw(16) << "niveles ms"
+         << setw(18) << "pruebas única" << setw(19) << "pruebas niveles"
+         << setw(11) << "idéntico" << endl;
+
+    for (int n : {10000, 100000}) {
+        for (double radioGigante : {0.0, 50.0, 400.0}) {
+            const int gigantes = radioGigante > 0 ? 10 : 0;
+            double lado = sqrt(n * 400.0);   // ~1 partícula chica por 20 x 20 px
+            mt19937 gen(42);
+            uniform_real_distribution<double> pos(0.0, lado);
+            uniform_real_distribution<double> radio(2.0, 5.0);
+            AlmacenParticulas almacen;
+            almacen.reservar(n + gigantes);
+            for (int i = 0; i < n + gigantes; i++) {
+                double r = (i < gigantes) ? radioGigante : radio(gen);
+                almacen.agregar(i, pos(gen), pos(gen), 0.0, 0.0, 1.0, r);
+            }
+
+            const int repeticiones = 3;
+            GrillaEspacial unica;
+            vector<pair<int, int>> paresUnica, paresNiveles;
+            auto inicio = Reloj::now();
+            for (int k = 0; k < repeticiones; k++) {
+                unica.construir(almacen);
+                unica.obtenerParesEnContacto(paresUnica);
+            }
+            double msUnica = milisegundosDesde(inicio) / repeticiones;
+
+            GrillaJerarquica niveles;
+            inicio = Reloj::now();
+            for (int k = 0; k < repeticiones; k++) {
+                niveles.construir(almacen);
+                niveles.obtenerParesEnContacto(paresNiveles);
+            }
+            double msNiveles = milisegundosDesde(inicio) / repeticiones;
+
+            cout << setw(10) << n << setw(11) << gigantes << setw(9) << fixed << setprecision(0)
+                 << radioGigante << setw(10) << niveles.getNumeroNiveles()
+                 << setw(14) << setprecision(2) << msUnica << setw(16) << msNiveles
+                 << setw(18) << unica.getParesEvaluados() / repeticiones
+                 << setw(19) << niveles.getParesEvaluados() / repeticiones
+                 << setw(12) << (paresUnica == paresNiveles ? "sí" : "no") << endl;
+        }
+    }
+
+    // Disperso: radios diminutos en una caja grande. La celda del nivel
+    // superior no puede bajar de la cota de ~4 celdas por partícula
+    cout << endl << "Disperso (1000 partículas en 2000 x 2000):" << endl;
+    cout << setw(10) << "radio" << setw(10) << "niveles" << setw(12) << "celdas"
+         << setw(14) << "única ms" << setw(16) << "niveles ms" << setw(11) << "idéntico" << endl;
+    for (double radioChico : {0.05, 0.005}) {
+        const int n = 1000;
+        const double lado = 2000.0;
+        mt19937 gen(42);
+        uniform_real_distribution<double> pos(0.0, lado);
+        AlmacenParticulas almacen;
+        almacen.reservar(n);
+        for (int i = 0; i < n; i++) {
+            almacen.agregar(i, pos(gen), pos(gen), 0.0, 0.0, 1.0, radioChico);
+        }
+
+        GrillaEspacial unica;
+        vector<pair<int, int>> paresUnica, paresNiveles;
+        auto inicio = Reloj::now();
+        unica.construir(almacen);
+        unica.obtenerParesEnContacto(paresUnica);
+        double msUnica = milisegundosDesde(inicio);
+
+        GrillaJerarquica niveles;
+        inicio = Reloj::now();
+        niveles.construir(almacen);
+        niveles.obtenerParesEnContacto(paresNiveles);
+        double msNiveles = milisegundosDesde(inicio);
+
+        cout << setw(10) << setprecision(3) << radioChico << setw(10) << niveles.getNumeroNiveles()
+             << setw(12) << niveles.getNumeroCeldas()
+             << setw(14) << setprecision(2) << msUnica << setw(16) << msNiveles
+             << setw(12) << (paresUnica == paresNiveles ? "sí" : "no") << endl;
+    }
+
+    // Fusión intensa: un cúmulo que colapsa al centro se fusiona en
+    // partículas cada vez más grandes dentro de un fondo de partículas chicas
+    const int fondo = 100000;
+    const int cumulo = 20000;
+    const int pasos = 150;
+    const int ventana = 50;
+    const double lado = 4000.0;
+    cout << endl << "Fusión intensa (" << fondo << " de fondo + " << cumulo
+         << " colapsando al centro), ms/paso:" << endl;
+    cout << setw(18) << "broadphase";
+    for (int desde = 0; desde < pasos; desde += ventana) {
+        cout << setw(16) << ("pasos " + to_string(desde) + "-" + to_string(desde + ventana - 1));
+    }
+    cout << setw(14) << "activas" << setw(14) << "radio máx" << setw(11) << "idéntico" << endl;
+
+    AlmacenParticulas referencia;
+    for (bool jerarquica : {false, true}) {
+        Simulador<> sim(lado, lado, 0.016, TipoColision::COMPLETAMENTE_INELASTICA, 1.0);
+        sim.setDetallesConsola(false);
+        sim.setSalidaArchivos(false);
+        sim.setGrillaJerarquica(jerarquica);
+        mt19937 gen(42);
+        uniform_real_distribution<double> pos(0.0, lado), vel(-20.0, 20.0), radio(2.0, 4.0);
+        uniform_real_distribution<double> centro(lado / 2 - 600.0, lado / 2 + 600.0);
+        for (int i = 0; i < fondo; i++) {
+            sim.agregarParticula(pos(gen), pos(gen), vel(gen), vel(gen), 1.0, radio(gen));
+        }
+        for (int i = 0; i < cumulo; i++) {
+            double x = centro(gen);
+            double y = centro(gen);
+            double dx = lado / 2 - x;
+            double dy = lado / 2 - y;
+            double d = max(1.0, sqrt(dx * dx + dy * dy));
+            sim.agregarParticula(x, y, 40.0 * dx / d, 40.0 * dy / d, 1.0, 3.0);
+        }
+
+        cout << setw(18) << (jerarquica ? "por niveles" : "única");
+        for (int desde = 0; desde < pasos; desde += ventana) {
+            auto inicio = Reloj::now();
+            for (int k = 0; k < ventana; k++) sim.ejecutarPaso();
+            cout << setw(16) << setprecision(2) << milisegundosDesde(inicio) / ventana;
+        }
+
+        const AlmacenParticulas& almacen = sim.getParticulas();
+        double radioMaximo = *max_element(almacen.radio.begin(), almacen.radio.end());
+        cout << setw(14) << sim.contarParticulasActivas() << setw(14) << setprecision(1)
+             << radioMaximo;
+        if (!jerarquica) {
+            referencia = almacen;
+            cout << setw(11) << "-" << endl;
+        } else {
+            cout << setw(12) << (estadosIguales(referencia, almacen) ? "sí" : "no") << endl;
+        }
+    }
+    cout << defaultfloat << endl;
+}
@@ -0,0 +1,40 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+/**
+ * @brief Mediciones de rendimiento del simulador
+ *
+ * Se ejecutan con: P5 --benchmark [nombre]
+ * Sin nombre (o con "todos") se corren todas las mediciones.
+ */
+class Benchmark {
+public:
+    static void ejecutar(const std::string& nombre);
+
+    // --- Mediciones ---
+    static void escalamientoBroadphase();   // Pares evaluados de 1k a 1M partículas
+    static void almacenSoAvsPunteros();     // Tiempo de paso: SoA vs vector<Particula*>
+    static void formatosSalida();           // Bytes/paso y tiempo de paso por formato
+    static void salidaAsincrona();          // Espera del hilo de simulación por política
+    static void accesoAleatorioArchivo();   // Frame en tiempo t: índice vs recorrido lineal
+    static void compresionTrayectorias();   // Bytes/paso y error del formato comprimido
+    static void keyframesEventos();         // Bytes vs eventos y reconstrucción exacta
+    static void formateoTexto();            // Líneas/s: ostream vs to_chars con buffer
+    static void escalamientoHilos();        // Escalamiento fuerte del paso, 1 a todos los núcleos
+    static void dominiosRebalanceo();       // Franjas fijas vs rebalanceadas con carga agrupada
+    static void kernelsSimd();              // Partículas/s de integración y paredes por ISA
+    static void faseFinaPorLotes();         // Pares candidatos + sqrt vs kernel por lotes
+    static void precisionNucleo();          // Simulador<float> vs <double>: velocidad y deriva
+    static void vectorEnLinea();            // Resolución de pares: Vector fuera de línea vs en línea
+    static void modoGas();                  // Choques/s del modo gas elástico e inelástico
+    static void solverContactos();          // Pares en serie vs colores: pasadas y arranque
+    static void consultaObstaculos();       // Obstáculos por partícula: recorrido lineal vs BVH
+    static void campoDistancia();           // Campo de distancia horneado: costo, memoria y error
+    static void listasVecinos();            // Grilla cada paso vs listas de Verlet por piel
+    static void ordenMorton();              // Fallos de caché y tiempo de paso con reorden Morton
+    static void grillaJerarquica();         // Grilla única vs por niveles con radios dispares
+};
+
+#endif // BENCHMARK_H
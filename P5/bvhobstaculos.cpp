@@ -0,0 +1,153 @@
+#include "bvhobstaculos.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace {
+
+// Misma prueba que Obstaculo::colisionaCon, contra una caja cualquiera
+template <typename T>
+bool circuloTocaCaja(T x, T y, T radio, T minX, T minY, T maxX, T maxY) {
+    T puntoX = max(minX, min(x, maxX));
+    T puntoY = max(minY, min(y, maxY));
+    T dx = x - puntoX;
+    T dy = y - puntoY;
+    return sqrt(dx * dx + dy * dy) < radio;
+}
+
+} // namespace
+
+// --- Construcción ---
+template <typename T>
+void BvhObstaculosT<T>::construir(const vector<ObstaculoT<T>>& obstaculos) {
+    limpiar();
+    int n = obstaculos.size();
+    if (n == 0) return;
+
+    orden.resize(n);
+    centroX.resize(n);
+    centroY.resize(n);
+    for (int k = 0; k < n; k++) {
+        orden[k] = k;
+        centroX[k] = obstaculos[k].getLeft() + obstaculos[k].getLado() / 2;
+        centroY[k] = obstaculos[k].getTop() + obstaculos[k].getLado() / 2;
+    }
+    nodos.reserve(2 * (n / HOJA_MAXIMA + 1));
+    construirNodo(obstaculos, 0, n);
+}
+
+template <typename T>
+int BvhObstaculosT<T>::construirNodo(const vector<ObstaculoT<T>>& obstaculos, int desde, int hasta) {
+    int indice = nodos.size();
+    nodos.emplace_back();
+
+    Nodo nodo;
+    nodo.minX = nodo.minY = numeric_limits<T>::max();
+    nodo.maxX = nodo.maxY = numeric_limits<T>::lowest();
+    nodo.menorIndice = numeric_limits<int>::max();
+    T cMinX = numeric_limits<T>::max(), cMaxX = numeric_limits<T>::lowest();
+    T cMinY = numeric_limits<T>::max(), cMaxY = numeric_limits<T>::lowest();
+    for (int k = desde; k < hasta; k++) {
+        const ObstaculoT<T>& obs = obstaculos[orden[k]];
+        nodo.minX = min(nodo.minX, obs.getLeft());
+        nodo.minY = min(nodo.minY, obs.getTop());
+        nodo.maxX = max(nodo.maxX, obs.getRight());
+        nodo.maxY = max(nodo.maxY, obs.getBottom());
+        nodo.menorIndice = min(nodo.menorIndice, orden[k]);
+        cMinX = min(cMinX, centroX[orden[k]]);
+        cMaxX = max(cMaxX, centroX[orden[k]]);
+        cMinY = min(cMinY, centroY[orden[k]]);
+        cMaxY = max(cMaxY, centroY[orden[k]]);
+    }
+
+    if (hasta - desde <= HOJA_MAXIMA) {
+        nodo.derecho = -1;
+        nodo.inicio = desde;
+        nodo.fin = hasta;
+        nodos[indice] = nodo;
+        return indice;
+    }
+
+    // Mediana del centro en el eje más largo (el índice desempata: determinista)
+    int medio = desde + (hasta - desde) / 2;
+    const vector<T>& centro = (cMaxX - cMinX >= cMaxY - cMinY) ? centroX : centroY;
+    nth_element(orden.begin() + desde, orden.begin() + medio, orden.begin() + hasta,
+                [&centro](int a, int b) {
+                    return centro[a] < centro[b] || (centro[a] == centro[b] && a < b);
+                });
+
+    nodo.inicio = desde;
+    nodo.fin = hasta;
+    construirNodo(obstaculos, desde, medio);            // Izquierdo: indice + 1
+    nodo.derecho = construirNodo(obstaculos, medio, hasta);
+    nodos[indice] = nodo;
+    return indice;
+}
+
+template <typename T>
+void BvhObstaculosT<T>::limpiar() {
+    nodos.clear();
+    orden.clear();
+}
+
+// --- Consulta ---
+template <typename T>
+int BvhObstaculosT<T>::primerContacto(T x, T y, T radio,
+                                      const vector<ObstaculoT<T>>& obstaculos) const {
+    if (nodos.empty()) return -1;
+
+    int mejor = -1;
+    int pila[64];
+    int tope = 0;
+    pila[tope++] = 0;
+
+    while (tope > 0) {
+        const Nodo& nodo = nodos[pila[--tope]];
+        // Un subárbol sin índices menores que el mejor no puede cambiarlo
+        if (mejor >= 0 && nodo.menorIndice >= mejor) continue;
+        if (!circuloTocaCaja(x, y, radio, nodo.minX, nodo.minY, nodo.maxX, nodo.maxY)) continue;
+
+        if (nodo.derecho < 0) {
+            for (int k = nodo.inicio; k < nodo.fin; k++) {
+                int o = orden[k];
+                if ((mejor < 0 || o < mejor) && obstaculos[o].colisionaCon(x, y, radio)) {
+                    mejor = o;
+                }
+            }
+        } else {
+            int izquierdo = &nodo - nodos.data() + 1;
+            // El hijo con el menor índice se visita primero (queda arriba en la pila)
+            if (nodos[izquierdo].menorIndice < nodos[nodo.derecho].menorIndice) {
+                pila[tope++] = nodo.derecho;
+                pila[tope++] = izquierdo;
+            } else {
+                pila[tope++] = izquierdo;
+                pila[tope++] = nodo.derecho;
+            }
+        }
+    }
+    return mejor;
+}
+
+// --- Estadísticas ---
+template <typename T>
+int BvhObstaculosT<T>::getNumeroNodos() const {
+    return nodos.size();
+}
+
+template <typename T>
+int BvhObstaculosT<T>::getProfundidad() const {
+    return nodos.empty() ? 0 : profundidadDe(0);
+}
+
+template <typename T>
+int BvhObstaculosT<T>::profundidadDe(int nodo) const {
+    if (nodos[nodo].derecho < 0) return 1;
+    return 1 + max(profundidadDe(nodo + 1), profundidadDe(nodos[nodo].derecho));
+}
+
+// --- Instancias ---
+template class BvhObstaculosT<float>;
+template class BvhObstaculosT<double>;
@@ -0,0 +1,62 @@
+#ifndef BVH_OBSTACULOS_H
+#define BVH_OBSTACULOS_H
+
+#include <vector>
+#include "obstaculo.h"
+
+/**
+ * @brief Jerarquía de cajas (BVH) estática sobre los obstáculos
+ *
+ * Se construye una vez sobre las cajas de los obstáculos: cada nodo parte
+ * sus obstáculos por la mediana del centro en el eje más largo, hasta hojas
+ * de a lo sumo HOJA_MAXIMA. Los nodos van en un arreglo plano en preorden
+ * (el hijo izquierdo es el siguiente nodo), así que la consulta recorre
+ * memoria contigua con una pila pequeña.
+ *
+ * primerContacto() devuelve el obstáculo de menor índice que toca el
+ * círculo, el mismo que encuentra el recorrido lineal en orden; cada nodo
+ * guarda el menor índice de su subárbol para descartar ramas que no pueden
+ * mejorar el resultado. La prueba contra la caja de un nodo usa la misma
+ * fórmula que Obstaculo::colisionaCon, así que nunca descarta un contacto.
+ */
+template <typename T>
+class BvhObstaculosT {
+private:
+    struct Nodo {
+        T minX, minY, maxX, maxY;   // Caja de todo el subárbol
+        int menorIndice;            // Menor índice de obstáculo del subárbol
+        int derecho;                // Hijo derecho (-1 en las hojas)
+        int inicio, fin;            // Hojas: rango en 'orden'
+    };
+
+    std::vector<Nodo> nodos;
+    std::vector<int> orden;         // Índices de obstáculos agrupados por hoja
+    std::vector<T> centroX, centroY;   // Trabajo de construir
+
+public:
+    static constexpr int HOJA_MAXIMA = 4;
+    static constexpr int MIN_OBSTACULOS = 32;   // Por debajo el recorrido lineal es más barato
+
+    // --- Construcción (una vez, o de nuevo si cambian los obstáculos) ---
+    void construir(const std::vector<ObstaculoT<T>>& obstaculos);
+    void limpiar();
+    bool vacia() const { return nodos.empty(); }
+
+    // --- Consulta: menor índice que toca el círculo, -1 si ninguno ---
+    int primerContacto(T x, T y, T radio, const std::vector<ObstaculoT<T>>& obstaculos) const;
+
+    // --- Estadísticas ---
+    int getNumeroNodos() const;
+    int getProfundidad() const;
+
+private:
+    int construirNodo(const std::vector<ObstaculoT<T>>& obstaculos, int desde, int hasta);
+    int profundidadDe(int nodo) const;
+};
+
+using BvhObstaculos = BvhObstaculosT<double>;
+
+extern template class BvhObstaculosT<float>;
+extern template class BvhObstaculosT<double>;
+
+#endif // BVH_OBSTACULOS_H
@@ -0,0 +1,186 @@
+#include "campodistancia.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Distancia con signo a un cuadrado y su gradiente (exactos)
+template <typename T>
+T distanciaCaja(const ObstaculoT<T>& obs, T px, T py, T& gx, T& gy) {
+    T mitad = obs.getLado() / 2;
+    T dx = px - (obs.getLeft() + mitad);
+    T dy = py - (obs.getTop() + mitad);
+    T qx = abs(dx) - mitad;
+    T qy = abs(dy) - mitad;
+    T sx = dx < 0 ? T(-1) : T(1);
+    T sy = dy < 0 ? T(-1) : T(1);
+
+    if (qx > 0 || qy > 0) {
+        // Fuera: distancia al punto más cercano del borde (cara o esquina)
+        T ox = max(qx, T(0));
+        T oy = max(qy, T(0));
+        T d = sqrt(ox * ox + oy * oy);
+        gx = sx * ox / d;
+        gy = sy * oy / d;
+        return d;
+    }
+    // Dentro: la cara más cercana
+    if (qx > qy) {
+        gx = sx;
+        gy = 0;
+        return qx;
+    }
+    gx = 0;
+    gy = sy;
+    return qy;
+}
+
+// Recorre, por obstáculo, los puntos origen + (cx, cy)·h a menos de 'alcance'
+// de su borde; escribir(celda, d, gx, gy, k) decide si se queda con el valor
+template <typename T, typename Escribir>
+void estampar(const vector<ObstaculoT<T>>& obstaculos, T origen, T h,
+              int columnas, int filas, T alcance, const Escribir& escribir) {
+    for (size_t k = 0; k < obstaculos.size(); k++) {
+        const ObstaculoT<T>& obs = obstaculos[k];
+        int cx0 = max(0, static_cast<int>(ceil((obs.getLeft() - alcance - origen) / h)));
+        int cx1 = min(columnas - 1, static_cast<int>(floor((obs.getRight() + alcance - origen) / h)));
+        int cy0 = max(0, static_cast<int>(ceil((obs.getTop() - alcance - origen) / h)));
+        int cy1 = min(filas - 1, static_cast<int>(floor((obs.getBottom() + alcance - origen) / h)));
+
+        for (int cy = cy0; cy <= cy1; cy++) {
+            T py = origen + cy * h;
+            for (int cx = cx0; cx <= cx1; cx++) {
+                T gx, gy;
+                T d = distanciaCaja(obs, origen + cx * h, py, gx, gy);
+                if (d < alcance) escribir(cy * columnas + cx, d, gx, gy, static_cast<int>(k));
+            }
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+CampoDistanciaT<T>::CampoDistanciaT()
+    : resolucionPedida(2), cotaError(T(0.5)), resolucion(2), alcance(0),
+    columnas(0), filas(0), errorMaximo(0) {}
+
+// --- Configuración ---
+template <typename T>
+void CampoDistanciaT<T>::configurar(T resolucion, T cotaError) {
+    resolucionPedida = resolucion;
+    this->cotaError = cotaError;
+}
+
+// --- Horneado ---
+template <typename T>
+void CampoDistanciaT<T>::construir(const vector<ObstaculoT<T>>& obstaculos,
+                                   T ancho, T alto, T alcance) {
+    this->alcance = alcance;
+    resolucion = resolucionPedida;
+
+    // Se afina la celda hasta cumplir la cota (o llegar al tope de memoria)
+    while (true) {
+        hornear(obstaculos, ancho, alto);
+        errorMaximo = medirError(obstaculos);
+        long long siguientes = static_cast<long long>(2 * columnas) * (2 * filas);
+        if (errorMaximo <= cotaError || siguientes > MAX_NODOS) break;
+        resolucion /= 2;
+    }
+    exacta.clear();
+    exacta.shrink_to_fit();
+}
+
+template <typename T>
+void CampoDistanciaT<T>::hornear(const vector<ObstaculoT<T>>& obstaculos, T ancho, T alto) {
+    columnas = max(2, static_cast<int>(ceil(ancho / resolucion)) + 1);
+    filas = max(2, static_cast<int>(ceil(alto / resolucion)) + 1);
+    nodos.assign(static_cast<size_t>(columnas) * filas, Nodo{alcance, 0, 0, -1});
+
+    // Mínimo sobre los obstáculos; en empate gana el de menor índice
+    estampar(obstaculos, T(0), resolucion, columnas, filas, alcance,
+             [this](int c, T d, T gx, T gy, int k) {
+                 if (d < nodos[c].distancia) nodos[c] = Nodo{d, gx, gy, k};
+             });
+}
+
+template <typename T>
+T CampoDistanciaT<T>::medirError(const vector<ObstaculoT<T>>& obstaculos) {
+    // Distancia exacta en los centros de celda, donde la bilineal es el
+    // promedio de las cuatro esquinas
+    int cc = columnas - 1;
+    int fc = filas - 1;
+    exacta.assign(static_cast<size_t>(cc) * fc, alcance);
+    estampar(obstaculos, resolucion / 2, resolucion, cc, fc, alcance,
+             [this](int c, T d, T, T, int) { exacta[c] = min(exacta[c], d); });
+
+    // Cerca del límite del alcance los nodos están recortados: no se mide
+    T error = 0;
+    for (int cy = 0; cy < fc; cy++) {
+        for (int cx = 0; cx < cc; cx++) {
+            T e = exacta[cy * cc + cx];
+            if (e >= alcance - resolucion) continue;
+            const Nodo* fila0 = &nodos[static_cast<size_t>(cy) * columnas + cx];
+            const Nodo* fila1 = fila0 + columnas;
+            T interpolada = (fila0[0].distancia + fila0[1].distancia +
+                             fila1[0].distancia + fila1[1].distancia) / 4;
+            error = max(error, abs(interpolada - e));
+        }
+    }
+    return error;
+}
+
+// --- Consulta ---
+template <typename T>
+MuestraDistanciaT<T> CampoDistanciaT<T>::muestrear(T x, T y) const {
+    T fx = min(max(x / resolucion, T(0)), T(columnas - 1));
+    T fy = min(max(y / resolucion, T(0)), T(filas - 1));
+    int cx = min(static_cast<int>(fx), columnas - 2);
+    int cy = min(static_cast<int>(fy), filas - 2);
+    T tx = fx - cx;
+    T ty = fy - cy;
+
+    const Nodo& a = nodos[static_cast<size_t>(cy) * columnas + cx];
+    const Nodo& b = (&a)[1];
+    const Nodo& c = (&a)[columnas];
+    const Nodo& d = (&a)[columnas + 1];
+    T wa = (1 - tx) * (1 - ty);
+    T wb = tx * (1 - ty);
+    T wc = (1 - tx) * ty;
+    T wd = tx * ty;
+
+    MuestraDistanciaT<T> m;
+    m.distancia = wa * a.distancia + wb * b.distancia + wc * c.distancia + wd * d.distancia;
+    T gx = wa * a.gx + wb * b.gx + wc * c.gx + wd * d.gx;
+    T gy = wa * a.gy + wb * b.gy + wc * c.gy + wd * d.gy;
+
+    // El obstáculo es el de la esquina más cercana a la superficie
+    const Nodo* cercano = &a;
+    for (const Nodo* n : {&b, &c, &d}) {
+        if (n->distancia < cercano->distancia) cercano = n;
+    }
+    m.obstaculo = cercano->obstaculo;
+
+    // Gradientes opuestos (entre dos obstáculos) pueden anularse
+    T largo = sqrt(gx * gx + gy * gy);
+    if (largo > T(1e-6)) {
+        m.nx = gx / largo;
+        m.ny = gy / largo;
+    } else {
+        m.nx = cercano->gx;
+        m.ny = cercano->gy;
+    }
+    return m;
+}
+
+// --- Estadísticas ---
+template <typename T>
+long long CampoDistanciaT<T>::getBytes() const {
+    return static_cast<long long>(nodos.size()) * sizeof(Nodo);
+}
+
+// --- Instancias ---
+template class CampoDistanciaT<float>;
+template class CampoDistanciaT<double>;
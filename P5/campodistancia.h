@@ -0,0 +1,91 @@
+#ifndef CAMPO_DISTANCIA_H
+#define CAMPO_DISTANCIA_H
+
+#include <vector>
+#include "obstaculo.h"
+
+/**
+ * @brief Resultado de muestrear el campo en un punto
+ */
+template <typename T>
+struct MuestraDistanciaT {
+    T distancia;      // Con signo: negativa dentro de un obstáculo
+    T nx, ny;         // Normal unitaria (gradiente), hacia afuera
+    int obstaculo;    // Obstáculo más cercano, -1 fuera del alcance
+};
+
+/**
+ * @brief Campo de distancia con signo horneado sobre la caja de simulación
+ *
+ * Los obstáculos son cuadrados estáticos, así que la distancia a su unión
+ * y su gradiente se calculan una vez en los nodos de una grilla regular.
+ * Cada obstáculo solo escribe los nodos a menos de 'alcance' de su borde;
+ * el resto queda en +alcance. Una consulta es una interpolación bilineal
+ * de cuatro nodos: distancia (penetración = radio - distancia) y normal,
+ * con un costo que no depende del número de obstáculos.
+ *
+ * La interpolación se aleja de la distancia exacta cerca de esquinas y de
+ * los puntos equidistantes de dos obstáculos. Tras hornear se mide el error
+ * en los centros de celda (el peor punto de la bilineal); si supera la cota
+ * pedida se reduce la celda a la mitad y se vuelve a hornear, hasta
+ * MAX_NODOS. getErrorMaximo() da el error logrado.
+ */
+template <typename T>
+class CampoDistanciaT {
+private:
+    struct Nodo {
+        T distancia;
+        T gx, gy;
+        int obstaculo;
+    };
+
+    // --- Configuración ---
+    T resolucionPedida;       // Lado de celda inicial
+    T cotaError;              // Error de distancia aceptado (mismas unidades)
+
+    // --- Grilla horneada ---
+    std::vector<Nodo> nodos;
+    std::vector<T> exacta;    // Trabajo: distancia exacta en los centros de celda
+    T resolucion;             // Lado de celda logrado
+    T alcance;
+    int columnas;
+    int filas;
+    T errorMaximo;
+
+public:
+    static constexpr long long MAX_NODOS = 1LL << 24;
+
+    CampoDistanciaT();
+
+    // --- Configuración ---
+    void configurar(T resolucion, T cotaError);
+    T getResolucionPedida() const { return resolucionPedida; }
+    T getCotaError() const { return cotaError; }
+
+    // --- Horneado sobre [0, ancho] x [0, alto] ---
+    void construir(const std::vector<ObstaculoT<T>>& obstaculos, T ancho, T alto, T alcance);
+    bool vacio() const { return nodos.empty(); }
+
+    // --- Consulta (fuera de la caja se usa el borde) ---
+    MuestraDistanciaT<T> muestrear(T x, T y) const;
+
+    // --- Estadísticas ---
+    T getResolucion() const { return resolucion; }
+    T getAlcance() const { return alcance; }
+    T getErrorMaximo() const { return errorMaximo; }
+    int getColumnas() const { return columnas; }
+    int getFilas() const { return filas; }
+    long long getBytes() const;
+
+private:
+    void hornear(const std::vector<ObstaculoT<T>>& obstaculos, T ancho, T alto);
+    T medirError(const std::vector<ObstaculoT<T>>& obstaculos);
+};
+
+using CampoDistancia = CampoDistanciaT<double>;
+using MuestraDistancia = MuestraDistanciaT<double>;
+
+extern template class CampoDistanciaT<float>;
+extern template class CampoDistanciaT<double>;
+
+#endif // CAMPO_DISTANCIA_H
@@ -8,67 +8,49 @@ using namespace std;
 // CLASE BASE: Colision
 // ============================================================================
 
-Colision::Colision() : colisionesTotales(0), energiaPerdida(0.0) {}
+template <typename T, typename Modelo>
+ColisionT<T, Modelo>::ColisionT() : colisionesTotales(0), energiaPerdida(0) {}
 
-void Colision::separarParticulas(Particula& p1, Particula& p2) {
+template <typename T, typename Modelo>
+void ColisionT<T, Modelo>::separarParticulas(Particula& p1, Particula& p2) {
     Vector r1 = p1.getPosicion();
     Vector r2 = p2.getPosicion();
-    double distancia = p1.distanciaA(p2);
-    double sumRadios = p1.getRadio() + p2.getRadio();
-
-    if (distancia < sumRadios) {
-        Vector direccion = r2 - r1;
-
-        if (distancia < EPSILON) {
-            direccion = Vector(1, 0);
-            distancia = 1.0;
-        }
-
-        direccion.normalizar();
-        double separacion = (sumRadios - distancia) / 2.0;
-
-        // Separar proporcionalmente a las masas inversas
-        double m1 = p1.getMasa();
-        double m2 = p2.getMasa();
-        double factorM1 = m2 / (m1 + m2);
-        double factorM2 = m1 / (m1 + m2);
-
-        p1.setPosicion(r1 - direccion * (separacion * factorM1));
-        p2.setPosicion(r2 + direccion * (separacion * factorM2));
+    if (separarSolapados(r1, r2, p1.getRadio() + p2.getRadio(), p1.getMasa(), p2.getMasa())) {
+        p1.setPosicion(r1);
+        p2.setPosicion(r2);
     }
 }
 
-void Colision::detectarYResolverColisiones(vector<Particula*>& particulas) {
-    int n = particulas.size();
-
-    for (int i = 0; i < n; i++) {
-        if (!particulas[i]->estaActiva()) continue;
-
-        for (int j = i + 1; j < n; j++) {
-            if (!particulas[j]->estaActiva()) continue;
-
-            if (particulas[i]->colisionaCon(*particulas[j])) {
-                resolverColision(*particulas[i], *particulas[j]);
-            }
-        }
+template <typename T, typename Modelo>
+void ColisionT<T, Modelo>::detectarYResolverColisiones(vector<Particula*>& particulas) {
+    // La grilla entrega solo los pares en contacto al inicio del barrido;
+    // resolverColision vuelve a comprobar cada uno con las posiciones ya
+    // corregidas por los pares anteriores
+    vector<pair<int, int>> pares;
+    grilla.construir(particulas);
+    grilla.obtenerParesEnContacto(pares);
+
+    Modelo& modelo = static_cast<Modelo&>(*this);
+    for (const auto& par : pares) {
+        modelo.resolverColision(*particulas[par.first], *particulas[par.second]);
     }
 }
 
-double Colision::calcularEnergiaCineticaTotal(const vector<Particula*>& particulas) const {
-    double energiaTotal = 0.0;
+template <typename T, typename Modelo>
+T ColisionT<T, Modelo>::calcularEnergiaCineticaTotal(const vector<Particula*>& particulas) const {
+    T energiaTotal = 0;
 
     for (const auto* p : particulas) {
         if (p->estaActiva()) {
-            Vector v = p->getVelocidad();
-            double rapidez = v.magnitud();
-            energiaTotal += 0.5 * p->getMasa() * rapidez * rapidez;
+            energiaTotal += T(0.5) * p->getMasa() * p->getVelocidad().magnitudCuadrada();
         }
     }
 
     return energiaTotal;
 }
 
-Vector Colision::calcularMomentoTotal(const vector<Particula*>& particulas) const {
+template <typename T, typename Modelo>
+VectorT<T> ColisionT<T, Modelo>::calcularMomentoTotal(const vector<Particula*>& particulas) const {
     Vector momentoTotal(0, 0);
 
     for (const auto* p : particulas) {
@@ -80,20 +62,36 @@ Vector Colision::calcularMomentoTotal(const vector<Particula*>& particulas) cons
     return momentoTotal;
 }
 
-int Colision::getColisionesTotales() const {
+template <typename T, typename Modelo>
+long long ColisionT<T, Modelo>::getColisionesTotales() const {
     return colisionesTotales;
 }
 
-double Colision::getEnergiaPerdida() const {
+template <typename T, typename Modelo>
+T ColisionT<T, Modelo>::getEnergiaPerdida() const {
     return energiaPerdida;
 }
 
-void Colision::resetEstadisticas() {
+template <typename T, typename Modelo>
+long long ColisionT<T, Modelo>::getParesEvaluados() const {
+    return grilla.getParesEvaluados();
+}
+
+template <typename T, typename Modelo>
+void ColisionT<T, Modelo>::resetEstadisticas() {
     colisionesTotales = 0;
-    energiaPerdida = 0.0;
+    energiaPerdida = 0;
+    grilla.resetEstadisticas();
+}
+
+template <typename T, typename Modelo>
+void ColisionT<T, Modelo>::acumular(const ContadoresColisionT<T>& contadores) {
+    colisionesTotales += contadores.colisiones;
+    energiaPerdida += contadores.energiaPerdida;
 }
 
-void Colision::mostrarEstadisticas() const {
+template <typename T, typename Modelo>
+void ColisionT<T, Modelo>::mostrarEstadisticas() const {
     cout << "Colisiones totales: " << colisionesTotales << endl;
     cout << "Energía perdida: " << energiaPerdida << " J" << endl;
 }
@@ -102,154 +100,120 @@ void Colision::mostrarEstadisticas() const {
 // COLISION ELASTICA (e = 1.0)
 // ============================================================================
 
-ColisionElastica::ColisionElastica() : Colision() {}
+template <typename T>
+ColisionElasticaT<T>::ColisionElasticaT() : Base() {}
 
-void ColisionElastica::resolverColision(Particula& p1, Particula& p2) {
+template <typename T>
+void ColisionElasticaT<T>::resolverColision(Particula& p1, Particula& p2) {
     if (!p1.estaActiva() || !p2.estaActiva()) return;
     if (!p1.colisionaCon(p2)) return;
 
-    Vector r1 = p1.getPosicion();
-    Vector r2 = p2.getPosicion();
     Vector v1 = p1.getVelocidad();
     Vector v2 = p2.getVelocidad();
-    double m1 = p1.getMasa();
-    double m2 = p2.getMasa();
-
-    // Vector normal de colisión
-    Vector n = r2 - r1;
-    n.normalizar();
-
-    // Velocidad relativa
-    Vector vRel = v1 - v2;
-    double vRelNormal = vRel.dot(n);
-
-    // Si se están alejando, no hay colisión
-    if (vRelNormal >= 0) return;
-
-    // Impulso para colisión elástica (e = 1)
-    double j = -2.0 * vRelNormal / (1.0/m1 + 1.0/m2);
-
-    Vector impulso = n * j;
-    v1 += impulso * (1.0 / m1);
-    v2 -= impulso * (1.0 / m2);
+    if (!aplicarImpulso(p1.getPosicion(), p2.getPosicion(), v1, v2,
+                        p1.getMasa(), p2.getMasa(), this->energiaPerdida)) return;
 
     p1.setVelocidad(v1);
     p2.setVelocidad(v2);
 
-    colisionesTotales++;
-    separarParticulas(p1, p2);
+    this->colisionesTotales++;
+    this->separarParticulas(p1, p2);
 }
 
-void ColisionElastica::mostrarEstadisticas() const {
+template <typename T>
+void ColisionElasticaT<T>::mostrarEstadisticas() const {
     cout << "\n=== Colisiones Elásticas ===" << endl;
     cout << "Coeficiente de restitución: 1.0" << endl;
-    Colision::mostrarEstadisticas();
+    Base::mostrarEstadisticas();
     cout << "Energía conservada (teóricamente)" << endl;
     cout << "==============================\n" << endl;
 }
 
+template <typename T>
+T ColisionElasticaT<T>::getCoeficienteRestitucion() const {
+    return 1;
+}
+
 // ============================================================================
 // COLISION INELASTICA (0 < e < 1)
 // ============================================================================
 
-ColisionInelastica::ColisionInelastica(double coefRestitucion)
-    : Colision(), coeficienteRestitucion(coefRestitucion) {
-    if (coefRestitucion < 0.0) coeficienteRestitucion = 0.0;
-    if (coefRestitucion > 1.0) coeficienteRestitucion = 1.0;
+template <typename T>
+ColisionInelasticaT<T>::ColisionInelasticaT(T coefRestitucion)
+    : Base(), coeficienteRestitucion(coefRestitucion) {
+    if (coefRestitucion < 0) coeficienteRestitucion = 0;
+    if (coefRestitucion > 1) coeficienteRestitucion = 1;
 }
 
-void ColisionInelastica::resolverColision(Particula& p1, Particula& p2) {
+template <typename T>
+void ColisionInelasticaT<T>::resolverColision(Particula& p1, Particula& p2) {
     if (!p1.estaActiva() || !p2.estaActiva()) return;
     if (!p1.colisionaCon(p2)) return;
 
-    Vector r1 = p1.getPosicion();
-    Vector r2 = p2.getPosicion();
     Vector v1 = p1.getVelocidad();
     Vector v2 = p2.getVelocidad();
-    double m1 = p1.getMasa();
-    double m2 = p2.getMasa();
-
-    // Vector normal de colisión
-    Vector n = r2 - r1;
-    n.normalizar();
-
-    // Velocidad relativa
-    Vector vRel = v1 - v2;
-    double vRelNormal = vRel.dot(n);
-
-    // Si se están alejando, no hay colisión
-    if (vRelNormal >= 0) return;
-
-    // Calcular energía antes
-    double energiaAntes = 0.5 * m1 * v1.magnitud() * v1.magnitud() +
-                          0.5 * m2 * v2.magnitud() * v2.magnitud();
-
-    // Impulso de colisión inelástica
-    double j = -(1.0 + coeficienteRestitucion) * vRelNormal / (1.0/m1 + 1.0/m2);
-
-    Vector impulso = n * j;
-    v1 += impulso * (1.0 / m1);
-    v2 -= impulso * (1.0 / m2);
+    if (!aplicarImpulso(p1.getPosicion(), p2.getPosicion(), v1, v2,
+                        p1.getMasa(), p2.getMasa(), this->energiaPerdida)) return;
 
     p1.setVelocidad(v1);
     p2.setVelocidad(v2);
 
-    // Calcular energía después
-    double energiaDespues = 0.5 * m1 * v1.magnitud() * v1.magnitud() +
-                            0.5 * m2 * v2.magnitud() * v2.magnitud();
-
-    energiaPerdida += (energiaAntes - energiaDespues);
-    colisionesTotales++;
-
-    separarParticulas(p1, p2);
+    this->colisionesTotales++;
+    this->separarParticulas(p1, p2);
 }
 
-void ColisionInelastica::mostrarEstadisticas() const {
+template <typename T>
+void ColisionInelasticaT<T>::mostrarEstadisticas() const {
     cout << "\n=== Colisiones Inelásticas ===" << endl;
     cout << "Coeficiente de restitución: " << coeficienteRestitucion << endl;
-    Colision::mostrarEstadisticas();
+    Base::mostrarEstadisticas();
     cout << "==============================\n" << endl;
 }
 
-double ColisionInelastica::getCoeficienteRestitucion() const {
+template <typename T>
+T ColisionInelasticaT<T>::getCoeficienteRestitucion() const {
     return coeficienteRestitucion;
 }
 
-void ColisionInelastica::setCoeficienteRestitucion(double coef) {
+template <typename T>
+void ColisionInelasticaT<T>::setCoeficienteRestitucion(T coef) {
     coeficienteRestitucion = coef;
-    if (coeficienteRestitucion < 0.0) coeficienteRestitucion = 0.0;
-    if (coeficienteRestitucion > 1.0) coeficienteRestitucion = 1.0;
+    if (coeficienteRestitucion < 0) coeficienteRestitucion = 0;
+    if (coeficienteRestitucion > 1) coeficienteRestitucion = 1;
 }
 
 // ============================================================================
 // COLISION COMPLETAMENTE INELASTICA (e = 0) - FUSION
 // ============================================================================
 
-ColisionCompletamenteInelastica::ColisionCompletamenteInelastica(int idInicial)
-    : Colision(), siguienteId(idInicial) {}
+template <typename T>
+ColisionCompletamenteInelasticaT<T>::ColisionCompletamenteInelasticaT(int idInicial)
+    : Base(), siguienteId(idInicial) {}
 
-void ColisionCompletamenteInelastica::resolverColision(Particula& p1, Particula& p2) {
+template <typename T>
+void ColisionCompletamenteInelasticaT<T>::resolverColision(Particula& p1, Particula& p2) {
     // Esta versión solo marca las partículas como inactivas
     // La fusión real se hace con fusionarParticulas()
     if (!p1.estaActiva() || !p2.estaActiva()) return;
     if (!p1.colisionaCon(p2)) return;
 
-    separarParticulas(p1, p2);
-    colisionesTotales++;
+    this->separarParticulas(p1, p2);
+    this->colisionesTotales++;
 }
 
-Particula* ColisionCompletamenteInelastica::fusionarParticulas(Particula& p1, Particula& p2) {
-    double m1 = p1.getMasa();
-    double m2 = p2.getMasa();
+template <typename T>
+ParticulaT<T> ColisionCompletamenteInelasticaT<T>::fusionarParticulas(Particula& p1, Particula& p2) {
+    T m1 = p1.getMasa();
+    T m2 = p2.getMasa();
     Vector v1 = p1.getVelocidad();
     Vector v2 = p2.getVelocidad();
 
     // Calcular energía antes
-    double energiaAntes = 0.5 * m1 * v1.magnitud() * v1.magnitud() +
-                          0.5 * m2 * v2.magnitud() * v2.magnitud();
+    T energiaAntes = T(0.5) * m1 * v1.magnitudCuadrada() +
+                          T(0.5) * m2 * v2.magnitudCuadrada();
 
     // Nueva masa
-    double M = m1 + m2;
+    T M = m1 + m2;
 
     // Conservación del momento lineal
     Vector v_nueva = (v1 * m1 + v2 * m2) / M;
@@ -258,10 +222,10 @@ Particula* ColisionCompletamenteInelastica::fusionarParticulas(Particula& p1, Pa
     Vector pos_nueva = calcularCentroMasa(p1, p2);
 
     // Nuevo radio (conservación de área)
-    double radio_nuevo = calcularNuevoRadio(p1, p2);
+    T radio_nuevo = calcularNuevoRadio(p1, p2);
 
     // Crear nueva partícula
-    Particula* nueva = new Particula(
+    Particula nueva(
         siguienteId++,
         pos_nueva.getX(),
         pos_nueva.getY(),
@@ -272,35 +236,97 @@ Particula* ColisionCompletamenteInelastica::fusionarParticulas(Particula& p1, Pa
         );
 
     // Calcular energía después
-    double energiaDespues = 0.5 * M * v_nueva.magnitud() * v_nueva.magnitud();
-    energiaPerdida += (energiaAntes - energiaDespues);
+    T energiaDespues = T(0.5) * M * v_nueva.magnitudCuadrada();
+    this->energiaPerdida += (energiaAntes - energiaDespues);
 
     return nueva;
 }
 
-void ColisionCompletamenteInelastica::mostrarEstadisticas() const {
+template <typename T>
+ParticulaT<T> ColisionCompletamenteInelasticaT<T>::fusionarParticulas(const vector<Particula>& grupo) {
+    // Fusión de un grupo completo de partículas solapadas en una sola:
+    // conserva masa, momento lineal y área (π*R² = Σ π*ri²)
+    T M = 0;
+    T sumaRadios2 = 0;
+    T energiaAntes = 0;
+    Vector momento(0, 0);
+    Vector sumaPosiciones(0, 0);
+
+    for (const Particula& p : grupo) {
+        T m = p.getMasa();
+        T r = p.getRadio();
+        Vector v = p.getVelocidad();
+
+        M += m;
+        sumaRadios2 += r * r;
+        energiaAntes += T(0.5) * m * v.magnitudCuadrada();
+        momento += v * m;
+        sumaPosiciones += p.getPosicion() * m;
+    }
+
+    Vector v_nueva = momento / M;
+    Vector pos_nueva = sumaPosiciones / M;   // Centro de masa
+
+    Particula nueva(
+        siguienteId++,
+        pos_nueva.getX(),
+        pos_nueva.getY(),
+        v_nueva.getX(),
+        v_nueva.getY(),
+        M,
+        sqrt(sumaRadios2)
+        );
+
+    T energiaDespues = T(0.5) * M * v_nueva.magnitudCuadrada();
+    this->energiaPerdida += (energiaAntes - energiaDespues);
+
+    return nueva;
+}
+
+template <typename T>
+void ColisionCompletamenteInelasticaT<T>::mostrarEstadisticas() const {
     cout << "\n=== Colisiones Completamente Inelásticas (Fusión) ===" << endl;
     cout << "Coeficiente de restitución: 0.0" << endl;
-    Colision::mostrarEstadisticas();
+    Base::mostrarEstadisticas();
     cout << "================================================\n" << endl;
 }
 
-void ColisionCompletamenteInelastica::setSiguienteId(int id) {
+template <typename T>
+void ColisionCompletamenteInelasticaT<T>::setSiguienteId(int id) {
     siguienteId = id;
 }
 
-Vector ColisionCompletamenteInelastica::calcularCentroMasa(const Particula& p1, const Particula& p2) const {
-    double m1 = p1.getMasa();
-    double m2 = p2.getMasa();
+template <typename T>
+VectorT<T> ColisionCompletamenteInelasticaT<T>::calcularCentroMasa(const Particula& p1, const Particula& p2) const {
+    T m1 = p1.getMasa();
+    T m2 = p2.getMasa();
     Vector pos1 = p1.getPosicion();
     Vector pos2 = p2.getPosicion();
 
     return (pos1 * m1 + pos2 * m2) / (m1 + m2);
 }
 
-double ColisionCompletamenteInelastica::calcularNuevoRadio(const Particula& p1, const Particula& p2) const {
+template <typename T>
+T ColisionCompletamenteInelasticaT<T>::calcularNuevoRadio(const Particula& p1, const Particula& p2) const {
     // Conservación de área (2D): π*R² = π*r1² + π*r2²
-    double r1 = p1.getRadio();
-    double r2 = p2.getRadio();
+    T r1 = p1.getRadio();
+    T r2 = p2.getRadio();
     return sqrt(r1 * r1 + r2 * r2);
 }
+
+// ============================================================================
+// INSTANCIAS
+// ============================================================================
+
+template class ColisionT<float, ColisionElasticaT<float>>;
+template class ColisionT<double, ColisionElasticaT<double>>;
+template class ColisionT<float, ColisionInelasticaT<float>>;
+template class ColisionT<double, ColisionInelasticaT<double>>;
+template class ColisionT<float, ColisionCompletamenteInelasticaT<float>>;
+template class ColisionT<double, ColisionCompletamenteInelasticaT<double>>;
+template class ColisionElasticaT<float>;
+template class ColisionElasticaT<double>;
+template class ColisionInelasticaT<float>;
+template class ColisionInelasticaT<double>;
+template class ColisionCompletamenteInelasticaT<float>;
+template class ColisionCompletamenteInelasticaT<double>;
@@ -3,92 +3,361 @@
 
 #include "particula.h"
 #include "vector.h"
+#include "grillaespacial.h"
+#include "almacenparticulas.h"
 #include <vector>
 
+enum class TipoColision {
+    ELASTICA,
+    INELASTICA,
+    COMPLETAMENTE_INELASTICA
+};
+
 /**
- * @brief Clase base abstracta para manejar colisiones entre partículas
+ * @brief Contadores del modo gas para un hilo o bloque de trabajo
+ *
+ * Cada tarea resuelve sus choques sobre sus propios contadores y al final
+ * del paso se suman al modelo con acumular(), sin atómicos en el bucle.
  */
-class Colision {
-protected:
-    int colisionesTotales;
-    double energiaPerdida;
+template <typename T>
+struct ContadoresColisionT {
+    long long colisiones = 0;
+    T energiaPerdida = 0;
+};
 
+/**
+ * @brief Separa r1 y r2 si se solapan, en proporción a las masas inversas
+ *
+ * Núcleo de separarParticulas, compartido por la vista Particula, el
+ * almacén SoA y SolverContactos. Devuelve si hubo que moverlas.
+ */
+template <typename T>
+bool separarSolapados(VectorT<T>& r1, VectorT<T>& r2, T sumRadios, T m1, T m2);
+
+/**
+ * @brief Base común de los modelos de colisión entre partículas (CRTP)
+ *
+ * Modelo es la clase concreta (ColisionElasticaT<T>, ...), que define
+ * resolverColision y mostrarEstadisticas. No hay métodos virtuales: el
+ * modelo se fija en compilación y el bucle de pares se instancia por
+ * modelo. La versión SoA de resolverColision (la del modo gas) está
+ * definida en este archivo, así que se expande en línea en el bucle de
+ * Simulador; la versión con Particula queda en colision.cpp.
+ *
+ * Toda la jerarquía usa el escalar T (float o double) de sus partículas;
+ * ColisionElastica, etc. son las versiones en double.
+ */
+template <typename T, typename Modelo>
+class ColisionT {
 public:
-    Colision();
-    virtual ~Colision() = default;
+    using Particula = ParticulaT<T>;
+    using Vector = VectorT<T>;
 
-    // Método virtual puro - debe ser implementado por clases derivadas
-    virtual void resolverColision(Particula& p1, Particula& p2) = 0;
+protected:
+    long long colisionesTotales;
+    T energiaPerdida;
+    GrillaEspacialT<T> grilla;     // Broadphase de detectarYResolverColisiones
 
+public:
     // Métodos auxiliares comunes
     void separarParticulas(Particula& p1, Particula& p2);
     void detectarYResolverColisiones(std::vector<Particula*>& particulas);
 
     // Cálculos de conservación
-    double calcularEnergiaCineticaTotal(const std::vector<Particula*>& particulas) const;
+    T calcularEnergiaCineticaTotal(const std::vector<Particula*>& particulas) const;
     Vector calcularMomentoTotal(const std::vector<Particula*>& particulas) const;
 
     // Getters y estadísticas
-    int getColisionesTotales() const;
-    double getEnergiaPerdida() const;
+    long long getColisionesTotales() const;
+    T getEnergiaPerdida() const;
+    long long getParesEvaluados() const;
     void resetEstadisticas();
-    virtual void mostrarEstadisticas() const;
+    void acumular(const ContadoresColisionT<T>& contadores);   // Suma los de una tarea
+    void mostrarEstadisticas() const;   // Parte común; el modelo agrega la suya
 
 protected:
-    static constexpr double EPSILON = 1e-10;
+    ColisionT();      // Solo como base de un modelo
+    ~ColisionT() = default;
 };
 
 /**
  * @brief Colisión perfectamente elástica (e = 1.0)
  * Conserva momento lineal y energía cinética
  */
-class ColisionElastica : public Colision {
+template <typename T>
+class ColisionElasticaT final : public ColisionT<T, ColisionElasticaT<T>> {
 public:
-    ColisionElastica();
+    using Base = ColisionT<T, ColisionElasticaT<T>>;
+    using Particula = ParticulaT<T>;
+    using Vector = VectorT<T>;
+
+    ColisionElasticaT();
 
-    void resolverColision(Particula& p1, Particula& p2) override;
-    void mostrarEstadisticas() const override;
+    void resolverColision(Particula& p1, Particula& p2);
+    T getCoeficienteRestitucion() const;   // Siempre 1
+    // Modo gas: choque del par (i, j) del almacén, contado en los contadores
+    // del hilo que lo resuelve. Devuelve si hubo impulso.
+    bool resolverColision(AlmacenParticulasT<T>& particulas, int i, int j,
+                          ContadoresColisionT<T>& contadores) const;
+    void mostrarEstadisticas() const;
+
+private:
+    // Impulso sobre v1 y v2 si se acercan (núcleo de ambas versiones)
+    bool aplicarImpulso(const Vector& r1, const Vector& r2, Vector& v1, Vector& v2,
+                        T m1, T m2, T& energiaPerdida) const;
 };
 
 /**
  * @brief Colisión inelástica con coeficiente de restitución 0 < e < 1
  * Conserva momento lineal pero pierde energía cinética
  */
-class ColisionInelastica : public Colision {
+template <typename T>
+class ColisionInelasticaT final : public ColisionT<T, ColisionInelasticaT<T>> {
+public:
+    using Base = ColisionT<T, ColisionInelasticaT<T>>;
+    using Particula = ParticulaT<T>;
+    using Vector = VectorT<T>;
+
 private:
-    double coeficienteRestitucion;
+    T coeficienteRestitucion;
 
 public:
-    explicit ColisionInelastica(double coefRestitucion = 0.8);
+    explicit ColisionInelasticaT(T coefRestitucion = 0.8);
 
-    void resolverColision(Particula& p1, Particula& p2) override;
-    void mostrarEstadisticas() const override;
+    void resolverColision(Particula& p1, Particula& p2);
+    // Modo gas: choque del par (i, j) del almacén, contado en los contadores
+    // del hilo que lo resuelve. Devuelve si hubo impulso.
+    bool resolverColision(AlmacenParticulasT<T>& particulas, int i, int j,
+                          ContadoresColisionT<T>& contadores) const;
+    void mostrarEstadisticas() const;
 
     // Getters y setters específicos
-    double getCoeficienteRestitucion() const;
-    void setCoeficienteRestitucion(double coef);
+    T getCoeficienteRestitucion() const;
+    void setCoeficienteRestitucion(T coef);
+
+private:
+    // Impulso sobre v1 y v2 si se acercan (núcleo de ambas versiones)
+    bool aplicarImpulso(const Vector& r1, const Vector& r2, Vector& v1, Vector& v2,
+                        T m1, T m2, T& energiaPerdida) const;
 };
 
 /**
  * @brief Colisión completamente inelástica (e = 0)
  * Las partículas se fusionan en una sola
  */
-class ColisionCompletamenteInelastica : public Colision {
+template <typename T>
+class ColisionCompletamenteInelasticaT final : public ColisionT<T, ColisionCompletamenteInelasticaT<T>> {
+public:
+    using Base = ColisionT<T, ColisionCompletamenteInelasticaT<T>>;
+    using Particula = ParticulaT<T>;
+    using Vector = VectorT<T>;
+
 private:
     int siguienteId;
 
 public:
-    explicit ColisionCompletamenteInelastica(int idInicial = 100);
+    explicit ColisionCompletamenteInelasticaT(int idInicial = 100);
 
-    void resolverColision(Particula& p1, Particula& p2) override;
-    Particula* fusionarParticulas(Particula& p1, Particula& p2);
-    void mostrarEstadisticas() const override;
+    void resolverColision(Particula& p1, Particula& p2);
+    Particula fusionarParticulas(Particula& p1, Particula& p2);
+    Particula fusionarParticulas(const std::vector<Particula>& grupo);
+    void mostrarEstadisticas() const;
 
     void setSiguienteId(int id);
 
 private:
     Vector calcularCentroMasa(const Particula& p1, const Particula& p2) const;
-    double calcularNuevoRadio(const Particula& p1, const Particula& p2) const;
+    T calcularNuevoRadio(const Particula& p1, const Particula& p2) const;
 };
 
+// ============================================================================
+// EN LÍNEA: núcleo del modo gas
+// ============================================================================
+// Definidos aquí y no en colision.cpp para que el bucle de pares de quien
+// los llama (Simulador, SolverContactos) los expanda en línea: los extern
+// template del final no impiden expandir funciones inline. GCC y Clang no
+// expandían el inelástico solo con 'inline' (por tamaño): se fuerza.
+
+#if defined(__GNUC__)
+#define COLISION_EN_LINEA inline __attribute__((always_inline))
+#else
+#define COLISION_EN_LINEA inline
+#endif
+
+template <typename T>
+COLISION_EN_LINEA bool separarSolapados(VectorT<T>& r1, VectorT<T>& r2, T sumRadios, T m1, T m2) {
+    using Vector = VectorT<T>;
+
+    const double epsilon = 1e-10;   // Distancia bajo la cual la normal no está definida
+
+    T distancia = (r1 - r2).magnitud();
+    if (distancia >= sumRadios) return false;
+
+    Vector direccion = r2 - r1;
+
+    if (distancia < epsilon) {
+        direccion = Vector(1, 0);
+        distancia = 1;
+    }
+
+    direccion.normalizar();
+    T separacion = (sumRadios - distancia) / 2;
+
+    // Separar proporcionalmente a las masas inversas
+    T factorM1 = m2 / (m1 + m2);
+    T factorM2 = m1 / (m1 + m2);
+
+    r1 = r1 - direccion * (separacion * factorM1);
+    r2 = r2 + direccion * (separacion * factorM2);
+    return true;
+}
+
+template <typename T>
+COLISION_EN_LINEA bool ColisionElasticaT<T>::resolverColision(AlmacenParticulasT<T>& particulas, int i, int j,
+                                                              ContadoresColisionT<T>& contadores) const {
+    if (!particulas.activa[i] || !particulas.activa[j]) return false;
+    if (!particulas.colisionan(i, j)) return false;
+
+    Vector r1(particulas.x[i], particulas.y[i]);
+    Vector r2(particulas.x[j], particulas.y[j]);
+    Vector v1(particulas.vx[i], particulas.vy[i]);
+    Vector v2(particulas.vx[j], particulas.vy[j]);
+    T m1 = particulas.masa[i];
+    T m2 = particulas.masa[j];
+    if (!aplicarImpulso(r1, r2, v1, v2, m1, m2, contadores.energiaPerdida)) return false;
+
+    particulas.vx[i] = v1.getX(); particulas.vy[i] = v1.getY();
+    particulas.vx[j] = v2.getX(); particulas.vy[j] = v2.getY();
+    contadores.colisiones++;
+
+    if (separarSolapados(r1, r2, particulas.radio[i] + particulas.radio[j], m1, m2)) {
+        particulas.x[i] = r1.getX(); particulas.y[i] = r1.getY();
+        particulas.x[j] = r2.getX(); particulas.y[j] = r2.getY();
+    }
+    return true;
+}
+
+template <typename T>
+COLISION_EN_LINEA bool ColisionElasticaT<T>::aplicarImpulso(const Vector& r1, const Vector& r2,
+                                                            Vector& v1, Vector& v2, T m1, T m2, T&) const {
+    // Vector normal de colisión
+    Vector n = (r2 - r1).normalizadoOCero();
+
+    // Velocidad relativa
+    Vector vRel = v1 - v2;
+    T vRelNormal = vRel.dot(n);
+
+    // n va de p1 a p2: se acercan solo si (v1 - v2)·n > 0
+    if (vRelNormal <= 0) return false;
+
+    // Impulso para colisión elástica (e = 1); la energía se conserva
+    T j = -2 * vRelNormal / (1 / m1 + 1 / m2);
+
+    Vector impulso = n * j;
+    v1.sumarEscalado(impulso, 1 / m1);
+    v2.sumarEscalado(impulso, -(1 / m2));
+    return true;
+}
+
+template <typename T>
+COLISION_EN_LINEA bool ColisionInelasticaT<T>::resolverColision(AlmacenParticulasT<T>& particulas, int i, int j,
+                                                                ContadoresColisionT<T>& contadores) const {
+    if (!particulas.activa[i] || !particulas.activa[j]) return false;
+    if (!particulas.colisionan(i, j)) return false;
+
+    Vector r1(particulas.x[i], particulas.y[i]);
+    Vector r2(particulas.x[j], particulas.y[j]);
+    Vector v1(particulas.vx[i], particulas.vy[i]);
+    Vector v2(particulas.vx[j], particulas.vy[j]);
+    T m1 = particulas.masa[i];
+    T m2 = particulas.masa[j];
+    if (!aplicarImpulso(r1, r2, v1, v2, m1, m2, contadores.energiaPerdida)) return false;
+
+    particulas.vx[i] = v1.getX(); particulas.vy[i] = v1.getY();
+    particulas.vx[j] = v2.getX(); particulas.vy[j] = v2.getY();
+    contadores.colisiones++;
+
+    if (separarSolapados(r1, r2, particulas.radio[i] + particulas.radio[j], m1, m2)) {
+        particulas.x[i] = r1.getX(); particulas.y[i] = r1.getY();
+        particulas.x[j] = r2.getX(); particulas.y[j] = r2.getY();
+    }
+    return true;
+}
+
+template <typename T>
+COLISION_EN_LINEA bool ColisionInelasticaT<T>::aplicarImpulso(const Vector& r1, const Vector& r2,
+                                                              Vector& v1, Vector& v2, T m1, T m2,
+                                                              T& energiaPerdida) const {
+    // Vector normal de colisión
+    Vector n = (r2 - r1).normalizadoOCero();
+
+    // Velocidad relativa
+    Vector vRel = v1 - v2;
+    T vRelNormal = vRel.dot(n);
+
+    // n va de p1 a p2: se acercan solo si (v1 - v2)·n > 0
+    if (vRelNormal <= 0) return false;
+
+    // Calcular energía antes
+    T energiaAntes = T(0.5) * m1 * v1.magnitudCuadrada() +
+                     T(0.5) * m2 * v2.magnitudCuadrada();
+
+    // Impulso de colisión inelástica
+    T j = -(1 + coeficienteRestitucion) * vRelNormal / (1 / m1 + 1 / m2);
+
+    Vector impulso = n * j;
+    v1.sumarEscalado(impulso, 1 / m1);
+    v2.sumarEscalado(impulso, -(1 / m2));
+
+    // Calcular energía después
+    T energiaDespues = T(0.5) * m1 * v1.magnitudCuadrada() +
+                       T(0.5) * m2 * v2.magnitudCuadrada();
+
+    energiaPerdida += (energiaAntes - energiaDespues);
+    return true;
+}
+
+/**
+ * @brief Modelo de colisión de cada TipoColision, para elegirlo en compilación
+ *
+ * ModeloColision<T, TipoColision::ELASTICA> es ColisionElasticaT<T>, etc.
+ */
+template <typename T, TipoColision Tipo>
+struct SeleccionModeloColision;
+
+template <typename T>
+struct SeleccionModeloColision<T, TipoColision::ELASTICA> {
+    using Modelo = ColisionElasticaT<T>;
+};
+
+template <typename T>
+struct SeleccionModeloColision<T, TipoColision::INELASTICA> {
+    using Modelo = ColisionInelasticaT<T>;
+};
+
+template <typename T>
+struct SeleccionModeloColision<T, TipoColision::COMPLETAMENTE_INELASTICA> {
+    using Modelo = ColisionCompletamenteInelasticaT<T>;
+};
+
+template <typename T, TipoColision Tipo>
+using ModeloColision = typename SeleccionModeloColision<T, Tipo>::Modelo;
+
+using ColisionElastica = ColisionElasticaT<double>;
+using ColisionInelastica = ColisionInelasticaT<double>;
+using ColisionCompletamenteInelastica = ColisionCompletamenteInelasticaT<double>;
+
+extern template class ColisionT<float, ColisionElasticaT<float>>;
+extern template class ColisionT<double, ColisionElasticaT<double>>;
+extern template class ColisionT<float, ColisionInelasticaT<float>>;
+extern template class ColisionT<double, ColisionInelasticaT<double>>;
+extern template class ColisionT<float, ColisionCompletamenteInelasticaT<float>>;
+extern template class ColisionT<double, ColisionCompletamenteInelasticaT<double>>;
+extern template class ColisionElasticaT<float>;
+extern template class ColisionElasticaT<double>;
+extern template class ColisionInelasticaT<float>;
+extern template class ColisionInelasticaT<double>;
+extern template class ColisionCompletamenteInelasticaT<float>;
+extern template class ColisionCompletamenteInelasticaT<double>;
+
 #endif // COLISION_H
@@ -1,8 +1,11 @@
 #include "colisionmanager.h"
 #include <cmath>
 
+using namespace std;
+
 // --- Colisión inelástica con obstáculo ---
-void ColisionManager::colisionInelastica(Particula& p, Obstaculo& obs) {
+template <typename T>
+void ColisionManagerT<T>::colisionInelastica(Particula& p, ObstaculoT<T>& obs) {
     // 1. Determinar qué lado del obstáculo colisionó
     char lado = obs.ladoColision(p.getPosicion());
 
@@ -17,7 +20,7 @@ void ColisionManager::colisionInelastica(Particula& p, Obstaculo& obs) {
     Vector v_paralela = componenteParalela(v, normal);
 
     // 5. Aplicar coeficiente de restitución solo a componente normal
-    double epsilon = obs.getCoefRestitucion();
+    T epsilon = obs.getCoefRestitucion();
     Vector v_normal_nueva = v_normal * (-epsilon);
 
     // 6. La componente paralela se mantiene
@@ -30,23 +33,48 @@ void ColisionManager::colisionInelastica(Particula& p, Obstaculo& obs) {
     obs.corregirPosicion(p, lado);
 }
 
+// --- Colisión con el campo de distancia ---
+template <typename T>
+void ColisionManagerT<T>::colisionCampoDistancia(Particula& p, const MuestraDistanciaT<T>& muestra,
+                                                 T coefRestitucion) {
+    // 1. La normal sale del gradiente interpolado (en las esquinas es diagonal)
+    Vector normal(muestra.nx, muestra.ny);
+
+    // 2. Solo se refleja la componente normal si la partícula se acerca
+    Vector v = p.getVelocidad();
+    T vn = v.dot(normal);
+    if (vn < 0) {
+        p.setVelocidad(componenteParalela(v, normal) + normal * (-coefRestitucion * vn));
+    }
+
+    // 3. Sacar la partícula la profundidad de penetración
+    T penetracion = p.getRadio() - muestra.distancia;
+    if (penetracion > 0) {
+        Vector pos = p.getPosicion();
+        p.setPosicion(pos.sumarEscalado(normal, penetracion));
+    }
+}
+
 // --- Componente normal del vector ---
-Vector ColisionManager::componenteNormal(const Vector& v, const Vector& normal) {
+template <typename T>
+typename ColisionManagerT<T>::Vector ColisionManagerT<T>::componenteNormal(const Vector& v, const Vector& normal) {
     // v_⊥ = (v · n̂) * n̂
-    double producto = v.dot(normal);
+    T producto = v.dot(normal);
     return normal * producto;
 }
 
 // --- Componente paralela del vector ---
-Vector ColisionManager::componenteParalela(const Vector& v, const Vector& normal) {
+template <typename T>
+typename ColisionManagerT<T>::Vector ColisionManagerT<T>::componenteParalela(const Vector& v, const Vector& normal) {
     // v_∥ = v - v_⊥
     return v - componenteNormal(v, normal);
 }
 
 // --- Calcular centro de masa ---
-Vector ColisionManager::calcularCentroMasa(const Particula& p1, const Particula& p2) {
-    double m1 = p1.getMasa();
-    double m2 = p2.getMasa();
+template <typename T>
+typename ColisionManagerT<T>::Vector ColisionManagerT<T>::calcularCentroMasa(const Particula& p1, const Particula& p2) {
+    T m1 = p1.getMasa();
+    T m2 = p2.getMasa();
     Vector pos1 = p1.getPosicion();
     Vector pos2 = p2.getPosicion();
 
@@ -55,35 +83,37 @@ Vector ColisionManager::calcularCentroMasa(const Particula& p1, const Particula&
 }
 
 // --- Calcular nuevo radio ---
-double ColisionManager::calcularNuevoRadio(const Particula& p1, const Particula& p2) {
+template <typename T>
+T ColisionManagerT<T>::calcularNuevoRadio(const Particula& p1, const Particula& p2) {
     // Conservación de área (2D): π*R² = π*r1² + π*r2²
-    double r1 = p1.getRadio();
-    double r2 = p2.getRadio();
+    T r1 = p1.getRadio();
+    T r2 = p2.getRadio();
     return sqrt(r1 * r1 + r2 * r2);
 }
 
 // --- Separar partículas solapadas ---
-void ColisionManager::separarParticulas(Particula& p1, Particula& p2) {
+template <typename T>
+void ColisionManagerT<T>::separarParticulas(Particula& p1, Particula& p2) {
     Vector pos1 = p1.getPosicion();
     Vector pos2 = p2.getPosicion();
 
     Vector diferencia = pos2 - pos1;
-    double distancia = diferencia.magnitud();
+    T distancia = diferencia.magnitud();
 
     if (distancia < EPSILON) {
         diferencia = Vector(1, 0);
-        distancia = 1.0;
+        distancia = 1;
     }
 
     Vector direccion = diferencia / distancia;
-    double distanciaMinima = p1.getRadio() + p2.getRadio();
-    double solapamiento = distanciaMinima - distancia;
+    T distanciaMinima = p1.getRadio() + p2.getRadio();
+    T solapamiento = distanciaMinima - distancia;
 
     if (solapamiento > 0) {
-        double m1 = p1.getMasa();
-        double m2 = p2.getMasa();
-        double factorM1 = m2 / (m1 + m2);
-        double factorM2 = m1 / (m1 + m2);
+        T m1 = p1.getMasa();
+        T m2 = p2.getMasa();
+        T factorM1 = m2 / (m1 + m2);
+        T factorM2 = m1 / (m1 + m2);
 
         Vector correccion1 = direccion * (solapamiento * factorM1);
         Vector correccion2 = direccion * (solapamiento * factorM2);
@@ -95,16 +125,17 @@ void ColisionManager::separarParticulas(Particula& p1, Particula& p2) {
 
 // --- DEPRECATED: Fusión de partículas ---
 // Usar ColisionCompletamenteInelastica::fusionarParticulas() en su lugar
-Particula* ColisionManager::fusionarParticulas(Particula& p1, Particula& p2, int nuevoId) {
-    double m1 = p1.getMasa();
-    double m2 = p2.getMasa();
+template <typename T>
+typename ColisionManagerT<T>::Particula* ColisionManagerT<T>::fusionarParticulas(Particula& p1, Particula& p2, int nuevoId) {
+    T m1 = p1.getMasa();
+    T m2 = p2.getMasa();
     Vector v1 = p1.getVelocidad();
     Vector v2 = p2.getVelocidad();
 
-    double M = m1 + m2;
+    T M = m1 + m2;
     Vector v_nueva = (v1 * m1 + v2 * m2) / M;
     Vector pos_nueva = calcularCentroMasa(p1, p2);
-    double radio_nuevo = calcularNuevoRadio(p1, p2);
+    T radio_nuevo = calcularNuevoRadio(p1, p2);
 
     Particula* nueva = new Particula(
         nuevoId,
@@ -118,3 +149,7 @@ Particula* ColisionManager::fusionarParticulas(Particula& p1, Particula& p2, int
 
     return nueva;
 }
+
+// --- Instancias ---
+template class ColisionManagerT<float>;
+template class ColisionManagerT<double>;
@@ -5,16 +5,25 @@
 #include "obstaculo.h"
 #include "vector.h"
 #include "colision.h"
+#include "campodistancia.h"
 
 /**
  * @brief Gestor de colisiones que maneja todos los tipos de interacciones
  * Integra colisiones con obstáculos y permite seleccionar el tipo de
  * colisión entre partículas mediante herencia polimórfica
  */
-class ColisionManager {
+template <typename T>
+class ColisionManagerT {
 public:
+    using Particula = ParticulaT<T>;
+    using Vector = VectorT<T>;
+
     // --- Colisión con obstáculo (inelástica con coeficiente ε) ---
-    static void colisionInelastica(Particula& p, Obstaculo& obs);
+    static void colisionInelastica(Particula& p, ObstaculoT<T>& obs);
+
+    // --- Colisión con el campo de distancia horneado (normal del gradiente) ---
+    static void colisionCampoDistancia(Particula& p, const MuestraDistanciaT<T>& muestra,
+                                       T coefRestitucion);
 
     // --- Utilidades para descomposición de vectores ---
     static Vector componenteNormal(const Vector& v, const Vector& normal);
@@ -25,7 +34,7 @@ public:
 
     // --- Métodos auxiliares para fusión (usados por ColisionCompletamenteInelastica) ---
     static Vector calcularCentroMasa(const Particula& p1, const Particula& p2);
-    static double calcularNuevoRadio(const Particula& p1, const Particula& p2);
+    static T calcularNuevoRadio(const Particula& p1, const Particula& p2);
 
     // DEPRECATED: Usar ColisionCompletamenteInelastica::fusionarParticulas() en su lugar
     static Particula* fusionarParticulas(Particula& p1, Particula& p2, int nuevoId);
@@ -34,4 +43,9 @@ private:
     static constexpr double EPSILON = 1e-10;
 };
 
+using ColisionManager = ColisionManagerT<double>;
+
+extern template class ColisionManagerT<float>;
+extern template class ColisionManagerT<double>;
+
 #endif // COLISION_MANAGER_H
@@ -0,0 +1,381 @@
+#include "compresiontrayectorias.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace {
+
+// --- Varint (7 bits por byte) y zig-zag (signo en el bit menos significativo) ---
+void escribirVarint(vector<char>& buffer, uint64_t valor) {
+    while (valor >= 0x80) {
+        buffer.push_back(static_cast<char>((valor & 0x7F) | 0x80));
+        valor >>= 7;
+    }
+    buffer.push_back(static_cast<char>(valor));
+}
+
+uint64_t leerVarint(const vector<char>& buffer, size_t& pos) {
+    uint64_t valor = 0;
+    int desplazamiento = 0;
+    while (pos < buffer.size()) {
+        uint8_t byte = static_cast<uint8_t>(buffer[pos++]);
+        valor |= static_cast<uint64_t>(byte & 0x7F) << desplazamiento;
+        if (!(byte & 0x80)) break;
+        desplazamiento += 7;
+    }
+    return valor;
+}
+
+uint64_t zigzag(int64_t valor) {
+    return (static_cast<uint64_t>(valor) << 1) ^ static_cast<uint64_t>(valor >> 63);
+}
+
+int64_t deszigzag(uint64_t valor) {
+    return static_cast<int64_t>(valor >> 1) ^ -static_cast<int64_t>(valor & 1);
+}
+
+template <typename T>
+void agregarValor(vector<char>& buffer, const T& valor) {
+    size_t inicio = buffer.size();
+    buffer.resize(inicio + sizeof(T));
+    memcpy(buffer.data() + inicio, &valor, sizeof(T));
+}
+
+template <typename T>
+T leerValor(const char* datos) {
+    T valor;
+    memcpy(&valor, datos, sizeof(T));
+    return valor;
+}
+
+int64_t cuantizar(double valor, double precision) {
+    return llround(valor / precision);
+}
+
+} // namespace
+
+// ============================================================================
+// HISTORIAL COMPARTIDO
+// ============================================================================
+
+int HistorialCuantizado::edadEn(int id, int bloqueActual) const {
+    if (id < 0 || id >= static_cast<int>(edad.size())) return 0;
+    return bloque[id] == bloqueActual ? edad[id] : 0;
+}
+
+void HistorialCuantizado::actualizar(int id, int bloqueActual, int64_t qx, int64_t qy,
+                                     int64_t qvx, int64_t qvy) {
+    if (id >= static_cast<int>(edad.size())) {
+        size_t n = id + 1;
+        x1.resize(n); x0.resize(n); y1.resize(n); y0.resize(n);
+        vx.resize(n); vy.resize(n);
+        edad.resize(n, 0);
+        bloque.resize(n, -1);
+    }
+    if (bloque[id] != bloqueActual) {
+        bloque[id] = bloqueActual;
+        edad[id] = 0;
+    }
+    x0[id] = x1[id];
+    y0[id] = y1[id];
+    x1[id] = qx;
+    y1[id] = qy;
+    vx[id] = qvx;
+    vy[id] = qvy;
+    edad[id] = min(edad[id] + 1, 2);
+}
+
+int64_t HistorialCuantizado::predecirX(int id, int e) const {
+    if (e >= 2) return 2 * x1[id] - x0[id];
+    return e == 1 ? x1[id] : 0;
+}
+
+int64_t HistorialCuantizado::predecirY(int id, int e) const {
+    if (e >= 2) return 2 * y1[id] - y0[id];
+    return e == 1 ? y1[id] : 0;
+}
+
+void HistorialCuantizado::limpiar() {
+    x1.clear(); x0.clear(); y1.clear(); y0.clear();
+    vx.clear(); vy.clear();
+    edad.clear();
+    bloque.clear();
+}
+
+// ============================================================================
+// ESCRITURA
+// ============================================================================
+
+EscritorComprimido::EscritorComprimido(double dt, double ancho, double alto,
+                                       double precisionPosicion, double precisionVelocidad,
+                                       int framesPorBloque)
+    : EscritorTrayectorias(), numeroBloque(0), framesEnBloque(0),
+    framesPorBloque(framesPorBloque < 1 ? 1 : framesPorBloque), pasoAnterior(0),
+    precisionPosicion(precisionPosicion), precisionVelocidad(precisionVelocidad),
+    dt(dt), ancho(ancho), alto(alto) {}
+
+EscritorComprimido::~EscritorComprimido() {
+    cerrar();
+}
+
+bool EscritorComprimido::abrir() {
+    archivo.open("trayectorias.p5z", ios::binary);
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir trayectorias.p5z" << endl;
+        return false;
+    }
+
+    vector<char> cabecera(MAGIA, MAGIA + sizeof(MAGIA));
+    agregarValor(cabecera, VERSION);
+    agregarValor(cabecera, static_cast<uint32_t>(framesPorBloque));
+    agregarValor(cabecera, precisionPosicion);
+    agregarValor(cabecera, precisionVelocidad);
+    agregarValor(cabecera, dt);
+    agregarValor(cabecera, ancho);
+    agregarValor(cabecera, alto);
+    archivo.write(cabecera.data(), cabecera.size());
+    bytesEscritos += cabecera.size();
+    return true;
+}
+
+void EscritorComprimido::escribirFrame(const FrameTrayectoria& frame) {
+    if (!archivo.is_open()) return;
+    int n = frame.cantidad();
+
+    // Inicio de bloque: sin historial
+    if (framesEnBloque == 0) {
+        bloque.assign(BYTES_CABECERA_BLOQUE, '\0');
+        int32_t pasoInicial = frame.paso;
+        memcpy(bloque.data() + 8, &pasoInicial, sizeof(pasoInicial));
+        memcpy(bloque.data() + 12, &frame.tiempo, sizeof(frame.tiempo));
+        pasoAnterior = frame.paso;
+    }
+
+    escribirVarint(bloque, static_cast<uint64_t>(frame.paso - pasoAnterior));
+    pasoAnterior = frame.paso;
+    agregarValor(bloque, frame.tiempo);
+
+    // Ids: solo si cambiaron respecto al frame anterior del bloque
+    bool idsNuevos = (framesEnBloque == 0) || frame.id != idsAnteriores;
+    bloque.push_back(idsNuevos ? 1 : 0);
+    if (idsNuevos) {
+        escribirVarint(bloque, n);
+        int anterior = 0;
+        for (int id : frame.id) {
+            escribirVarint(bloque, zigzag(static_cast<int64_t>(id) - anterior));
+            anterior = id;
+        }
+        idsAnteriores = frame.id;
+    }
+
+    // Máscaras (4 bits por partícula) y luego las diferencias no nulas
+    size_t inicioMascaras = bloque.size();
+    bloque.resize(inicioMascaras + (n + 1) / 2, '\0');
+
+    for (int k = 0; k < n; k++) {
+        int id = frame.id[k];
+        int edad = historial.edadEn(id, numeroBloque);
+
+        int64_t qx = cuantizar(frame.x[k], precisionPosicion);
+        int64_t qy = cuantizar(frame.y[k], precisionPosicion);
+        int64_t qvx = cuantizar(frame.vx[k], precisionVelocidad);
+        int64_t qvy = cuantizar(frame.vy[k], precisionVelocidad);
+
+        int64_t diferencias[4] = {
+            qx - historial.predecirX(id, edad),
+            qy - historial.predecirY(id, edad),
+            qvx - (edad > 0 ? historial.vx[id] : 0),
+            qvy - (edad > 0 ? historial.vy[id] : 0)
+        };
+        historial.actualizar(id, numeroBloque, qx, qy, qvx, qvy);
+
+        uint8_t mascara = 0;
+        for (int c = 0; c < 4; c++) {
+            if (diferencias[c] != 0) {
+                mascara |= 1 << c;
+                escribirVarint(bloque, zigzag(diferencias[c]));
+            }
+        }
+        bloque[inicioMascaras + k / 2] |= static_cast<char>(mascara << (4 * (k % 2)));
+    }
+
+    framesEnBloque++;
+    if (framesEnBloque >= framesPorBloque || bloque.size() >= BYTES_MAXIMOS_BLOQUE) cerrarBloque();
+}
+
+void EscritorComprimido::cerrarBloque() {
+    if (framesEnBloque == 0) return;
+
+    // Un solo frame de más de 4 GiB no cabe en el tamaño de 32 bits: se
+    // corta el archivo en el último bloque válido en vez de corromperlo
+    size_t tamano = bloque.size() - BYTES_CABECERA_BLOQUE;
+    if (tamano > numeric_limits<uint32_t>::max()) {
+        cerr << "Error: bloque de trayectorias.p5z de más de 4 GiB, se deja de escribir" << endl;
+        archivo.close();
+        framesEnBloque = 0;
+        return;
+    }
+
+    uint32_t bytes = tamano;
+    uint32_t numFrames = framesEnBloque;
+    memcpy(bloque.data(), &bytes, sizeof(bytes));
+    memcpy(bloque.data() + 4, &numFrames, sizeof(numFrames));
+
+    archivo.write(bloque.data(), bloque.size());
+    bytesEscritos += bloque.size();
+
+    framesEnBloque = 0;
+    numeroBloque++;
+}
+
+void EscritorComprimido::cerrar() {
+    if (!archivo.is_open()) return;
+    cerrarBloque();
+    archivo.close();
+    historial.limpiar();
+}
+
+// ============================================================================
+// LECTURA
+// ============================================================================
+
+LectorComprimido::LectorComprimido()
+    : posicion(0), framesRestantes(0), numeroBloque(-1), pasoAnterior(0),
+    inicioBloque(EscritorComprimido::BYTES_CABECERA), pasoInicioBloque(numeric_limits<int>::min()),
+    precisionPosicion(1.0), precisionVelocidad(1.0) {}
+
+bool LectorComprimido::abrir(const string& ruta) {
+    cerrar();
+    archivo.open(ruta, ios::binary);
+    if (!archivo.is_open()) return false;
+
+    char cabecera[EscritorComprimido::BYTES_CABECERA];
+    if (!archivo.read(cabecera, sizeof(cabecera)) ||
+        memcmp(cabecera, EscritorComprimido::MAGIA, 8) != 0) {
+        cerrar();
+        return false;
+    }
+    precisionPosicion = leerValor<double>(cabecera + 16);
+    precisionVelocidad = leerValor<double>(cabecera + 24);
+    return true;
+}
+
+void LectorComprimido::cerrar() {
+    if (archivo.is_open()) archivo.close();
+    archivo.clear();
+    bloque.clear();
+    posicion = 0;
+    framesRestantes = 0;
+    numeroBloque = -1;
+    inicioBloque = EscritorComprimido::BYTES_CABECERA;
+    pasoInicioBloque = numeric_limits<int>::min();
+    idsAnteriores.clear();
+    historial.limpiar();
+}
+
+bool LectorComprimido::cargarBloque(bool decodificar) {
+    streampos inicio = archivo.tellg();
+    char cabecera[EscritorComprimido::BYTES_CABECERA_BLOQUE];
+    if (!archivo.read(cabecera, sizeof(cabecera))) return false;
+    uint32_t bytes = leerValor<uint32_t>(cabecera);
+
+    // numeroBloque nunca retrocede: un bloque releído no ve el historial viejo
+    numeroBloque++;
+    inicioBloque = inicio;
+    pasoInicioBloque = leerValor<int32_t>(cabecera + 8);
+    if (!decodificar) {
+        archivo.seekg(bytes, ios::cur);
+        return static_cast<bool>(archivo);
+    }
+
+    bloque.resize(bytes);
+    if (!archivo.read(bloque.data(), bytes)) return false;
+    posicion = 0;
+    framesRestantes = leerValor<uint32_t>(cabecera + 4);
+    pasoAnterior = leerValor<int32_t>(cabecera + 8);
+    return true;
+}
+
+bool LectorComprimido::leerFrame(FrameTrayectoria& frame) {
+    if (framesRestantes == 0 && !cargarBloque(true)) return false;
+
+    frame.limpiar();
+    frame.paso = pasoAnterior + static_cast<int>(leerVarint(bloque, posicion));
+    pasoAnterior = frame.paso;
+    frame.tiempo = leerValor<double>(bloque.data() + posicion);
+    posicion += sizeof(double);
+
+    bool idsNuevos = bloque[posicion++] != 0;
+    if (idsNuevos) {
+        int n = leerVarint(bloque, posicion);
+        idsAnteriores.resize(n);
+        int anterior = 0;
+        for (int k = 0; k < n; k++) {
+            anterior += static_cast<int>(deszigzag(leerVarint(bloque, posicion)));
+            idsAnteriores[k] = anterior;
+        }
+    }
+    frame.id = idsAnteriores;
+    int n = frame.cantidad();
+
+    size_t inicioMascaras = posicion;
+    posicion += (n + 1) / 2;
+
+    for (int k = 0; k < n; k++) {
+        int id = frame.id[k];
+        int edad = historial.edadEn(id, numeroBloque);
+        uint8_t mascara = (static_cast<uint8_t>(bloque[inicioMascaras + k / 2]) >> (4 * (k % 2))) & 0xF;
+
+        int64_t diferencias[4] = {0, 0, 0, 0};
+        for (int c = 0; c < 4; c++) {
+            if (mascara & (1 << c)) diferencias[c] = deszigzag(leerVarint(bloque, posicion));
+        }
+
+        int64_t qx = historial.predecirX(id, edad) + diferencias[0];
+        int64_t qy = historial.predecirY(id, edad) + diferencias[1];
+        int64_t qvx = (edad > 0 ? historial.vx[id] : 0) + diferencias[2];
+        int64_t qvy = (edad > 0 ? historial.vy[id] : 0) + diferencias[3];
+        historial.actualizar(id, numeroBloque, qx, qy, qvx, qvy);
+
+        frame.x.push_back(qx * precisionPosicion);
+        frame.y.push_back(qy * precisionPosicion);
+        frame.vx.push_back(qvx * precisionVelocidad);
+        frame.vy.push_back(qvy * precisionVelocidad);
+    }
+
+    framesRestantes--;
+    return true;
+}
+
+bool LectorComprimido::saltarHastaPaso(int paso) {
+    // Desde el bloque actual si 'paso' no es anterior a él (aunque ya se
+    // hayan leído frames suyos); si no, desde el primer bloque
+    archivo.clear();
+    archivo.seekg(pasoInicioBloque <= paso ? inicioBloque
+                                           : streampos(EscritorComprimido::BYTES_CABECERA));
+    framesRestantes = 0;
+
+    while (true) {
+        streampos inicio = archivo.tellg();
+        char cabecera[EscritorComprimido::BYTES_CABECERA_BLOQUE];
+        if (!archivo.read(cabecera, sizeof(cabecera))) return false;
+        archivo.seekg(leerValor<uint32_t>(cabecera), ios::cur);
+
+        // ¿El bloque siguiente empieza después de 'paso'?
+        char siguiente[EscritorComprimido::BYTES_CABECERA_BLOQUE];
+        bool haySiguiente = static_cast<bool>(archivo.read(siguiente, sizeof(siguiente)));
+        if (!haySiguiente || leerValor<int32_t>(siguiente + 8) > paso) {
+            archivo.clear();
+            archivo.seekg(inicio);
+            inicioBloque = inicio;
+            pasoInicioBloque = leerValor<int32_t>(cabecera + 8);
+            return pasoInicioBloque <= paso;
+        }
+        archivo.seekg(-static_cast<streamoff>(sizeof(siguiente)), ios::cur);
+        numeroBloque++;
+    }
+}
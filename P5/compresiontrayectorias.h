@@ -0,0 +1,121 @@
+#ifndef COMPRESION_TRAYECTORIAS_H
+#define COMPRESION_TRAYECTORIAS_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include "escritortrayectorias.h"
+
+/**
+ * @brief Valores cuantizados de los últimos frames de cada id
+ *
+ * Lo usan por igual el codificador y el decodificador para predecir el
+ * valor siguiente; solo se guardan las diferencias con la predicción.
+ * Posición: extrapolación lineal (2*q1 - q0). Velocidad: último valor.
+ */
+struct HistorialCuantizado {
+    std::vector<int64_t> x1, x0, y1, y0, vx, vy;
+    std::vector<int> edad;      // Frames vistos del id en el bloque (0, 1 o 2)
+    std::vector<int> bloque;    // Bloque al que pertenece 'edad'
+
+    int edadEn(int id, int bloqueActual) const;
+    void actualizar(int id, int bloqueActual, int64_t qx, int64_t qy, int64_t qvx, int64_t qvy);
+    int64_t predecirX(int id, int edad) const;
+    int64_t predecirY(int id, int edad) const;
+    void limpiar();
+};
+
+/**
+ * @brief Trayectorias cuantizadas y comprimidas (trayectorias.p5z)
+ *
+ * Posiciones y velocidades se cuantizan a la precisión configurada y por
+ * cada partícula se guarda la diferencia con la predicción del historial,
+ * en varint con zig-zag. Los frames se agrupan en bloques independientes
+ * (el primer frame de cada bloque no usa historial), así que un lector
+ * puede saltar bloques enteros sin decodificarlos.
+ *
+ * Cabecera (56 bytes): char[8] "P5COMPR" + '\0'; uint32 version (1);
+ *   uint32 framesPorBloque; double precisionPosicion, precisionVelocidad,
+ *   dt, ancho, alto
+ *
+ * Un bloque se cierra a los framesPorBloque frames o al pasar
+ * BYTES_MAXIMOS_BLOQUE, lo que ocurra antes: con millones de partículas la
+ * memoria del bloque no depende de framesPorBloque.
+ *
+ * Bloque: uint32 bytes (sin esta cabecera de 20 bytes), uint32 numFrames,
+ *   int32 pasoInicial, double tiempoInicial; luego numFrames frames:
+ *   varint paso - pasoAnterior; double tiempo; byte idsNuevos;
+ *   si idsNuevos: varint cantidad y los ids como diferencias zig-zag;
+ *   una máscara de 4 bits por partícula (dx, dy, dvx, dvy distintos de 0),
+ *   dos partículas por byte; las diferencias no nulas en varint zig-zag.
+ */
+class EscritorComprimido : public EscritorTrayectorias {
+private:
+    std::ofstream archivo;
+    std::vector<char> bloque;
+    std::vector<int> idsAnteriores;
+    HistorialCuantizado historial;
+    int numeroBloque;
+    int framesEnBloque;
+    int framesPorBloque;
+    int pasoAnterior;
+    double precisionPosicion;
+    double precisionVelocidad;
+    double dt;
+    double ancho;
+    double alto;
+
+public:
+    static constexpr char MAGIA[8] = {'P', '5', 'C', 'O', 'M', 'P', 'R', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t BYTES_CABECERA = 56;
+    static constexpr uint32_t BYTES_CABECERA_BLOQUE = 20;
+    static constexpr size_t BYTES_MAXIMOS_BLOQUE = 16 << 20;
+
+    EscritorComprimido(double dt, double ancho, double alto, double precisionPosicion,
+                       double precisionVelocidad, int framesPorBloque = 256);
+    ~EscritorComprimido() override;
+
+    bool abrir() override;
+    void escribirFrame(const FrameTrayectoria& frame) override;
+    void cerrar() override;
+
+private:
+    void cerrarBloque();
+};
+
+/**
+ * @brief Lectura secuencial de trayectorias.p5z
+ */
+class LectorComprimido {
+private:
+    std::ifstream archivo;
+    std::vector<char> bloque;
+    size_t posicion;                 // Lectura dentro del bloque
+    int framesRestantes;             // Del bloque actual
+    int numeroBloque;
+    int pasoAnterior;
+    std::vector<int> idsAnteriores;
+    HistorialCuantizado historial;
+    std::streampos inicioBloque;     // Cabecera del bloque actual (o del elegido al saltar)
+    int pasoInicioBloque;
+    double precisionPosicion;
+    double precisionVelocidad;
+
+public:
+    LectorComprimido();
+
+    bool abrir(const std::string& ruta);
+    bool leerFrame(FrameTrayectoria& frame);     // Siguiente frame; false al final
+    // Deja el lector al inicio del bloque que contiene 'paso' (false si es
+    // anterior al primer bloque). Sirve en cualquier punto de la lectura y
+    // hacia atrás; salta bloques completos sin decodificarlos.
+    bool saltarHastaPaso(int paso);
+    void cerrar();
+
+private:
+    bool cargarBloque(bool decodificar);
+};
+
+#endif // COMPRESION_TRAYECTORIAS_H
@@ -0,0 +1,278 @@
+#include "descomposiciondominios.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+template <typename T>
+DescomposicionDominiosT<T>::DescomposicionDominiosT(int numDominios, double ancho)
+    : ancho(ancho), rebalanceoActivo(true), umbralDesbalance(1.25),
+    pasosDesdeRebalanceo(0), rebalanceos(0), cortesIniciales(false) {
+    numDominios = max(1, numDominios);
+    dominios.resize(numDominios);
+
+    // Franjas de igual ancho hasta conocer la distribución
+    for (int d = 0; d < numDominios; d++) {
+        dominios[d].desde = ancho * d / numDominios;
+        dominios[d].hasta = ancho * (d + 1) / numDominios;
+        dominios[d].propias = 0;
+        dominios[d].segundosPaso = 0.0;
+        dominios[d].segundosTotal = 0.0;
+    }
+}
+
+// --- Paso ---
+template <typename T>
+void DescomposicionDominiosT<T>::obtenerParesEnContacto(const AlmacenParticulasT<T>& particulas,
+                                                        PoolHilos* pool,
+                                                        vector<pair<int, int>>& pares) {
+    if (rebalanceoActivo) {
+        if (!cortesIniciales) {
+            rebalancear(particulas, false);        // Primer paso: igual número de partículas
+            cortesIniciales = true;
+        } else if (pasosDesdeRebalanceo >= PASOS_MINIMOS_ENTRE_REBALANCEOS &&
+                   getDesbalance() > umbralDesbalance) {
+            rebalancear(particulas, true);
+            rebalanceos++;
+        }
+    }
+    pasosDesdeRebalanceo++;
+
+    repartirParticulas(particulas);
+
+    // Un dominio por tarea: el pool reparte los dominios entre los hilos
+    auto tarea = [&](int inicio, int fin, int) {
+        for (int d = inicio; d < fin; d++) {
+            resolverDominio(dominios[d]);
+        }
+    };
+    if (pool) {
+        pool->paraCada(getNumDominios(), 1, tarea);
+    } else {
+        tarea(0, getNumDominios(), 0);
+    }
+
+    pares.clear();
+    for (const Dominio& dominio : dominios) {
+        pares.insert(pares.end(), dominio.pares.begin(), dominio.pares.end());
+    }
+    sort(pares.begin(), pares.end());
+}
+
+template <typename T>
+void DescomposicionDominiosT<T>::repartirParticulas(const AlmacenParticulasT<T>& particulas) {
+    int n = particulas.tamano();
+    duenoDe.assign(n, -1);
+
+    T radioMaximo = 0;
+    for (int i = 0; i < n; i++) {
+        if (particulas.activa[i]) radioMaximo = max(radioMaximo, particulas.radio[i]);
+    }
+    double halo = 2.0 * radioMaximo;   // Ningún par en contacto está más separado en x
+
+    for (Dominio& dominio : dominios) {
+        dominio.globales.clear();
+        dominio.x.clear();
+        dominio.y.clear();
+        dominio.radio.clear();
+        dominio.activa.clear();
+    }
+
+    auto agregarLocal = [&](Dominio& dominio, int i) {
+        dominio.globales.push_back(i);
+        dominio.x.push_back(particulas.x[i]);
+        dominio.y.push_back(particulas.y[i]);
+        dominio.radio.push_back(particulas.radio[i]);
+        dominio.activa.push_back(1);
+    };
+
+    // Propias primero
+    for (int i = 0; i < n; i++) {
+        if (!particulas.activa[i]) continue;
+        duenoDe[i] = dominioDe(particulas.x[i]);
+        agregarLocal(dominios[duenoDe[i]], i);
+    }
+    for (Dominio& dominio : dominios) {
+        dominio.propias = dominio.globales.size();
+    }
+
+    // Fantasmas: copias en cada franja vecina a menos de un halo
+    int numDominios = getNumDominios();
+    for (int i = 0; i < n; i++) {
+        int d = duenoDe[i];
+        if (d < 0) continue;
+        double x = particulas.x[i];
+        for (int e = d - 1; e >= 0 && x - dominios[e].hasta <= halo; e--) {
+            agregarLocal(dominios[e], i);
+        }
+        for (int e = d + 1; e < numDominios && dominios[e].desde - x <= halo; e++) {
+            agregarLocal(dominios[e], i);
+        }
+    }
+}
+
+template <typename T>
+void DescomposicionDominiosT<T>::resolverDominio(Dominio& dominio) {
+    auto inicio = chrono::steady_clock::now();
+    int propio = &dominio - dominios.data();
+
+    dominio.grilla.construir(dominio.x.data(), dominio.y.data(), dominio.radio.data(),
+                             dominio.activa.data(), dominio.globales.size());
+    dominio.grilla.obtenerParesEnContacto(dominio.contactos);
+
+    // Cada par lo entrega solo el dueño del menor índice
+    dominio.pares.clear();
+    for (const auto& par : dominio.contactos) {
+        int i = dominio.globales[par.first];
+        int j = dominio.globales[par.second];
+        if (i > j) swap(i, j);
+        if (duenoDe[i] == propio) dominio.pares.emplace_back(i, j);
+    }
+
+    dominio.segundosPaso = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    dominio.segundosTotal += dominio.segundosPaso;
+}
+
+// --- Rebalanceo ---
+template <typename T>
+void DescomposicionDominiosT<T>::rebalancear(const AlmacenParticulasT<T>& particulas, bool porTiempo) {
+    int numDominios = getNumDominios();
+    int cubetas = numDominios * CUBETAS_POR_DOMINIO;
+    histograma.assign(cubetas, 0.0);
+
+    // Costo por partícula de cada dominio en el último paso
+    vector<double> costo(numDominios, 1.0);
+    if (porTiempo) {
+        for (int d = 0; d < numDominios; d++) {
+            costo[d] = dominios[d].segundosPaso / max(1, dominios[d].propias);
+        }
+    }
+
+    double total = 0.0;
+    int n = particulas.tamano();
+    for (int i = 0; i < n; i++) {
+        if (!particulas.activa[i]) continue;
+        double x = particulas.x[i];
+        int c = static_cast<int>(x / ancho * cubetas);
+        c = max(0, min(cubetas - 1, c));
+        double peso = costo[dominioDe(x)];
+        histograma[c] += peso;
+        total += peso;
+    }
+    pasosDesdeRebalanceo = 0;
+    if (total <= 0.0) return;
+
+    // Cortes en los cuantiles del peso acumulado
+    double anchoCubeta = ancho / cubetas;
+    double acumulado = 0.0;
+    int c = 0;
+    for (int d = 1; d < numDominios; d++) {
+        double objetivo = total * d / numDominios;
+        while (c < cubetas && acumulado + histograma[c] < objetivo) {
+            acumulado += histograma[c++];
+        }
+        double corte = ancho;
+        if (c < cubetas) {
+            double fraccion = histograma[c] > 0 ? (objetivo - acumulado) / histograma[c] : 0.0;
+            corte = (c + fraccion) * anchoCubeta;
+        }
+        corte = max(corte, dominios[d - 1].desde);
+        dominios[d - 1].hasta = corte;
+        dominios[d].desde = corte;
+    }
+    dominios.front().desde = 0.0;
+    dominios.back().hasta = ancho;
+}
+
+template <typename T>
+void DescomposicionDominiosT<T>::setRebalanceo(bool activo, double umbral) {
+    rebalanceoActivo = activo;
+    umbralDesbalance = umbral;
+}
+
+template <typename T>
+void DescomposicionDominiosT<T>::setIsa(IsaSimd isa) {
+    for (Dominio& dominio : dominios) {
+        dominio.grilla.setIsa(isa);
+    }
+}
+
+template <typename T>
+int DescomposicionDominiosT<T>::dominioDe(double x) const {
+    // Búsqueda binaria del primer dominio con x < hasta (fuera de la caja: el extremo)
+    int bajo = 0;
+    int alto = getNumDominios() - 1;
+    while (bajo < alto) {
+        int medio = (bajo + alto) / 2;
+        if (x < dominios[medio].hasta) {
+            alto = medio;
+        } else {
+            bajo = medio + 1;
+        }
+    }
+    return bajo;
+}
+
+// --- Estadísticas ---
+template <typename T>
+int DescomposicionDominiosT<T>::getNumDominios() const {
+    return dominios.size();
+}
+
+template <typename T>
+int DescomposicionDominiosT<T>::getRebalanceos() const {
+    return rebalanceos;
+}
+
+template <typename T>
+long long DescomposicionDominiosT<T>::getParesEvaluados() const {
+    long long total = 0;
+    for (const Dominio& dominio : dominios) {
+        total += dominio.grilla.getParesEvaluados();
+    }
+    return total;
+}
+
+template <typename T>
+double DescomposicionDominiosT<T>::getDesbalance() const {
+    double maximo = 0.0;
+    double suma = 0.0;
+    for (const Dominio& dominio : dominios) {
+        maximo = max(maximo, dominio.segundosPaso);
+        suma += dominio.segundosPaso;
+    }
+    return suma > 0.0 ? maximo / (suma / getNumDominios()) : 1.0;
+}
+
+template <typename T>
+double DescomposicionDominiosT<T>::getSegundosDominio(int d) const {
+    return dominios[d].segundosTotal;
+}
+
+template <typename T>
+int DescomposicionDominiosT<T>::getParticulasDominio(int d) const {
+    return dominios[d].propias;
+}
+
+template <typename T>
+void DescomposicionDominiosT<T>::mostrarEstadisticas() const {
+    double total = 0.0;
+    for (const Dominio& dominio : dominios) total += dominio.segundosTotal;
+
+    cout << "DOMINIOS (" << getNumDominios() << " franjas, "
+         << rebalanceos << " rebalanceos):" << endl;
+    for (int d = 0; d < getNumDominios(); d++) {
+        const Dominio& dominio = dominios[d];
+        cout << "  • D" << d << " [" << fixed << setprecision(1) << dominio.desde << ", "
+             << dominio.hasta << "): " << dominio.propias << " partículas, "
+             << setprecision(2) << dominio.segundosTotal * 1000.0 << " ms ("
+             << setprecision(1) << (total > 0 ? 100.0 * dominio.segundosTotal / total : 0.0)
+             << "%)" << endl;
+    }
+}
+
+// --- Instancias ---
+template class DescomposicionDominiosT<float>;
+template class DescomposicionDominiosT<double>;
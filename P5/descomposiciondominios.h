@@ -0,0 +1,89 @@
+#ifndef DESCOMPOSICION_DOMINIOS_H
+#define DESCOMPOSICION_DOMINIOS_H
+
+#include <vector>
+#include <utility>
+#include "almacenparticulas.h"
+#include "grillaespacial.h"
+#include "poolhilos.h"
+
+/**
+ * @brief Fase de pares por dominios: franjas verticales con halo
+ *
+ * La caja [0, ancho] se parte en franjas, una por dominio. Cada dominio
+ * trabaja con sus partículas propias (por x) más copias fantasma de las
+ * vecinas a menos de un diámetro máximo del borde, así que resuelve sus
+ * pares sin leer el estado de otros dominios. Un par lo entrega solo el
+ * dominio dueño del menor de sus dos índices; la lista final se ordena y
+ * es la misma que la del barrido de una sola grilla.
+ *
+ * Los cortes se recalculan cuando el tiempo del dominio más lento supera
+ * en umbralDesbalance al promedio: cada partícula pesa lo que costó, en
+ * promedio, una partícula de su dominio en el último paso, y los cortes
+ * quedan en los cuantiles de ese peso a lo largo de x.
+ *
+ * Las copias locales usan el escalar T de las partículas (float o double).
+ */
+template <typename T>
+class DescomposicionDominiosT {
+private:
+    struct Dominio {
+        double desde;                          // Franja [desde, hasta) en x
+        double hasta;
+        int propias;                           // Las primeras 'propias' locales son del dominio
+        std::vector<int> globales;             // Índice en el almacén de cada local
+        std::vector<T> x, y, radio;            // Copia local (propias + fantasmas)
+        std::vector<unsigned char> activa;
+        GrillaEspacialT<T> grilla;
+        std::vector<std::pair<int, int>> contactos;      // Índices locales
+        std::vector<std::pair<int, int>> pares;          // Índices globales, solo los del dueño
+        double segundosPaso;
+        double segundosTotal;
+    };
+
+    std::vector<Dominio> dominios;
+    std::vector<int> duenoDe;                  // Dominio de cada partícula del almacén
+    std::vector<double> histograma;            // Trabajo de rebalancear
+    double ancho;
+    bool rebalanceoActivo;
+    double umbralDesbalance;
+    int pasosDesdeRebalanceo;
+    int rebalanceos;
+    bool cortesIniciales;
+
+public:
+    static constexpr int PASOS_MINIMOS_ENTRE_REBALANCEOS = 5;
+    static constexpr int CUBETAS_POR_DOMINIO = 64;
+
+    DescomposicionDominiosT(int numDominios, double ancho);
+
+    // Pares (i < j) en contacto entre partículas activas, ordenados
+    void obtenerParesEnContacto(const AlmacenParticulasT<T>& particulas, PoolHilos* pool,
+                                std::vector<std::pair<int, int>>& pares);
+
+    // --- Configuración ---
+    void setRebalanceo(bool activo, double umbral = 1.25);
+    void setIsa(IsaSimd isa);                  // Kernel de la fase fina de cada franja
+
+    // --- Estadísticas ---
+    int getNumDominios() const;
+    int getRebalanceos() const;
+    long long getParesEvaluados() const;
+    double getDesbalance() const;              // Máximo / promedio del último paso
+    double getSegundosDominio(int d) const;
+    int getParticulasDominio(int d) const;
+    void mostrarEstadisticas() const;
+
+private:
+    void repartirParticulas(const AlmacenParticulasT<T>& particulas);
+    void resolverDominio(Dominio& dominio);
+    void rebalancear(const AlmacenParticulasT<T>& particulas, bool porTiempo);
+    int dominioDe(double x) const;
+};
+
+using DescomposicionDominios = DescomposicionDominiosT<double>;
+
+extern template class DescomposicionDominiosT<float>;
+extern template class DescomposicionDominiosT<double>;
+
+#endif // DESCOMPOSICION_DOMINIOS_H
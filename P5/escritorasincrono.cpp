@@ -0,0 +1,110 @@
+#include "escritorasincrono.h"
+#include <chrono>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+EscritorAsincrono::EscritorAsincrono(EscritorTrayectorias* escritor, RegistroColisiones* registro,
+                                     PoliticaCola politica, int capacidad)
+    : escritor(escritor), registro(registro),
+    capacidad(capacidad < 1 ? 1 : capacidad), politica(politica),
+    escribiendo(false), terminar(false),
+    segundosBloqueado(0.0), framesDescartados(0), maximoEnCola(0) {
+    hilo = thread(&EscritorAsincrono::bucleEscritura, this);
+}
+
+EscritorAsincrono::~EscritorAsincrono() {
+    detener();
+}
+
+// --- Hilo de simulación ---
+void EscritorAsincrono::encolar(FrameTrayectoria& frame) {
+    auto inicio = chrono::steady_clock::now();
+    unique_lock<mutex> lock(cerrojo);
+
+    // Contrapresión: el frame en escritura también ocupa un buffer
+    auto ocupados = [this]() {
+        return static_cast<int>(pendientes.size()) + (escribiendo ? 1 : 0);
+    };
+
+    if (ocupados() >= capacidad) {
+        if (politica == PoliticaCola::BLOQUEAR) {
+            hayEspacio.wait(lock, [&]() { return ocupados() < capacidad; });
+        } else if (politica == PoliticaCola::DESCARTAR) {
+            // Las colisiones del paso pasan al frame más reciente de la cola
+            framesDescartados++;
+            if (!pendientes.empty()) {
+                vector<EventoColision>& destino = pendientes.back().eventos;
+                destino.insert(destino.end(), frame.eventos.begin(), frame.eventos.end());
+                frame.limpiar();
+                segundosBloqueado += chrono::duration<double>(
+                                         chrono::steady_clock::now() - inicio).count();
+                return;
+            }
+            // Sin frame pendiente (solo el que se escribe): se encola igual
+        }
+    }
+
+    // Intercambiar con un buffer reciclado: sin copias ni reservas
+    if (reciclados.empty()) {
+        reciclados.emplace_back();
+    }
+    pendientes.push_back(std::move(reciclados.back()));
+    reciclados.pop_back();
+    swap(pendientes.back(), frame);
+    frame.limpiar();
+
+    maximoEnCola = max(maximoEnCola, static_cast<int>(pendientes.size()));
+    segundosBloqueado += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    lock.unlock();
+    hayTrabajo.notify_one();
+}
+
+void EscritorAsincrono::detener() {
+    {
+        lock_guard<mutex> lock(cerrojo);
+        if (terminar) return;
+        terminar = true;
+    }
+    hayTrabajo.notify_one();
+    if (hilo.joinable()) hilo.join();
+}
+
+// --- Hilo escritor ---
+void EscritorAsincrono::bucleEscritura() {
+    unique_lock<mutex> lock(cerrojo);
+
+    while (true) {
+        hayTrabajo.wait(lock, [this]() { return terminar || !pendientes.empty(); });
+        if (pendientes.empty()) break;   // terminar y no queda nada
+
+        FrameTrayectoria actual = std::move(pendientes.front());
+        pendientes.pop_front();
+        escribiendo = true;
+        lock.unlock();
+
+        if (escritor) escritor->escribirFrame(actual);
+        if (registro) registro->escribir(actual.eventos);
+        actual.limpiar();
+
+        lock.lock();
+        escribiendo = false;
+        reciclados.push_back(std::move(actual));
+        hayEspacio.notify_one();
+    }
+}
+
+// --- Estadísticas ---
+double EscritorAsincrono::getSegundosBloqueado() const {
+    return segundosBloqueado;
+}
+
+long long EscritorAsincrono::getFramesDescartados() const {
+    return framesDescartados;
+}
+
+int EscritorAsincrono::getMaximoEnCola() const {
+    return maximoEnCola;
+}
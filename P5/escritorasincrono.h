@@ -0,0 +1,69 @@
+#ifndef ESCRITOR_ASINCRONO_H
+#define ESCRITOR_ASINCRONO_H
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "escritortrayectorias.h"
+
+enum class PoliticaCola {
+    BLOQUEAR,    // La simulación espera a que se libere un buffer
+    DESCARTAR,   // Se pierde el frame (las colisiones se conservan); con EVENTOS, BLOQUEAR
+    CRECER       // Se agregan buffers sin límite
+};
+
+/**
+ * @brief Hilo de escritura en segundo plano para la salida del simulador
+ *
+ * El hilo de simulación solo intercambia (swap) su frame con un buffer
+ * libre y sigue; el hilo escritor vacía la cola en orden hacia el escritor
+ * de trayectorias y el registro de colisiones. Con capacidad 2 funciona
+ * como doble buffer. Los buffers ya escritos se reciclan, así que en
+ * régimen estable no se reserva memoria.
+ */
+class EscritorAsincrono {
+private:
+    // --- Destinos (no son propiedad de esta clase) ---
+    EscritorTrayectorias* escritor;
+    RegistroColisiones* registro;
+
+    // --- Cola de frames ---
+    std::deque<FrameTrayectoria> pendientes;
+    std::vector<FrameTrayectoria> reciclados;
+    int capacidad;
+    PoliticaCola politica;
+
+    // --- Sincronización ---
+    std::thread hilo;
+    std::mutex cerrojo;
+    std::condition_variable hayTrabajo;
+    std::condition_variable hayEspacio;
+    bool escribiendo;
+    bool terminar;
+
+    // --- Estadísticas ---
+    double segundosBloqueado;      // Espera del hilo de simulación
+    long long framesDescartados;
+    int maximoEnCola;
+
+public:
+    EscritorAsincrono(EscritorTrayectorias* escritor, RegistroColisiones* registro,
+                      PoliticaCola politica, int capacidad);
+    ~EscritorAsincrono();
+
+    // --- Hilo de simulación ---
+    void encolar(FrameTrayectoria& frame);   // Deja 'frame' vacío para el próximo paso
+    void detener();                          // Escribe lo pendiente y termina el hilo
+
+    // --- Estadísticas ---
+    double getSegundosBloqueado() const;
+    long long getFramesDescartados() const;
+    int getMaximoEnCola() const;
+
+private:
+    void bucleEscritura();
+};
+
+#endif // ESCRITOR_ASINCRONO_H
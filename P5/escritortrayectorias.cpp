@@ -0,0 +1,232 @@
+#include "escritortrayectorias.h"
+#include "archivotrayectorias.h"
+#include "compresiontrayectorias.h"
+#include "eventostrayectorias.h"
+#include <iostream>
+#include <cstring>
+#include <charconv>
+
+using namespace std;
+
+void FrameTrayectoria::limpiarParticulas() {
+    id.clear();
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+}
+
+void FrameTrayectoria::limpiar() {
+    limpiarParticulas();
+    eventos.clear();
+}
+
+// ============================================================================
+// BUFFER DE TEXTO
+// ============================================================================
+
+void BufferTexto::agregar(double valor, int decimales) {
+    char texto[512];   // Suficiente para cualquier double en notación fija
+    auto resultado = to_chars(texto, texto + sizeof(texto), valor,
+                              chars_format::fixed, decimales);
+    datos.insert(datos.end(), texto, resultado.ptr);
+}
+
+void BufferTexto::agregar(int valor) {
+    char texto[16];
+    auto resultado = to_chars(texto, texto + sizeof(texto), valor);
+    datos.insert(datos.end(), texto, resultado.ptr);
+}
+
+void BufferTexto::agregar(const char* texto) {
+    datos.insert(datos.end(), texto, texto + strlen(texto));
+}
+
+void BufferTexto::agregar(char caracter) {
+    datos.push_back(caracter);
+}
+
+void BufferTexto::vaciarEn(ofstream& archivo) {
+    if (!datos.empty()) archivo.write(datos.data(), datos.size());
+    datos.clear();
+}
+
+// ============================================================================
+// REGISTRO DE COLISIONES: colisiones.txt
+// ============================================================================
+
+bool RegistroColisiones::abrir() {
+    archivo.open("colisiones.txt");
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir archivo de colisiones" << endl;
+        return false;
+    }
+    archivo << "# tiempo tipo id1 [id2]" << endl;
+    return true;
+}
+
+void RegistroColisiones::escribir(const vector<EventoColision>& eventos) {
+    if (!archivo.is_open()) return;
+
+    for (const EventoColision& e : eventos) {
+        buffer.agregar(e.tiempo, 3);
+        buffer.agregar(' ');
+        buffer.agregar(e.tipo);
+        buffer.agregar(' ');
+        buffer.agregar(e.id1);
+        if (e.id2 != -1) {
+            buffer.agregar(' ');
+            buffer.agregar(e.id2);
+        }
+        buffer.agregar('\n');
+    }
+    if (buffer.tamano() >= TAMANO_BUFFER) buffer.vaciarEn(archivo);
+}
+
+void RegistroColisiones::cerrar() {
+    if (!archivo.is_open()) return;
+    buffer.vaciarEn(archivo);
+    archivo.close();
+}
+
+// ============================================================================
+// CLASE BASE: EscritorTrayectorias
+// ============================================================================
+
+EscritorTrayectorias::EscritorTrayectorias() : bytesEscritos(0) {}
+
+long long EscritorTrayectorias::getBytesEscritos() const {
+    return bytesEscritos;
+}
+
+EscritorTrayectorias* EscritorTrayectorias::crear(FormatoSalida formato, double dt,
+                                                  double ancho, double alto,
+                                                  double precisionPosicion,
+                                                  double precisionVelocidad,
+                                                  bool precisionSimple) {
+    switch (formato) {
+    case FormatoSalida::BINARIO: return new EscritorBinario(dt, ancho, alto);
+    case FormatoSalida::ARCHIVO: return new EscritorArchivo(dt, ancho, alto);
+    case FormatoSalida::COMPRIMIDO:
+        return new EscritorComprimido(dt, ancho, alto, precisionPosicion, precisionVelocidad);
+    case FormatoSalida::EVENTOS: return new EscritorEventos(dt, ancho, alto, precisionSimple);
+    case FormatoSalida::TEXTO:
+    default: return new EscritorTexto();
+    }
+}
+
+// ============================================================================
+// TEXTO: trayectoria_<id>.txt
+// ============================================================================
+
+EscritorTexto::EscritorTexto() : EscritorTrayectorias() {}
+
+EscritorTexto::~EscritorTexto() {
+    cerrar();
+}
+
+bool EscritorTexto::abrir() {
+    // Los archivos se abren al aparecer cada id
+    return true;
+}
+
+void EscritorTexto::escribirFrame(const FrameTrayectoria& frame) {
+    for (int k = 0; k < frame.cantidad(); k++) {
+        int id = frame.id[k];
+
+        ArchivoTexto*& destino = archivos[id];
+        if (!destino) {
+            destino = new ArchivoTexto();
+            destino->archivo.open("trayectoria_" + to_string(id) + ".txt");
+        }
+
+        // "x y" con 3 decimales, igual que fixed << setprecision(3)
+        BufferTexto& buffer = destino->buffer;
+        buffer.agregar(frame.x[k], 3);
+        buffer.agregar(' ');
+        buffer.agregar(frame.y[k], 3);
+        buffer.agregar('\n');
+        if (buffer.tamano() >= TAMANO_BUFFER) buffer.vaciarEn(destino->archivo);
+    }
+}
+
+void EscritorTexto::cerrar() {
+    for (auto& par : archivos) {
+        if (par.second && par.second->archivo.is_open()) {
+            par.second->buffer.vaciarEn(par.second->archivo);
+            bytesEscritos += static_cast<long long>(par.second->archivo.tellp());
+            par.second->archivo.close();
+        }
+        delete par.second;
+    }
+    archivos.clear();
+}
+
+// ============================================================================
+// BINARIO: trayectorias.bin
+// ============================================================================
+
+EscritorBinario::EscritorBinario(double dt, double ancho, double alto)
+    : EscritorTrayectorias(), dt(dt), ancho(ancho), alto(alto) {
+    buffer.reserve(TAMANO_BUFFER);
+}
+
+EscritorBinario::~EscritorBinario() {
+    cerrar();
+}
+
+bool EscritorBinario::abrir() {
+    archivo.open("trayectorias.bin", ios::binary);
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir trayectorias.bin" << endl;
+        return false;
+    }
+
+    buffer.insert(buffer.end(), MAGIA, MAGIA + sizeof(MAGIA));
+    agregar(VERSION);
+    agregar(BYTES_POR_PARTICULA);
+    agregar(dt);
+    agregar(ancho);
+    agregar(alto);
+    return true;
+}
+
+void EscritorBinario::escribirFrame(const FrameTrayectoria& frame) {
+    if (!archivo.is_open()) return;
+
+    int32_t paso = frame.paso;
+    uint32_t cantidad = frame.cantidad();
+    agregar(paso);
+    agregar(frame.tiempo);
+    agregar(cantidad);
+
+    for (int k = 0; k < frame.cantidad(); k++) {
+        int32_t id = frame.id[k];
+        agregar(id);
+        agregar(frame.x[k]);
+        agregar(frame.y[k]);
+        agregar(frame.vx[k]);
+        agregar(frame.vy[k]);
+    }
+
+    if (buffer.size() >= TAMANO_BUFFER) vaciarBuffer();
+}
+
+void EscritorBinario::cerrar() {
+    if (!archivo.is_open()) return;
+    vaciarBuffer();
+    archivo.close();
+}
+
+template <typename T>
+void EscritorBinario::agregar(const T& valor) {
+    size_t inicio = buffer.size();
+    buffer.resize(inicio + sizeof(T));
+    memcpy(buffer.data() + inicio, &valor, sizeof(T));
+}
+
+void EscritorBinario::vaciarBuffer() {
+    archivo.write(buffer.data(), buffer.size());
+    bytesEscritos += buffer.size();
+    buffer.clear();
+}
@@ -0,0 +1,184 @@
+#ifndef ESCRITOR_TRAYECTORIAS_H
+#define ESCRITOR_TRAYECTORIAS_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+enum class FormatoSalida {
+    TEXTO,      // trayectoria_<id>.txt con líneas "x y" (lo lee graficar_trayectorias.py)
+    BINARIO,    // trayectorias.bin, un registro por paso
+    ARCHIVO,    // trayectorias.p5a, bloques con índice para acceso aleatorio
+    COMPRIMIDO, // trayectorias.p5z, cuantizado y con diferencias en varint
+    EVENTOS     // trayectorias.p5e, solo keyframes en rebotes y fusiones
+};
+
+/**
+ * @brief Colisión registrada durante un paso (una línea de colisiones.txt)
+ */
+struct EventoColision {
+    double tiempo;
+    const char* tipo;      // "PARED", "OBSTACULO", "FUSION" (literales)
+    int id1;
+    int id2;               // -1 si no aplica
+};
+
+/**
+ * @brief Estado de las partículas activas al final de un paso,
+ * junto con las colisiones registradas en ese paso
+ */
+struct FrameTrayectoria {
+    int paso = 0;
+    double tiempo = 0.0;
+    std::vector<int> id;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> vx;
+    std::vector<double> vy;
+    std::vector<EventoColision> eventos;
+
+    int cantidad() const { return static_cast<int>(id.size()); }
+    void limpiarParticulas();
+    void limpiar();
+};
+
+/**
+ * @brief Texto formateado con std::to_chars en un buffer reutilizable
+ *
+ * Produce los mismos bytes que "fixed << setprecision(d)", pero sin locale
+ * ni vaciado por línea: el dueño escribe el buffer al archivo en bloques.
+ */
+class BufferTexto {
+private:
+    std::vector<char> datos;
+
+public:
+    void agregar(double valor, int decimales);
+    void agregar(int valor);
+    void agregar(const char* texto);
+    void agregar(char caracter);
+
+    size_t tamano() const { return datos.size(); }
+    void vaciarEn(std::ofstream& archivo);
+};
+
+/**
+ * @brief Registro de colisiones en colisiones.txt ("tiempo tipo id1 [id2]")
+ */
+class RegistroColisiones {
+private:
+    std::ofstream archivo;
+    BufferTexto buffer;
+
+public:
+    static constexpr size_t TAMANO_BUFFER = 1 << 20;   // 1 MiB
+
+    bool abrir();
+    void escribir(const std::vector<EventoColision>& eventos);
+    void cerrar();
+};
+
+/**
+ * @brief Clase base abstracta para escribir las trayectorias de la simulación
+ */
+class EscritorTrayectorias {
+protected:
+    long long bytesEscritos;
+
+public:
+    EscritorTrayectorias();
+    virtual ~EscritorTrayectorias() = default;
+
+    virtual bool abrir() = 0;
+    virtual void escribirFrame(const FrameTrayectoria& frame) = 0;
+    virtual void cerrar() = 0;
+
+    long long getBytesEscritos() const;
+
+    // --- Fábrica según el formato elegido ---
+    // (las precisiones solo las usa COMPRIMIDO; precisionSimple, EVENTOS:
+    // el simulador integra en float y la predicción debe hacer lo mismo)
+    static EscritorTrayectorias* crear(FormatoSalida formato, double dt,
+                                       double ancho, double alto,
+                                       double precisionPosicion = 1e-3,
+                                       double precisionVelocidad = 1e-3,
+                                       bool precisionSimple = false);
+};
+
+/**
+ * @brief Formato de texto original: un archivo por partícula con "x y"
+ *
+ * Cada archivo acumula sus líneas en un BufferTexto y se escribe al pasar
+ * de TAMANO_BUFFER (y al cerrar).
+ */
+class EscritorTexto : public EscritorTrayectorias {
+private:
+    struct ArchivoTexto {
+        std::ofstream archivo;
+        BufferTexto buffer;
+    };
+    std::map<int, ArchivoTexto*> archivos;
+
+public:
+    static constexpr size_t TAMANO_BUFFER = 16 << 10;   // 16 KiB por archivo
+
+    EscritorTexto();
+    ~EscritorTexto() override;
+
+    bool abrir() override;
+    void escribirFrame(const FrameTrayectoria& frame) override;
+    void cerrar() override;
+};
+
+/**
+ * @brief Un solo archivo binario con un registro por paso (trayectorias.bin)
+ *
+ * Valores en el orden de bytes de la máquina (little-endian en x86 y ARM),
+ * sin relleno entre campos.
+ *
+ * Cabecera (40 bytes):
+ *   char[8]  magia              "P5TRAYB" + '\0'
+ *   uint32   version            1
+ *   uint32   bytesPorParticula  36
+ *   double   dt, ancho, alto
+ *
+ * Frame (16 bytes + 36 por partícula), uno por paso:
+ *   int32    paso
+ *   double   tiempo
+ *   uint32   cantidad
+ *   cantidad x { int32 id; double x, y, vx, vy; }
+ *
+ * Los frames se acumulan en un buffer grande y se escriben en bloques.
+ */
+class EscritorBinario : public EscritorTrayectorias {
+private:
+    std::ofstream archivo;
+    std::vector<char> buffer;
+    double dt;
+    double ancho;
+    double alto;
+
+public:
+    static constexpr char MAGIA[8] = {'P', '5', 'T', 'R', 'A', 'Y', 'B', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t BYTES_CABECERA = 40;
+    static constexpr uint32_t BYTES_FRAME = 16;
+    static constexpr uint32_t BYTES_POR_PARTICULA = 36;
+    static constexpr size_t TAMANO_BUFFER = 4 << 20;   // 4 MiB
+
+    EscritorBinario(double dt, double ancho, double alto);
+    ~EscritorBinario() override;
+
+    bool abrir() override;
+    void escribirFrame(const FrameTrayectoria& frame) override;
+    void cerrar() override;
+
+private:
+    template <typename T>
+    void agregar(const T& valor);
+    void vaciarBuffer();
+};
+
+#endif // ESCRITOR_TRAYECTORIAS_H
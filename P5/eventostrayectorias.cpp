@@ -0,0 +1,313 @@
+#include "eventostrayectorias.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+static_assert(sizeof(int) == sizeof(int32_t), "Los ids se guardan como int32");
+
+namespace {
+
+template <typename T>
+void agregarValor(vector<char>& buffer, const T& valor) {
+    size_t inicio = buffer.size();
+    buffer.resize(inicio + sizeof(T));
+    memcpy(buffer.data() + inicio, &valor, sizeof(T));
+}
+
+template <typename T>
+bool leerValor(ifstream& archivo, T& valor) {
+    return static_cast<bool>(archivo.read(reinterpret_cast<char*>(&valor), sizeof(T)));
+}
+
+// Igualdad exacta (distingue 0.0 de -0.0)
+bool mismosBits(double a, double b) {
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+} // namespace
+
+double avanzarBalistico(double x, double v, double dt) {
+    return x + v * dt;
+}
+
+float avanzarBalistico(float x, float v, float dt) {
+    return x + v * dt;
+}
+
+namespace {
+
+// Un paso con la precisión del simulador; los float vuelven exactos a double
+double avanzarCon(bool precisionSimple, double x, double v, double dt) {
+    if (precisionSimple) {
+        return avanzarBalistico(static_cast<float>(x), static_cast<float>(v),
+                                static_cast<float>(dt));
+    }
+    return avanzarBalistico(x, v, dt);
+}
+
+} // namespace
+
+// ============================================================================
+// ESCRITURA
+// ============================================================================
+
+EscritorEventos::EscritorEventos(double dt, double ancho, double alto, bool precisionSimple)
+    : EscritorTrayectorias(), pasoAnterior(-1), tiempoAnterior(0.0),
+    registroPendiente(false), precisionSimple(precisionSimple), dt(dt), ancho(ancho), alto(alto) {}
+
+EscritorEventos::~EscritorEventos() {
+    cerrar();
+}
+
+bool EscritorEventos::abrir() {
+    archivo.open("trayectorias.p5e", ios::binary);
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir trayectorias.p5e" << endl;
+        return false;
+    }
+
+    buffer.insert(buffer.end(), MAGIA, MAGIA + sizeof(MAGIA));
+    agregarValor(buffer, VERSION);
+    agregarValor(buffer, static_cast<uint32_t>(precisionSimple ? sizeof(float) : sizeof(double)));
+    agregarValor(buffer, dt);
+    agregarValor(buffer, ancho);
+    agregarValor(buffer, alto);
+    return true;
+}
+
+void EscritorEventos::escribirFrame(const FrameTrayectoria& frame) {
+    if (!archivo.is_open()) return;
+
+    bool primero = pasoAnterior < 0;
+    int pasos = primero ? 0 : frame.paso - pasoAnterior;
+    registro.paso = frame.paso;
+    registro.tiempo = frame.tiempo;
+    registro.keyframes.clear();
+    registro.finales.clear();
+
+    for (int k = 0; k < frame.cantidad(); k++) {
+        int id = frame.id[k];
+        if (id >= static_cast<int>(pasoVisto.size())) {
+            size_t n = id + 1;
+            x.resize(n); y.resize(n); vx.resize(n); vy.resize(n);
+            pasoVisto.resize(n, -1);
+        }
+
+        // Predicción balística desde el frame anterior
+        bool balistico = false;
+        if (!primero && pasoVisto[id] == pasoAnterior) {
+            double px = x[id];
+            double py = y[id];
+            for (int s = 0; s < pasos; s++) {
+                px = avanzarCon(precisionSimple, px, vx[id], dt);
+                py = avanzarCon(precisionSimple, py, vy[id], dt);
+            }
+            balistico = mismosBits(px, frame.x[k]) && mismosBits(py, frame.y[k]) &&
+                        mismosBits(vx[id], frame.vx[k]) && mismosBits(vy[id], frame.vy[k]);
+        }
+
+        x[id] = frame.x[k];
+        y[id] = frame.y[k];
+        vx[id] = frame.vx[k];
+        vy[id] = frame.vy[k];
+        pasoVisto[id] = frame.paso;
+
+        if (!balistico) {
+            registro.keyframes.push_back(
+                KeyframeParticula{id, frame.x[k], frame.y[k], frame.vx[k], frame.vy[k]});
+        }
+    }
+
+    // Ids del frame anterior que ya no están (absorbidos en una fusión)
+    for (int id : idsAnteriores) {
+        if (pasoVisto[id] != frame.paso) registro.finales.push_back(id);
+    }
+    idsAnteriores = frame.id;
+
+    pasoAnterior = frame.paso;
+    tiempoAnterior = frame.tiempo;
+    registroPendiente = !primero && registro.keyframes.empty() && registro.finales.empty();
+    if (!registroPendiente) escribirRegistro();
+}
+
+void EscritorEventos::escribirRegistro() {
+    agregarValor(buffer, registro.paso);
+    agregarValor(buffer, registro.tiempo);
+    agregarValor(buffer, static_cast<uint32_t>(registro.keyframes.size()));
+    agregarValor(buffer, static_cast<uint32_t>(registro.finales.size()));
+    for (const KeyframeParticula& k : registro.keyframes) {
+        agregarValor(buffer, k.id);
+        agregarValor(buffer, k.x);
+        agregarValor(buffer, k.y);
+        agregarValor(buffer, k.vx);
+        agregarValor(buffer, k.vy);
+    }
+    for (int32_t id : registro.finales) {
+        agregarValor(buffer, id);
+    }
+
+    if (buffer.size() >= BYTES_BUFFER) vaciarBuffer();
+}
+
+void EscritorEventos::vaciarBuffer() {
+    archivo.write(buffer.data(), buffer.size());
+    bytesEscritos += buffer.size();
+    buffer.clear();
+}
+
+void EscritorEventos::cerrar() {
+    if (!archivo.is_open()) return;
+
+    // Registro vacío del último paso: el lector sabe hasta dónde reconstruir
+    if (registroPendiente) {
+        registro.paso = pasoAnterior;
+        registro.tiempo = tiempoAnterior;
+        registro.keyframes.clear();
+        registro.finales.clear();
+        escribirRegistro();
+        registroPendiente = false;
+    }
+    vaciarBuffer();
+    archivo.close();
+}
+
+// ============================================================================
+// LECTURA
+// ============================================================================
+
+LectorEventos::LectorEventos()
+    : siguienteRegistro(0), pasoActual(-1), tiempoActual(0.0), precisionSimple(false),
+    dt(0), ancho(0), alto(0) {}
+
+bool LectorEventos::abrir(const string& ruta) {
+    cerrar();
+    ifstream archivo(ruta, ios::binary);
+    if (!archivo.is_open()) return false;
+
+    char magia[8];
+    uint32_t version;
+    uint32_t bytesEscalar;
+    if (!archivo.read(magia, sizeof(magia)) ||
+        memcmp(magia, EscritorEventos::MAGIA, 8) != 0 ||
+        !leerValor(archivo, version) || !leerValor(archivo, bytesEscalar) ||
+        !leerValor(archivo, dt) || !leerValor(archivo, ancho) || !leerValor(archivo, alto)) {
+        return false;
+    }
+    precisionSimple = bytesEscalar == sizeof(float);
+
+    RegistroEventos registro;
+    uint32_t numKeyframes;
+    uint32_t numFinales;
+    while (leerValor(archivo, registro.paso) && leerValor(archivo, registro.tiempo) &&
+           leerValor(archivo, numKeyframes) && leerValor(archivo, numFinales)) {
+        registro.keyframes.resize(numKeyframes);
+        for (KeyframeParticula& k : registro.keyframes) {
+            leerValor(archivo, k.id);
+            leerValor(archivo, k.x);
+            leerValor(archivo, k.y);
+            leerValor(archivo, k.vx);
+            leerValor(archivo, k.vy);
+        }
+        registro.finales.resize(numFinales);
+        for (int32_t& id : registro.finales) {
+            leerValor(archivo, id);
+        }
+        if (!archivo) break;    // Registro truncado
+        registros.push_back(registro);
+    }
+    return !registros.empty();
+}
+
+void LectorEventos::cerrar() {
+    registros.clear();
+    reiniciar();
+}
+
+int LectorEventos::getPasoInicial() const {
+    return registros.empty() ? -1 : registros.front().paso;
+}
+
+int LectorEventos::getPasoFinal() const {
+    return registros.empty() ? -1 : registros.back().paso;
+}
+
+int LectorEventos::numeroRegistros() const {
+    return registros.size();
+}
+
+void LectorEventos::reiniciar() {
+    siguienteRegistro = 0;
+    pasoActual = -1;
+    tiempoActual = 0.0;
+    x.clear(); y.clear(); vx.clear(); vy.clear();
+    vivos.clear();
+}
+
+void LectorEventos::aplicar(const RegistroEventos& registro) {
+    for (int32_t id : registro.finales) {
+        auto it = lower_bound(vivos.begin(), vivos.end(), id);
+        if (it != vivos.end() && *it == id) vivos.erase(it);
+    }
+
+    for (const KeyframeParticula& k : registro.keyframes) {
+        if (k.id >= static_cast<int>(x.size())) {
+            size_t n = k.id + 1;
+            x.resize(n); y.resize(n); vx.resize(n); vy.resize(n);
+        }
+        x[k.id] = k.x;
+        y[k.id] = k.y;
+        vx[k.id] = k.vx;
+        vy[k.id] = k.vy;
+
+        auto it = lower_bound(vivos.begin(), vivos.end(), k.id);
+        if (it == vivos.end() || *it != k.id) vivos.insert(it, k.id);
+    }
+    tiempoActual = registro.tiempo;
+}
+
+bool LectorEventos::estadoEnPaso(int paso, FrameTrayectoria& frame) {
+    if (registros.empty() || paso < getPasoInicial() || paso > getPasoFinal()) return false;
+
+    if (pasoActual < 0 || paso < pasoActual) {
+        reiniciar();
+        aplicar(registros[0]);
+        pasoActual = registros[0].paso;
+        siguienteRegistro = 1;
+    }
+
+    // Segmentos balísticos hasta el paso pedido, con los keyframes en su paso
+    while (pasoActual < paso) {
+        pasoActual++;
+        tiempoActual += dt;
+        for (int id : vivos) {
+            x[id] = avanzarCon(precisionSimple, x[id], vx[id], dt);
+            y[id] = avanzarCon(precisionSimple, y[id], vy[id], dt);
+        }
+        if (siguienteRegistro < registros.size() &&
+            registros[siguienteRegistro].paso == pasoActual) {
+            aplicar(registros[siguienteRegistro++]);
+        }
+    }
+
+    frame.limpiar();
+    frame.paso = pasoActual;
+    frame.tiempo = tiempoActual;
+    for (int id : vivos) {
+        frame.id.push_back(id);
+        frame.x.push_back(x[id]);
+        frame.y.push_back(y[id]);
+        frame.vx.push_back(vx[id]);
+        frame.vy.push_back(vy[id]);
+    }
+    return true;
+}
+
+bool LectorEventos::estadoEnTiempo(double tiempo, FrameTrayectoria& frame) {
+    if (registros.empty() || dt <= 0) return false;
+    long long paso = llround(tiempo / dt);
+    paso = max<long long>(getPasoInicial(), min<long long>(getPasoFinal(), paso));
+    return estadoEnPaso(static_cast<int>(paso), frame);
+}
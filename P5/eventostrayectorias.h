@@ -0,0 +1,137 @@
+#ifndef EVENTOS_TRAYECTORIAS_H
+#define EVENTOS_TRAYECTORIAS_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include "escritortrayectorias.h"
+
+/**
+ * @brief Avance balístico de un paso: x + v * dt
+ *
+ * Escritor y lector predicen con esta misma función, así la reconstrucción
+ * reproduce bit a bit los valores que se compararon al escribir. La versión
+ * float es la cuenta de Simulador<float>: predecir en double no coincidiría
+ * nunca con lo que integró y cada paso sería un keyframe.
+ */
+double avanzarBalistico(double x, double v, double dt);
+float avanzarBalistico(float x, float v, float dt);
+
+/**
+ * @brief Estado de una partícula en un keyframe
+ */
+struct KeyframeParticula {
+    int32_t id;
+    double x, y, vx, vy;
+};
+
+/**
+ * @brief Cambios de un paso: keyframes y partículas que desaparecen
+ */
+struct RegistroEventos {
+    int32_t paso;
+    double tiempo;
+    std::vector<KeyframeParticula> keyframes;
+    std::vector<int32_t> finales;
+};
+
+/**
+ * @brief Trayectorias guardadas solo en los eventos (trayectorias.p5e)
+ *
+ * Entre colisiones una partícula avanza en línea recta (r += v*dt), así que
+ * basta con el estado inicial y un keyframe cada vez que el movimiento deja
+ * de ser balístico: rebote en pared u obstáculo, o partícula nueva por fusión.
+ * El escritor predice cada paso con avanzarBalistico() y guarda un keyframe
+ * solo si el estado real difiere en algún bit; el tamaño crece con el número
+ * de eventos y no con N * pasos. La exactitud necesita todos los frames:
+ * con salida asíncrona el simulador usa BLOQUEAR aunque se pida DESCARTAR.
+ *
+ * Cabecera (40 bytes): char[8] "P5EVENT" + '\0'; uint32 version (1);
+ *   uint32 bytesEscalar (4: se predice en float; 8 o 0: en double);
+ *   double dt, ancho, alto
+ *
+ * Registro (solo los pasos con cambios, y siempre el primero y el último):
+ *   int32 paso; double tiempo; uint32 numKeyframes; uint32 numFinales;
+ *   numKeyframes x {int32 id; double x, y, vx, vy}; numFinales x int32 id
+ */
+class EscritorEventos : public EscritorTrayectorias {
+private:
+    std::ofstream archivo;
+    std::vector<char> buffer;
+    RegistroEventos registro;          // Cambios del paso en curso
+
+    // Estado predicho por id
+    std::vector<double> x, y, vx, vy;
+    std::vector<int> pasoVisto;        // Último paso en que apareció el id (-1: nunca)
+    std::vector<int> idsAnteriores;
+    int pasoAnterior;
+    double tiempoAnterior;
+    bool registroPendiente;            // El último paso no quedó escrito
+    bool precisionSimple;              // El simulador integra en float
+    double dt;
+    double ancho;
+    double alto;
+
+public:
+    static constexpr char MAGIA[8] = {'P', '5', 'E', 'V', 'E', 'N', 'T', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t BYTES_CABECERA = 40;
+    static constexpr size_t BYTES_BUFFER = 1 << 20;
+
+    EscritorEventos(double dt, double ancho, double alto, bool precisionSimple = false);
+    ~EscritorEventos() override;
+
+    bool abrir() override;
+    void escribirFrame(const FrameTrayectoria& frame) override;
+    void cerrar() override;
+
+private:
+    void escribirRegistro();
+    void vaciarBuffer();
+};
+
+/**
+ * @brief Reconstrucción de trayectorias.p5e en cualquier paso
+ *
+ * Carga los registros (O(eventos)) y reproduce los segmentos balísticos
+ * desde el keyframe anterior. Avanzar hacia adelante es incremental; pedir
+ * un paso anterior vuelve a empezar desde el primer registro. Las
+ * partículas del frame reconstruido quedan ordenadas por id.
+ */
+class LectorEventos {
+private:
+    std::vector<RegistroEventos> registros;
+    size_t siguienteRegistro;
+    int pasoActual;                    // Paso del estado reconstruido (-1: ninguno)
+    double tiempoActual;
+    std::vector<double> x, y, vx, vy;
+    std::vector<int> vivos;            // Ids presentes, ordenados
+    bool precisionSimple;
+    double dt;
+    double ancho;
+    double alto;
+
+public:
+    LectorEventos();
+
+    bool abrir(const std::string& ruta);
+    void cerrar();
+
+    int getPasoInicial() const;
+    int getPasoFinal() const;
+    int numeroRegistros() const;
+
+    bool estadoEnPaso(int paso, FrameTrayectoria& frame);
+    bool estadoEnTiempo(double tiempo, FrameTrayectoria& frame);   // Paso más cercano a t
+
+    double getDt() const { return dt; }
+    double getAncho() const { return ancho; }
+    double getAlto() const { return alto; }
+
+private:
+    void reiniciar();
+    void aplicar(const RegistroEventos& registro);
+};
+
+#endif // EVENTOS_TRAYECTORIAS_H
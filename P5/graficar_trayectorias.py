@@ -1,23 +1,51 @@
 import matplotlib.pyplot as plt
 import glob
+import os
+import struct
+
+def leer_binario(ruta):
+    # Formato descrito en escritortrayectorias.h (EscritorBinario)
+    trayectorias = {}
+    with open(ruta, 'rb') as f:
+        datos = f.read()
+    if datos[:8] != b"P5TRAYB\0":
+        print("trayectorias.bin no tiene la cabecera esperada.")
+        return trayectorias
+    pos = 40
+    while pos + 16 <= len(datos):
+        _paso, _tiempo, cantidad = struct.unpack_from("<idI", datos, pos)
+        pos += 16
+        for _ in range(cantidad):
+            pid, x, y, _vx, _vy = struct.unpack_from("<idddd", datos, pos)
+            pos += 36
+            xs, ys = trayectorias.setdefault(pid, ([], []))
+            xs.append(x)
+            ys.append(y)
+    return trayectorias
 
 def graficar_trayectorias():
-    archivos = sorted(glob.glob("trayectoria_*.txt"))
+    if os.path.exists("trayectorias.bin"):
+        trayectorias = leer_binario("trayectorias.bin")
+    else:
+        trayectorias = {}
+        for archivo in sorted(glob.glob("trayectoria_*.txt")):
+            x, y = [], []
+            with open(archivo, 'r') as f:
+                for linea in f:
+                    partes = linea.strip().split()
+                    if len(partes) == 2:
+                        x.append(float(partes[0]))
+                        y.append(float(partes[1]))
+            trayectorias[int(archivo[len("trayectoria_"):-len(".txt")])] = (x, y)
 
-    if not archivos:
+    if not trayectorias:
         print("No se encontraron archivos de trayectoria.")
         return
 
     plt.figure(figsize=(8, 6))
-    for archivo in archivos:
-        x, y = [], []
-        with open(archivo, 'r') as f:
-            for linea in f:
-                partes = linea.strip().split()
-                if len(partes) == 2:
-                    x.append(float(partes[0]))
-                    y.append(float(partes[1]))
-        plt.plot(x, y, label=archivo.replace(".txt", ""))
+    for pid in sorted(trayectorias):
+        x, y = trayectorias[pid]
+        plt.plot(x, y, label="trayectoria_" + str(pid))
 
     plt.title("Trayectorias de las partículas")
     plt.xlabel("Posición X")
@@ -0,0 +1,282 @@
+#include "grillaespacial.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+template <typename T>
+GrillaEspacialT<T>::GrillaEspacialT()
+    : minX(0.0), minY(0.0), tamCelda(1.0), columnas(1), filas(1),
+    kernels(&kernelsPara<T>(mejorIsaDisponible())), paresEvaluados(0) {}
+
+// --- Construcción ---
+template <typename T>
+void GrillaEspacialT<T>::construir(const AlmacenParticulasT<T>& particulas) {
+    construir(particulas.x.data(), particulas.y.data(), particulas.radio.data(),
+              particulas.activa.data(), particulas.tamano());
+}
+
+template <typename T>
+void GrillaEspacialT<T>::construir(const vector<ParticulaT<T>*>& particulas) {
+    int n = particulas.size();
+    tmpX.resize(n);
+    tmpY.resize(n);
+    tmpRadio.resize(n);
+    tmpActiva.resize(n);
+    for (int i = 0; i < n; i++) {
+        VectorT<T> pos = particulas[i]->getPosicion();
+        tmpX[i] = pos.getX();
+        tmpY[i] = pos.getY();
+        tmpRadio[i] = particulas[i]->getRadio();
+        tmpActiva[i] = particulas[i]->estaActiva() ? 1 : 0;
+    }
+    construir(tmpX.data(), tmpY.data(), tmpRadio.data(), tmpActiva.data(), n);
+}
+
+template <typename T>
+void GrillaEspacialT<T>::construir(const T* x, const T* y, const T* radio,
+                                   const unsigned char* activa, int n) {
+    celdaDe.assign(n, -1);
+
+    // Caja envolvente y radio máximo de las partículas activas
+    T x0 = 0, y0 = 0, x1 = 0, y1 = 0, radioMaximo = 0;
+    bool primera = true;
+    for (int i = 0; i < n; i++) {
+        if (!activa[i]) continue;
+        if (primera) {
+            x0 = x1 = x[i];
+            y0 = y1 = y[i];
+            primera = false;
+        }
+        x0 = min(x0, x[i]);
+        x1 = max(x1, x[i]);
+        y0 = min(y0, y[i]);
+        y1 = max(y1, y[i]);
+        radioMaximo = max(radioMaximo, radio[i]);
+    }
+    prepararCeldas(x0, y0, x1, y1, radioMaximo, n);
+
+    // Ordenamiento por conteo: contar, acumular y repartir
+    for (int i = 0; i < n; i++) {
+        if (!activa[i]) continue;
+        celdaDe[i] = celdaDePosicion(x[i], y[i]);
+        inicioCelda[celdaDe[i] + 1]++;
+    }
+    for (size_t c = 1; c < inicioCelda.size(); c++) {
+        inicioCelda[c] += inicioCelda[c - 1];
+    }
+
+    int total = inicioCelda.back();
+    indices.assign(total, 0);
+    ordenX.resize(total);
+    ordenY.resize(total);
+    ordenRadio.resize(total);
+    cursor.assign(inicioCelda.begin(), inicioCelda.end() - 1);
+    for (int i = 0; i < n; i++) {
+        if (celdaDe[i] >= 0) {
+            int k = cursor[celdaDe[i]]++;
+            indices[k] = i;
+            ordenX[k] = x[i];
+            ordenY[k] = y[i];
+            ordenRadio[k] = radio[i];
+        }
+    }
+}
+
+template <typename T>
+void GrillaEspacialT<T>::prepararCeldas(double x0, double y0, double x1, double y1,
+                                    double radioMaximo, int n) {
+    minX = x0;
+    minY = y0;
+
+    // Celda = diámetro máximo, sin superar ~4 celdas por partícula
+    double anchoCaja = max(x1 - x0, 1e-9);
+    double altoCaja = max(y1 - y0, 1e-9);
+    tamCelda = max(2.0 * radioMaximo, 1e-9);
+    double celdasMaximas = 4.0 * n + 64.0;
+    if ((anchoCaja / tamCelda) * (altoCaja / tamCelda) > celdasMaximas) {
+        tamCelda = sqrt(anchoCaja * altoCaja / celdasMaximas);
+    }
+
+    columnas = static_cast<int>(anchoCaja / tamCelda) + 1;
+    filas = static_cast<int>(altoCaja / tamCelda) + 1;
+    inicioCelda.assign(static_cast<size_t>(columnas) * filas + 1, 0);
+}
+
+template <typename T>
+int GrillaEspacialT<T>::celdaDePosicion(double x, double y) const {
+    int cx = static_cast<int>((x - minX) / tamCelda);
+    int cy = static_cast<int>((y - minY) / tamCelda);
+    cx = max(0, min(columnas - 1, cx));
+    cy = max(0, min(filas - 1, cy));
+    return cy * columnas + cx;
+}
+
+// --- Pares candidatos ---
+template <typename T>
+void GrillaEspacialT<T>::obtenerParesCandidatos(vector<pair<int, int>>& pares, PoolHilos* pool) {
+    pares.clear();
+    int n = celdaDe.size();
+
+    if (!pool || pool->getNumHilos() == 1) {
+        paresEnRango(0, n, pares, vecinos);
+    } else {
+        // Un bloque de partículas por tarea; los resultados se unen en orden
+        const int tamBloque = 2048;
+        int numBloques = PoolHilos::numeroBloques(n, tamBloque);
+        paresPorBloque.resize(max<size_t>(paresPorBloque.size(), numBloques));
+        vecinosPorBloque.resize(max<size_t>(vecinosPorBloque.size(), numBloques));
+
+        pool->paraCada(n, tamBloque, [this](int inicio, int fin, int bloque) {
+            paresPorBloque[bloque].clear();
+            paresEnRango(inicio, fin, paresPorBloque[bloque], vecinosPorBloque[bloque]);
+        });
+        unirBloques(numBloques, pares);
+    }
+
+    paresEvaluados += pares.size();
+}
+
+template <typename T>
+void GrillaEspacialT<T>::unirBloques(int numBloques, vector<pair<int, int>>& pares) {
+    size_t total = 0;
+    for (int b = 0; b < numBloques; b++) total += paresPorBloque[b].size();
+    pares.reserve(total);
+    for (int b = 0; b < numBloques; b++) {
+        pares.insert(pares.end(), paresPorBloque[b].begin(), paresPorBloque[b].end());
+    }
+}
+
+template <typename T>
+void GrillaEspacialT<T>::paresEnRango(int desde, int hasta, vector<pair<int, int>>& pares,
+                                  vector<int>& candidatos) const {
+    for (int i = desde; i < hasta; i++) {
+        if (celdaDe[i] < 0) continue;
+        int cx = celdaDe[i] % columnas;
+        int cy = celdaDe[i] / columnas;
+
+        candidatos.clear();
+        for (int fy = max(0, cy - 1); fy <= min(filas - 1, cy + 1); fy++) {
+            for (int fx = max(0, cx - 1); fx <= min(columnas - 1, cx + 1); fx++) {
+                int c = fy * columnas + fx;
+                for (int k = inicioCelda[c]; k < inicioCelda[c + 1]; k++) {
+                    if (indices[k] > i) candidatos.push_back(indices[k]);
+                }
+            }
+        }
+
+        // Mismo orden que el barrido i < j original
+        sort(candidatos.begin(), candidatos.end());
+        for (int j : candidatos) {
+            pares.emplace_back(i, j);
+        }
+    }
+}
+
+// --- Pares en contacto ---
+template <typename T>
+void GrillaEspacialT<T>::obtenerParesEnContacto(vector<pair<int, int>>& pares, PoolHilos* pool) {
+    pares.clear();
+    int n = indices.size();
+    long long pruebas = 0;
+
+    // Se recorre en orden de celda (memoria contigua) y al final se ordena
+    // la lista compacta, que es mucho más corta que la de candidatos
+    if (!pool || pool->getNumHilos() == 1) {
+        pruebas = contactosEnRango(0, n, pares, vecinos);
+    } else {
+        const int tamBloque = 2048;
+        int numBloques = PoolHilos::numeroBloques(n, tamBloque);
+        paresPorBloque.resize(max<size_t>(paresPorBloque.size(), numBloques));
+        vecinosPorBloque.resize(max<size_t>(vecinosPorBloque.size(), numBloques));
+        pruebasPorBloque.assign(numBloques, 0);
+
+        pool->paraCada(n, tamBloque, [this](int inicio, int fin, int bloque) {
+            paresPorBloque[bloque].clear();
+            pruebasPorBloque[bloque] = contactosEnRango(inicio, fin, paresPorBloque[bloque],
+                                                        vecinosPorBloque[bloque]);
+        });
+        unirBloques(numBloques, pares);
+        for (int b = 0; b < numBloques; b++) pruebas += pruebasPorBloque[b];
+    }
+    sort(pares.begin(), pares.end());
+
+    // Cada partícula prueba su vecindario completo (ella incluida); como la
+    // vecindad es simétrica, cada par i < j se cuenta dos veces
+    paresEvaluados += pruebas / 2;
+}
+
+template <typename T>
+long long GrillaEspacialT<T>::contactosEnRango(int desde, int hasta, vector<pair<int, int>>& pares,
+                                           vector<int>& solapados) const {
+    // [desde, hasta) son posiciones en 'indices', no índices de partícula
+    long long pruebas = 0;
+    int c = upper_bound(inicioCelda.begin(), inicioCelda.end(), desde) - inicioCelda.begin() - 1;
+    int celdaFilas = -1;
+    int numFilas = 0;
+    int inicioFila[3], finFila[3];
+    int vecindario = 0;
+
+    for (int k = desde; k < hasta; k++) {
+        while (inicioCelda[c + 1] <= k) c++;
+
+        // Las tres celdas de cada fila del vecindario son un tramo contiguo
+        if (c != celdaFilas) {
+            celdaFilas = c;
+            int cx = c % columnas;
+            int cy = c / columnas;
+            int fx0 = max(0, cx - 1);
+            int fx1 = min(columnas - 1, cx + 1);
+            numFilas = 0;
+            vecindario = 0;
+            for (int fy = max(0, cy - 1); fy <= min(filas - 1, cy + 1); fy++) {
+                inicioFila[numFilas] = inicioCelda[fy * columnas + fx0];
+                finFila[numFilas] = inicioCelda[fy * columnas + fx1 + 1];
+                vecindario += finFila[numFilas] - inicioFila[numFilas];
+                numFilas++;
+            }
+            if (static_cast<int>(solapados.size()) < vecindario) solapados.resize(vecindario);
+        }
+        pruebas += vecindario - 1;
+
+        int m = 0;
+        for (int f = 0; f < numFilas; f++) {
+            m += kernels->solapados(ordenX[k], ordenY[k], ordenRadio[k],
+                                    ordenX.data(), ordenY.data(), ordenRadio.data(),
+                                    inicioFila[f], finFila[f], solapados.data() + m);
+        }
+
+        // Posición -> índice; solo j > i (también descarta a la propia i)
+        int i = indices[k];
+        for (int t = 0; t < m; t++) {
+            int j = indices[solapados[t]];
+            if (j > i) pares.emplace_back(i, j);
+        }
+    }
+    return pruebas;
+}
+
+template <typename T>
+void GrillaEspacialT<T>::setIsa(IsaSimd isa) {
+    kernels = &kernelsPara<T>(isa);
+}
+
+// --- Estadísticas ---
+template <typename T>
+long long GrillaEspacialT<T>::getParesEvaluados() const {
+    return paresEvaluados;
+}
+
+template <typename T>
+void GrillaEspacialT<T>::resetEstadisticas() {
+    paresEvaluados = 0;
+}
+
+template <typename T>
+int GrillaEspacialT<T>::getNumeroCeldas() const {
+    return columnas * filas;
+}
+
+// --- Instancias ---
+template class GrillaEspacialT<float>;
+template class GrillaEspacialT<double>;
@@ -0,0 +1,99 @@
+#ifndef GRILLA_ESPACIAL_H
+#define GRILLA_ESPACIAL_H
+
+#include <vector>
+#include <utility>
+#include "particula.h"
+#include "almacenparticulas.h"
+#include "poolhilos.h"
+#include "kernelsparticulas.h"
+
+/**
+ * @brief Broadphase de grilla uniforme para colisiones entre partículas
+ *
+ * Se reconstruye en cada paso a partir de las posiciones. El tamaño de
+ * celda es el diámetro máximo, así que dos partículas que se tocan siempre
+ * están en la misma celda o en celdas vecinas (vecindario 3x3).
+ * Los pares candidatos se entregan ordenados (i < j, lexicográfico),
+ * igual que el barrido O(N²) original. Con un PoolHilos la consulta se
+ * reparte por bloques de partículas y los bloques se unen en orden, así
+ * que la lista es idéntica a la serial.
+ *
+ * obtenerParesEnContacto hace además la fase fina: las posiciones y radios
+ * se copian ordenados por celda, así que las tres celdas de cada fila del
+ * vecindario son un tramo contiguo y cada partícula se prueba contra el
+ * tramo entero con el kernel SIMD de distancias al cuadrado. El recorrido
+ * va en orden de celda y solo la lista final (corta) se ordena.
+ *
+ * T es el escalar de las partículas (float o double); la geometría de la
+ * grilla se calcula siempre en double. GrillaEspacial es la versión en double.
+ */
+template <typename T>
+class GrillaEspacialT {
+private:
+    // --- Geometría de la grilla ---
+    double minX;
+    double minY;
+    double tamCelda;
+    int columnas;
+    int filas;
+
+    // --- Celdas (ordenamiento por conteo) ---
+    std::vector<int> inicioCelda;   // Inicio de cada celda en 'indices'
+    std::vector<int> indices;       // Índices de partículas agrupados por celda
+    std::vector<int> celdaDe;       // Celda de cada partícula (-1 si inactiva)
+    std::vector<T> ordenX, ordenY, ordenRadio;   // Copias en el orden de 'indices'
+    std::vector<int> cursor;        // Trabajo del reparto por celdas
+    std::vector<int> vecinos;       // Trabajo de obtenerParesCandidatos
+    std::vector<std::vector<std::pair<int, int>>> paresPorBloque;   // Consulta en paralelo
+    std::vector<std::vector<int>> vecinosPorBloque;
+    std::vector<long long> pruebasPorBloque;
+    const KernelsParticulasT<T>* kernels;   // Fase fina por lotes
+
+    // --- Copia de trabajo para construir desde Particula* ---
+    std::vector<T> tmpX, tmpY, tmpRadio;
+    std::vector<unsigned char> tmpActiva;
+
+    // --- Estadísticas ---
+    long long paresEvaluados;       // Pares entregados a la fase fina
+
+public:
+    GrillaEspacialT();
+
+    // --- Construcción ---
+    void construir(const AlmacenParticulasT<T>& particulas);
+    void construir(const std::vector<ParticulaT<T>*>& particulas);
+    void construir(const T* x, const T* y, const T* radio,
+                   const unsigned char* activa, int n);
+
+    // --- Consulta de pares candidatos (celdas vecinas, i < j) ---
+    void obtenerParesCandidatos(std::vector<std::pair<int, int>>& pares,
+                                PoolHilos* pool = nullptr);
+
+    // --- Pares en contacto (fase fina incluida, i < j, mismo orden) ---
+    void obtenerParesEnContacto(std::vector<std::pair<int, int>>& pares,
+                                PoolHilos* pool = nullptr);
+    void setIsa(IsaSimd isa);
+
+    // --- Estadísticas ---
+    long long getParesEvaluados() const;
+    void resetEstadisticas();
+    int getNumeroCeldas() const;
+
+private:
+    void prepararCeldas(double minX, double minY, double maxX, double maxY,
+                        double radioMaximo, int n);
+    int celdaDePosicion(double x, double y) const;
+    void paresEnRango(int desde, int hasta, std::vector<std::pair<int, int>>& pares,
+                      std::vector<int>& candidatos) const;
+    long long contactosEnRango(int desde, int hasta, std::vector<std::pair<int, int>>& pares,
+                               std::vector<int>& solapados) const;
+    void unirBloques(int numBloques, std::vector<std::pair<int, int>>& pares);
+};
+
+using GrillaEspacial = GrillaEspacialT<double>;
+
+extern template class GrillaEspacialT<float>;
+extern template class GrillaEspacialT<double>;
+
+#endif // GRILLA_ESPACIAL_H
@@ -0,0 +1,248 @@
+#include "grillajerarquica.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+template <typename T>
+GrillaJerarquicaT<T>::GrillaJerarquicaT()
+    : minX(0.0), minY(0.0), x(nullptr), y(nullptr), radio(nullptr), numParticulas(0),
+    kernels(&kernelsPara<T>(mejorIsaDisponible())), paresEvaluados(0) {}
+
+// --- Construcción ---
+template <typename T>
+void GrillaJerarquicaT<T>::construir(const AlmacenParticulasT<T>& particulas) {
+    construir(particulas.x.data(), particulas.y.data(), particulas.radio.data(),
+              particulas.activa.data(), particulas.tamano());
+}
+
+template <typename T>
+void GrillaJerarquicaT<T>::construir(const T* px, const T* py, const T* pradio,
+                                     const unsigned char* activa, int n) {
+    x = px;
+    y = py;
+    radio = pradio;
+    numParticulas = n;
+    nivelDe.assign(n, -1);
+    celdaDe.assign(n, -1);
+
+    // Caja envolvente y radios extremos de las activas
+    double x0 = 0, y0 = 0, x1 = 0, y1 = 0, radioMinimo = 0, radioMaximo = 0;
+    bool primera = true;
+    for (int i = 0; i < n; i++) {
+        if (!activa[i]) continue;
+        if (primera) {
+            x0 = x1 = x[i];
+            y0 = y1 = y[i];
+            radioMinimo = radioMaximo = radio[i];
+            primera = false;
+        }
+        x0 = min(x0, static_cast<double>(x[i]));
+        x1 = max(x1, static_cast<double>(x[i]));
+        y0 = min(y0, static_cast<double>(y[i]));
+        y1 = max(y1, static_cast<double>(y[i]));
+        radioMinimo = min(radioMinimo, static_cast<double>(radio[i]));
+        radioMaximo = max(radioMaximo, static_cast<double>(radio[i]));
+    }
+    minX = x0;
+    minY = y0;
+
+    // Celdas de arriba hacia abajo: la mayor es el diámetro máximo y cada
+    // nivel la divide a la mitad mientras quepa alguna partícula (diámetro
+    // mínimo). Ningún nivel, tampoco el superior, pasa de ~4 celdas por
+    // partícula (la misma cota que GrillaEspacial): con radios chicos en una
+    // caja grande el superior crece hasta la cota y queda un solo nivel.
+    // Con radios parecidos también queda uno solo: la grilla única
+    double anchoCaja = max(x1 - x0, 1e-9);
+    double altoCaja = max(y1 - y0, 1e-9);
+    double celdaCota = sqrt(anchoCaja * altoCaja / (4.0 * n + 64.0));
+    double celdaMinima = max(celdaCota, 2.0 * radioMinimo);
+    double celdaSuperior = max({2.0 * radioMaximo, celdaCota, 1e-9});
+    double tamCelda = celdaSuperior;
+    int numNiveles = 1;
+    while (numNiveles < MAX_NIVELES && tamCelda / 2 >= celdaMinima) {
+        tamCelda /= 2;
+        numNiveles++;
+    }
+
+    niveles.resize(numNiveles);
+    for (int L = 0; L < numNiveles; L++) {
+        Nivel& nivel = niveles[L];
+        nivel.tamCelda = (L == numNiveles - 1) ? celdaSuperior : tamCelda * pow(2.0, L);
+        nivel.columnas = static_cast<int>(anchoCaja / nivel.tamCelda) + 1;
+        nivel.filas = static_cast<int>(altoCaja / nivel.tamCelda) + 1;
+        nivel.inicioCelda.assign(static_cast<size_t>(nivel.columnas) * nivel.filas + 1, 0);
+    }
+
+    // Nivel y celda de cada partícula; conteo por celda
+    for (int i = 0; i < n; i++) {
+        if (!activa[i]) continue;
+        int L = 0;
+        while (L < numNiveles - 1 && niveles[L].tamCelda < 2.0 * radio[i]) L++;
+        nivelDe[i] = static_cast<signed char>(L);
+        celdaDe[i] = celdaEn(niveles[L], x[i], y[i]);
+        niveles[L].inicioCelda[celdaDe[i] + 1]++;
+    }
+
+    // Ordenamiento por conteo en cada nivel; las posiciones de todos los
+    // niveles seguidas forman el rango que se reparte en la consulta
+    inicioNivel.assign(numNiveles + 1, 0);
+    for (int L = 0; L < numNiveles; L++) {
+        Nivel& nivel = niveles[L];
+        for (size_t c = 1; c < nivel.inicioCelda.size(); c++) {
+            nivel.inicioCelda[c] += nivel.inicioCelda[c - 1];
+        }
+        int total = nivel.inicioCelda.back();
+        nivel.indices.resize(total);
+        nivel.ordenX.resize(total);
+        nivel.ordenY.resize(total);
+        nivel.ordenRadio.resize(total);
+        nivel.cursor.assign(nivel.inicioCelda.begin(), nivel.inicioCelda.end() - 1);
+        inicioNivel[L + 1] = inicioNivel[L] + total;
+    }
+    for (int i = 0; i < n; i++) {
+        if (nivelDe[i] < 0) continue;
+        Nivel& nivel = niveles[nivelDe[i]];
+        int k = nivel.cursor[celdaDe[i]]++;
+        nivel.indices[k] = i;
+        nivel.ordenX[k] = x[i];
+        nivel.ordenY[k] = y[i];
+        nivel.ordenRadio[k] = radio[i];
+    }
+}
+
+template <typename T>
+int GrillaJerarquicaT<T>::celdaEn(const Nivel& nivel, double px, double py) const {
+    int cx = static_cast<int>((px - minX) / nivel.tamCelda);
+    int cy = static_cast<int>((py - minY) / nivel.tamCelda);
+    cx = max(0, min(nivel.columnas - 1, cx));
+    cy = max(0, min(nivel.filas - 1, cy));
+    return cy * nivel.columnas + cx;
+}
+
+// --- Pares en contacto ---
+template <typename T>
+void GrillaJerarquicaT<T>::obtenerParesEnContacto(vector<pair<int, int>>& pares, PoolHilos* pool) {
+    pares.clear();
+    int total = inicioNivel.empty() ? 0 : inicioNivel.back();
+    long long pruebas = 0;
+
+    // Se recorre en orden de celda, nivel por nivel (memoria contigua)
+    if (!pool || pool->getNumHilos() == 1) {
+        pruebas = contactosEnRango(0, total, pares, solapados);
+    } else {
+        const int tamBloque = 2048;
+        int numBloques = PoolHilos::numeroBloques(total, tamBloque);
+        paresPorBloque.resize(max<size_t>(paresPorBloque.size(), numBloques));
+        solapadosPorBloque.resize(max<size_t>(solapadosPorBloque.size(), numBloques));
+        pruebasPorBloque.assign(numBloques, 0);
+
+        pool->paraCada(total, tamBloque, [this](int inicio, int fin, int bloque) {
+            paresPorBloque[bloque].clear();
+            pruebasPorBloque[bloque] = contactosEnRango(inicio, fin, paresPorBloque[bloque],
+                                                        solapadosPorBloque[bloque]);
+        });
+        for (int b = 0; b < numBloques; b++) {
+            pares.insert(pares.end(), paresPorBloque[b].begin(), paresPorBloque[b].end());
+            pruebas += pruebasPorBloque[b];
+        }
+    }
+    sort(pares.begin(), pares.end());
+
+    // Como en GrillaEspacial, cada par del mismo nivel se probó dos veces;
+    // contactosEnRango cuenta los de niveles distintos doble para igualarlos
+    paresEvaluados += pruebas / 2;
+}
+
+template <typename T>
+long long GrillaJerarquicaT<T>::contactosEnRango(int desde, int hasta, vector<pair<int, int>>& pares,
+                                                 vector<int>& salida) const {
+    // [desde, hasta) son posiciones globales (nivel por nivel, en orden de celda)
+    long long pruebas = 0;
+    int numNiveles = niveles.size();
+
+    for (int propio = 0; propio < numNiveles; propio++) {
+        int k0 = max(desde, inicioNivel[propio]) - inicioNivel[propio];
+        int k1 = min(hasta, inicioNivel[propio + 1]) - inicioNivel[propio];
+        if (k0 >= k1) continue;
+        const Nivel& suyo = niveles[propio];
+        int c = upper_bound(suyo.inicioCelda.begin(), suyo.inicioCelda.end(), k0)
+                - suyo.inicioCelda.begin() - 1;
+
+        for (int k = k0; k < k1; k++) {
+            while (suyo.inicioCelda[c + 1] <= k) c++;
+            int i = suyo.indices[k];
+
+            for (int L = propio; L < numNiveles; L++) {
+                const Nivel& nivel = niveles[L];
+                if (nivel.indices.empty()) continue;
+
+                int celda = (L == propio) ? c : celdaEn(nivel, x[i], y[i]);
+                int cx = celda % nivel.columnas;
+                int cy = celda / nivel.columnas;
+                int fx0 = max(0, cx - 1);
+                int fx1 = min(nivel.columnas - 1, cx + 1);
+
+                // Las tres celdas de cada fila del vecindario son un tramo contiguo
+                for (int fy = max(0, cy - 1); fy <= min(nivel.filas - 1, cy + 1); fy++) {
+                    int inicio = nivel.inicioCelda[fy * nivel.columnas + fx0];
+                    int fin = nivel.inicioCelda[fy * nivel.columnas + fx1 + 1];
+                    if (inicio == fin) continue;
+                    pruebas += (L == propio) ? (fin - inicio) : 2 * (fin - inicio);
+                    if (static_cast<int>(salida.size()) < fin - inicio) salida.resize(fin - inicio);
+
+                    int m = kernels->solapados(suyo.ordenX[k], suyo.ordenY[k], suyo.ordenRadio[k],
+                                               nivel.ordenX.data(), nivel.ordenY.data(),
+                                               nivel.ordenRadio.data(), inicio, fin, salida.data());
+                    for (int t = 0; t < m; t++) {
+                        int j = nivel.indices[salida[t]];
+                        if (L == propio) {
+                            if (j > i) pares.emplace_back(i, j);   // También descarta a la propia i
+                        } else {
+                            pares.emplace_back(min(i, j), max(i, j));
+                        }
+                    }
+                }
+            }
+            pruebas--;   // La propia i
+        }
+    }
+    return pruebas;
+}
+
+template <typename T>
+void GrillaJerarquicaT<T>::setIsa(IsaSimd isa) {
+    kernels = &kernelsPara<T>(isa);
+}
+
+// --- Estadísticas ---
+template <typename T>
+long long GrillaJerarquicaT<T>::getParesEvaluados() const {
+    return paresEvaluados;
+}
+
+template <typename T>
+void GrillaJerarquicaT<T>::resetEstadisticas() {
+    paresEvaluados = 0;
+}
+
+template <typename T>
+int GrillaJerarquicaT<T>::getNumeroNiveles() const {
+    return niveles.size();
+}
+
+template <typename T>
+int GrillaJerarquicaT<T>::getParticulasEnNivel(int nivel) const {
+    return niveles[nivel].indices.size();
+}
+
+template <typename T>
+long long GrillaJerarquicaT<T>::getNumeroCeldas() const {
+    long long total = 0;
+    for (const Nivel& nivel : niveles) total += nivel.inicioCelda.size() - 1;
+    return total;
+}
+
+// --- Instancias ---
+template class GrillaJerarquicaT<float>;
+template class GrillaJerarquicaT<double>;
@@ -0,0 +1,95 @@
+#ifndef GRILLA_JERARQUICA_H
+#define GRILLA_JERARQUICA_H
+
+#include <vector>
+#include <utility>
+#include "almacenparticulas.h"
+#include "poolhilos.h"
+#include "kernelsparticulas.h"
+
+/**
+ * @brief Broadphase de grillas por niveles para radios muy dispares
+ *
+ * GrillaEspacial usa una sola celda del diámetro máximo: tras muchas
+ * fusiones unas pocas partículas enormes hacen que todas las chicas caigan
+ * en las mismas celdas y la fase fina vuelve a ser casi O(N²). Aquí la
+ * celda del nivel superior es el diámetro máximo y cada nivel inferior la
+ * divide a la mitad; cada partícula va al primer nivel cuya celda cubre su
+ * diámetro, así que cada nivel es una grilla uniforme con su propio
+ * "diámetro máximo". Con radios parecidos queda un solo nivel. Como en
+ * GrillaEspacial, ningún nivel pasa de ~4 celdas por partícula.
+ *
+ * Cada partícula busca en su nivel y en los superiores (vecindario 3x3:
+ * en el nivel L ambos radios son <= h_L / 2), nunca en los inferiores, así
+ * que cada par se encuentra una sola vez; dentro del mismo nivel solo se
+ * guardan los j > i. Se recorre en orden de celda con el kernel SIMD de
+ * GrillaEspacial y la lista final se ordena: los pares son idénticos a
+ * los de GrillaEspacial::obtenerParesEnContacto.
+ */
+template <typename T>
+class GrillaJerarquicaT {
+private:
+    struct Nivel {
+        double tamCelda;
+        int columnas;
+        int filas;
+        std::vector<int> inicioCelda;   // Inicio de cada celda en 'indices'
+        std::vector<int> indices;       // Índices de partículas agrupados por celda
+        std::vector<T> ordenX, ordenY, ordenRadio;
+        std::vector<int> cursor;
+    };
+
+    double minX;
+    double minY;
+    std::vector<Nivel> niveles;         // De la celda menor a la mayor
+    std::vector<int> inicioNivel;       // Primera posición global de cada nivel
+    std::vector<signed char> nivelDe;   // -1 si inactiva
+    std::vector<int> celdaDe;           // Celda en su propio nivel
+    const T* x;                         // Arreglos de la última construcción
+    const T* y;
+    const T* radio;
+    int numParticulas;
+
+    std::vector<int> solapados;         // Trabajo de la consulta serial
+    std::vector<std::vector<std::pair<int, int>>> paresPorBloque;
+    std::vector<std::vector<int>> solapadosPorBloque;
+    std::vector<long long> pruebasPorBloque;
+    const KernelsParticulasT<T>* kernels;
+
+    // --- Estadísticas ---
+    long long paresEvaluados;
+
+public:
+    static constexpr int MAX_NIVELES = 32;
+
+    GrillaJerarquicaT();
+
+    // --- Construcción (los arreglos deben seguir vivos hasta la consulta) ---
+    void construir(const AlmacenParticulasT<T>& particulas);
+    void construir(const T* x, const T* y, const T* radio,
+                   const unsigned char* activa, int n);
+
+    // --- Pares en contacto (i < j, ordenados) ---
+    void obtenerParesEnContacto(std::vector<std::pair<int, int>>& pares,
+                                PoolHilos* pool = nullptr);
+    void setIsa(IsaSimd isa);
+
+    // --- Estadísticas ---
+    long long getParesEvaluados() const;       // Pruebas de distancia hechas
+    void resetEstadisticas();
+    int getNumeroNiveles() const;
+    int getParticulasEnNivel(int nivel) const;
+    long long getNumeroCeldas() const;         // Suma de las celdas de todos los niveles
+
+private:
+    int celdaEn(const Nivel& nivel, double px, double py) const;
+    long long contactosEnRango(int desde, int hasta, std::vector<std::pair<int, int>>& pares,
+                               std::vector<int>& salida) const;
+};
+
+using GrillaJerarquica = GrillaJerarquicaT<double>;
+
+extern template class GrillaJerarquicaT<float>;
+extern template class GrillaJerarquicaT<double>;
+
+#endif // GRILLA_JERARQUICA_H
@@ -0,0 +1,478 @@
+#include "kernelsparticulas.h"
+#include "almacenparticulas.h"
+#include <cstring>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const unsigned char PAREDES_X = AlmacenParticulas::PARED_IZQUIERDA | AlmacenParticulas::PARED_DERECHA;
+const unsigned char PAREDES_Y = AlmacenParticulas::PARED_INFERIOR | AlmacenParticulas::PARED_SUPERIOR;
+
+// ============================================================================
+// ESCALAR (float y double)
+// ============================================================================
+
+template <typename T>
+void integrarEscalar(T* x, T* y, const T* vx, const T* vy,
+                     const unsigned char* activa, int n, T dt) {
+    for (int i = 0; i < n; i++) {
+        if (activa[i]) {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+        }
+    }
+}
+
+// Una partícula; la escalar y los grupos con contacto de las vectoriales
+template <typename T>
+inline void reflejarParticula(T* x, T* y, T* vx, T* vy, const T* radio,
+                              const unsigned char* activa, unsigned char* paredes,
+                              int i, T ancho, T alto) {
+    paredes[i] = 0;
+    if (!activa[i]) return;
+
+    T r = radio[i];
+    unsigned char tocadas = 0;
+    if (x[i] - r <= 0) tocadas |= AlmacenParticulas::PARED_IZQUIERDA;
+    if (x[i] + r >= ancho) tocadas |= AlmacenParticulas::PARED_DERECHA;
+    if (y[i] - r <= 0) tocadas |= AlmacenParticulas::PARED_INFERIOR;
+    if (y[i] + r >= alto) tocadas |= AlmacenParticulas::PARED_SUPERIOR;
+
+    // Rebote con paredes verticales y corrección para no atravesarlas
+    if (tocadas & PAREDES_X) {
+        vx[i] = -vx[i];
+        if (x[i] - r < 0)
+            x[i] = r;
+        else if (x[i] + r > ancho)
+            x[i] = ancho - r;
+    }
+
+    // Rebote con paredes horizontales
+    if (tocadas & PAREDES_Y) {
+        vy[i] = -vy[i];
+        if (y[i] - r < 0)
+            y[i] = r;
+        else if (y[i] + r > alto)
+            y[i] = alto - r;
+    }
+    paredes[i] = tocadas;
+}
+
+template <typename T>
+void reflejarParedesEscalar(T* x, T* y, T* vx, T* vy,
+                            const T* radio, const unsigned char* activa,
+                            unsigned char* paredes, int n, T ancho, T alto) {
+    for (int i = 0; i < n; i++) {
+        reflejarParticula(x, y, vx, vy, radio, activa, paredes, i, ancho, alto);
+    }
+}
+
+template <typename T>
+int solapadosEscalar(T xi, T yi, T ri, const T* x, const T* y,
+                     const T* radio, int desde, int hasta, int* salida) {
+    int m = 0;
+    for (int k = desde; k < hasta; k++) {
+        T dx = x[k] - xi;
+        T dy = y[k] - yi;
+        T suma = ri + radio[k];
+        if (dx * dx + dy * dy <= suma * suma) salida[m++] = k;
+    }
+    return m;
+}
+
+#ifdef KERNELS_X86
+
+// ============================================================================
+// SSE2: 2 partículas por instrucción
+// ============================================================================
+
+__attribute__((target("sse2")))
+inline __m128d mascaraActivasSse2(const unsigned char* activa) {
+    return _mm_castsi128_pd(_mm_set_epi64x(activa[1] ? -1 : 0, activa[0] ? -1 : 0));
+}
+
+__attribute__((target("sse2")))
+inline __m128d elegirSse2(__m128d mascara, __m128d siVerdadero, __m128d siFalso) {
+    return _mm_or_pd(_mm_and_pd(mascara, siVerdadero), _mm_andnot_pd(mascara, siFalso));
+}
+
+__attribute__((target("sse2")))
+void integrarSse2(double* x, double* y, const double* vx, const double* vy,
+                  const unsigned char* activa, int n, double dt) {
+    __m128d paso = _mm_set1_pd(dt);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d mascara = mascaraActivasSse2(activa + i);
+        __m128d px = _mm_loadu_pd(x + i);
+        __m128d py = _mm_loadu_pd(y + i);
+        __m128d nx = _mm_add_pd(px, _mm_mul_pd(_mm_loadu_pd(vx + i), paso));
+        __m128d ny = _mm_add_pd(py, _mm_mul_pd(_mm_loadu_pd(vy + i), paso));
+        _mm_storeu_pd(x + i, elegirSse2(mascara, nx, px));
+        _mm_storeu_pd(y + i, elegirSse2(mascara, ny, py));
+    }
+    integrarEscalar(x + i, y + i, vx + i, vy + i, activa + i, n - i, dt);
+}
+
+__attribute__((target("sse2")))
+void reflejarParedesSse2(double* x, double* y, double* vx, double* vy,
+                         const double* radio, const unsigned char* activa,
+                         unsigned char* paredes, int n, double ancho, double alto) {
+    // Casi ningún grupo toca una pared: la prueba va en vector y solo los
+    // grupos con algún contacto pasan por reflejarParticula (que también
+    // salta las inactivas), en línea para no llamar a código sin VEX desde
+    // AVX. En el caso común no se escriben x, y, vx ni vy, y el resultado
+    // es el de la escalar por construcción
+    const __m128d cero = _mm_setzero_pd();
+    const __m128d limiteX = _mm_set1_pd(ancho);
+    const __m128d limiteY = _mm_set1_pd(alto);
+
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d r = _mm_loadu_pd(radio + i);
+        __m128d px = _mm_loadu_pd(x + i);
+        __m128d py = _mm_loadu_pd(y + i);
+        __m128d fuera = _mm_or_pd(_mm_or_pd(_mm_cmple_pd(_mm_sub_pd(px, r), cero),
+                                    _mm_cmpge_pd(_mm_add_pd(px, r), limiteX)),
+                           _mm_or_pd(_mm_cmple_pd(_mm_sub_pd(py, r), cero),
+                                    _mm_cmpge_pd(_mm_add_pd(py, r), limiteY)));
+        if (_mm_movemask_pd(fuera) == 0) {
+            memset(paredes + i, 0, 2);
+            continue;
+        }
+        for (int k = i; k < i + 2; k++) {
+            reflejarParticula(x, y, vx, vy, radio, activa, paredes, k, ancho, alto);
+        }
+    }
+    reflejarParedesEscalar(x + i, y + i, vx + i, vy + i, radio + i, activa + i,
+                           paredes + i, n - i, ancho, alto);
+}
+
+__attribute__((target("sse2")))
+int solapadosSse2(double xi, double yi, double ri, const double* x, const double* y,
+                  const double* radio, int desde, int hasta, int* salida) {
+    const __m128d cx = _mm_set1_pd(xi);
+    const __m128d cy = _mm_set1_pd(yi);
+    const __m128d cr = _mm_set1_pd(ri);
+
+    int m = 0;
+    int k = desde;
+    for (; k + 2 <= hasta; k += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + k), cx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + k), cy);
+        __m128d suma = _mm_add_pd(cr, _mm_loadu_pd(radio + k));
+        __m128d distancia2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        int bits = _mm_movemask_pd(_mm_cmple_pd(distancia2, _mm_mul_pd(suma, suma)));
+        if (bits & 1) salida[m++] = k;
+        if (bits & 2) salida[m++] = k + 1;
+    }
+    return m + solapadosEscalar(xi, yi, ri, x, y, radio, k, hasta, salida + m);
+}
+
+// --- float: 4 partículas por instrucción ---
+__attribute__((target("sse2")))
+inline __m128 mascaraActivasSse2F(const unsigned char* activa) {
+    return _mm_castsi128_ps(_mm_set_epi32(activa[3] ? -1 : 0, activa[2] ? -1 : 0,
+                                          activa[1] ? -1 : 0, activa[0] ? -1 : 0));
+}
+
+__attribute__((target("sse2")))
+inline __m128 elegirSse2(__m128 mascara, __m128 siVerdadero, __m128 siFalso) {
+    return _mm_or_ps(_mm_and_ps(mascara, siVerdadero), _mm_andnot_ps(mascara, siFalso));
+}
+
+__attribute__((target("sse2")))
+void integrarSse2(float* x, float* y, const float* vx, const float* vy,
+                  const unsigned char* activa, int n, float dt) {
+    __m128 paso = _mm_set1_ps(dt);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 mascara = mascaraActivasSse2F(activa + i);
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 nx = _mm_add_ps(px, _mm_mul_ps(_mm_loadu_ps(vx + i), paso));
+        __m128 ny = _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(vy + i), paso));
+        _mm_storeu_ps(x + i, elegirSse2(mascara, nx, px));
+        _mm_storeu_ps(y + i, elegirSse2(mascara, ny, py));
+    }
+    integrarEscalar(x + i, y + i, vx + i, vy + i, activa + i, n - i, dt);
+}
+
+__attribute__((target("sse2")))
+void reflejarParedesSse2(float* x, float* y, float* vx, float* vy,
+                         const float* radio, const unsigned char* activa,
+                         unsigned char* paredes, int n, float ancho, float alto) {
+    const __m128 cero = _mm_setzero_ps();
+    const __m128 limiteX = _mm_set1_ps(ancho);
+    const __m128 limiteY = _mm_set1_ps(alto);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 r = _mm_loadu_ps(radio + i);
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 fuera = _mm_or_ps(_mm_or_ps(_mm_cmple_ps(_mm_sub_ps(px, r), cero),
+                                    _mm_cmpge_ps(_mm_add_ps(px, r), limiteX)),
+                           _mm_or_ps(_mm_cmple_ps(_mm_sub_ps(py, r), cero),
+                                    _mm_cmpge_ps(_mm_add_ps(py, r), limiteY)));
+        if (_mm_movemask_ps(fuera) == 0) {
+            memset(paredes + i, 0, 4);
+            continue;
+        }
+        for (int k = i; k < i + 4; k++) {
+            reflejarParticula(x, y, vx, vy, radio, activa, paredes, k, ancho, alto);
+        }
+    }
+    reflejarParedesEscalar(x + i, y + i, vx + i, vy + i, radio + i, activa + i,
+                           paredes + i, n - i, ancho, alto);
+}
+
+__attribute__((target("sse2")))
+int solapadosSse2(float xi, float yi, float ri, const float* x, const float* y,
+                  const float* radio, int desde, int hasta, int* salida) {
+    const __m128 cx = _mm_set1_ps(xi);
+    const __m128 cy = _mm_set1_ps(yi);
+    const __m128 cr = _mm_set1_ps(ri);
+
+    int m = 0;
+    int k = desde;
+    for (; k + 4 <= hasta; k += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + k), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + k), cy);
+        __m128 suma = _mm_add_ps(cr, _mm_loadu_ps(radio + k));
+        __m128 distancia2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int bits = _mm_movemask_ps(_mm_cmple_ps(distancia2, _mm_mul_ps(suma, suma)));
+        while (bits) {
+            salida[m++] = k + __builtin_ctz(bits);
+            bits &= bits - 1;
+        }
+    }
+    return m + solapadosEscalar(xi, yi, ri, x, y, radio, k, hasta, salida + m);
+}
+
+// ============================================================================
+// AVX2: 4 partículas por instrucción (sin FMA, igual que la escalar)
+// ============================================================================
+
+__attribute__((target("avx2")))
+inline __m256d mascaraActivasAvx2(const unsigned char* activa) {
+    int32_t bytes;
+    memcpy(&bytes, activa, sizeof(bytes));
+    __m256i valores = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+    return _mm256_castsi256_pd(_mm256_cmpgt_epi64(valores, _mm256_setzero_si256()));
+}
+
+__attribute__((target("avx2")))
+void integrarAvx2(double* x, double* y, const double* vx, const double* vy,
+                  const unsigned char* activa, int n, double dt) {
+    __m256d paso = _mm256_set1_pd(dt);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d mascara = mascaraActivasAvx2(activa + i);
+        __m256d px = _mm256_loadu_pd(x + i);
+        __m256d py = _mm256_loadu_pd(y + i);
+        __m256d nx = _mm256_add_pd(px, _mm256_mul_pd(_mm256_loadu_pd(vx + i), paso));
+        __m256d ny = _mm256_add_pd(py, _mm256_mul_pd(_mm256_loadu_pd(vy + i), paso));
+        _mm256_storeu_pd(x + i, _mm256_blendv_pd(px, nx, mascara));
+        _mm256_storeu_pd(y + i, _mm256_blendv_pd(py, ny, mascara));
+    }
+    integrarEscalar(x + i, y + i, vx + i, vy + i, activa + i, n - i, dt);
+}
+
+__attribute__((target("avx2")))
+void reflejarParedesAvx2(double* x, double* y, double* vx, double* vy,
+                         const double* radio, const unsigned char* activa,
+                         unsigned char* paredes, int n, double ancho, double alto) {
+    const __m256d cero = _mm256_setzero_pd();
+    const __m256d limiteX = _mm256_set1_pd(ancho);
+    const __m256d limiteY = _mm256_set1_pd(alto);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d r = _mm256_loadu_pd(radio + i);
+        __m256d px = _mm256_loadu_pd(x + i);
+        __m256d py = _mm256_loadu_pd(y + i);
+        __m256d fuera = _mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(_mm256_sub_pd(px, r), cero, _CMP_LE_OQ),
+                                    _mm256_cmp_pd(_mm256_add_pd(px, r), limiteX, _CMP_GE_OQ)),
+                           _mm256_or_pd(_mm256_cmp_pd(_mm256_sub_pd(py, r), cero, _CMP_LE_OQ),
+                                    _mm256_cmp_pd(_mm256_add_pd(py, r), limiteY, _CMP_GE_OQ)));
+        if (_mm256_movemask_pd(fuera) == 0) {
+            memset(paredes + i, 0, 4);
+            continue;
+        }
+        for (int k = i; k < i + 4; k++) {
+            reflejarParticula(x, y, vx, vy, radio, activa, paredes, k, ancho, alto);
+        }
+    }
+    reflejarParedesEscalar(x + i, y + i, vx + i, vy + i, radio + i, activa + i,
+                           paredes + i, n - i, ancho, alto);
+}
+
+__attribute__((target("avx2")))
+int solapadosAvx2(double xi, double yi, double ri, const double* x, const double* y,
+                  const double* radio, int desde, int hasta, int* salida) {
+    const __m256d cx = _mm256_set1_pd(xi);
+    const __m256d cy = _mm256_set1_pd(yi);
+    const __m256d cr = _mm256_set1_pd(ri);
+
+    int m = 0;
+    int k = desde;
+    for (; k + 4 <= hasta; k += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + k), cx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + k), cy);
+        __m256d suma = _mm256_add_pd(cr, _mm256_loadu_pd(radio + k));
+        __m256d distancia2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        int bits = _mm256_movemask_pd(_mm256_cmp_pd(distancia2, _mm256_mul_pd(suma, suma),
+                                                     _CMP_LE_OQ));
+        // Compactar: una escritura por bit encendido, en orden
+        while (bits) {
+            salida[m++] = k + __builtin_ctz(bits);
+            bits &= bits - 1;
+        }
+    }
+    return m + solapadosEscalar(xi, yi, ri, x, y, radio, k, hasta, salida + m);
+}
+
+// --- float: 8 partículas por instrucción ---
+__attribute__((target("avx2")))
+inline __m256 mascaraActivasAvx2F(const unsigned char* activa) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(activa));
+    __m256i valores = _mm256_cvtepu8_epi32(bytes);
+    return _mm256_castsi256_ps(_mm256_cmpgt_epi32(valores, _mm256_setzero_si256()));
+}
+
+__attribute__((target("avx2")))
+void integrarAvx2(float* x, float* y, const float* vx, const float* vy,
+                  const unsigned char* activa, int n, float dt) {
+    __m256 paso = _mm256_set1_ps(dt);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 mascara = mascaraActivasAvx2F(activa + i);
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 nx = _mm256_add_ps(px, _mm256_mul_ps(_mm256_loadu_ps(vx + i), paso));
+        __m256 ny = _mm256_add_ps(py, _mm256_mul_ps(_mm256_loadu_ps(vy + i), paso));
+        _mm256_storeu_ps(x + i, _mm256_blendv_ps(px, nx, mascara));
+        _mm256_storeu_ps(y + i, _mm256_blendv_ps(py, ny, mascara));
+    }
+    integrarEscalar(x + i, y + i, vx + i, vy + i, activa + i, n - i, dt);
+}
+
+__attribute__((target("avx2")))
+void reflejarParedesAvx2(float* x, float* y, float* vx, float* vy,
+                         const float* radio, const unsigned char* activa,
+                         unsigned char* paredes, int n, float ancho, float alto) {
+    const __m256 cero = _mm256_setzero_ps();
+    const __m256 limiteX = _mm256_set1_ps(ancho);
+    const __m256 limiteY = _mm256_set1_ps(alto);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 r = _mm256_loadu_ps(radio + i);
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 fuera = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(px, r), cero, _CMP_LE_OQ),
+                                    _mm256_cmp_ps(_mm256_add_ps(px, r), limiteX, _CMP_GE_OQ)),
+                           _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(py, r), cero, _CMP_LE_OQ),
+                                    _mm256_cmp_ps(_mm256_add_ps(py, r), limiteY, _CMP_GE_OQ)));
+        if (_mm256_movemask_ps(fuera) == 0) {
+            memset(paredes + i, 0, 8);
+            continue;
+        }
+        for (int k = i; k < i + 8; k++) {
+            reflejarParticula(x, y, vx, vy, radio, activa, paredes, k, ancho, alto);
+        }
+    }
+    reflejarParedesEscalar(x + i, y + i, vx + i, vy + i, radio + i, activa + i,
+                           paredes + i, n - i, ancho, alto);
+}
+
+__attribute__((target("avx2")))
+int solapadosAvx2(float xi, float yi, float ri, const float* x, const float* y,
+                  const float* radio, int desde, int hasta, int* salida) {
+    const __m256 cx = _mm256_set1_ps(xi);
+    const __m256 cy = _mm256_set1_ps(yi);
+    const __m256 cr = _mm256_set1_ps(ri);
+
+    int m = 0;
+    int k = desde;
+    for (; k + 8 <= hasta; k += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + k), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + k), cy);
+        __m256 suma = _mm256_add_ps(cr, _mm256_loadu_ps(radio + k));
+        __m256 distancia2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        int bits = _mm256_movemask_ps(_mm256_cmp_ps(distancia2, _mm256_mul_ps(suma, suma),
+                                                    _CMP_LE_OQ));
+        while (bits) {
+            salida[m++] = k + __builtin_ctz(bits);
+            bits &= bits - 1;
+        }
+    }
+    return m + solapadosEscalar(xi, yi, ri, x, y, radio, k, hasta, salida + m);
+}
+
+#endif // KERNELS_X86
+
+// --- Tablas por escalar e ISA ---
+template <typename T>
+const KernelsParticulasT<T> KERNELS_ESCALAR = {IsaSimd::ESCALAR, integrarEscalar<T>,
+                                               reflejarParedesEscalar<T>, solapadosEscalar<T>};
+#ifdef KERNELS_X86
+template <typename T>
+const KernelsParticulasT<T> KERNELS_SSE2 = {IsaSimd::SSE2, integrarSse2, reflejarParedesSse2,
+                                            solapadosSse2};
+template <typename T>
+const KernelsParticulasT<T> KERNELS_AVX2 = {IsaSimd::AVX2, integrarAvx2, reflejarParedesAvx2,
+                                            solapadosAvx2};
+#endif
+
+} // namespace
+
+// --- Selección ---
+bool isaDisponible(IsaSimd isa) {
+#ifdef KERNELS_X86
+    switch (isa) {
+    case IsaSimd::AVX2: return __builtin_cpu_supports("avx2");
+    case IsaSimd::SSE2: return __builtin_cpu_supports("sse2");
+    case IsaSimd::ESCALAR:
+    default: return true;
+    }
+#else
+    return isa == IsaSimd::ESCALAR;
+#endif
+}
+
+IsaSimd mejorIsaDisponible() {
+    if (isaDisponible(IsaSimd::AVX2)) return IsaSimd::AVX2;
+    if (isaDisponible(IsaSimd::SSE2)) return IsaSimd::SSE2;
+    return IsaSimd::ESCALAR;
+}
+
+template <typename T>
+const KernelsParticulasT<T>& kernelsPara(IsaSimd isa) {
+    if (!isaDisponible(isa)) return KERNELS_ESCALAR<T>;
+#ifdef KERNELS_X86
+    if (isa == IsaSimd::AVX2) return KERNELS_AVX2<T>;
+    if (isa == IsaSimd::SSE2) return KERNELS_SSE2<T>;
+#endif
+    return KERNELS_ESCALAR<T>;
+}
+
+const char* nombreIsa(IsaSimd isa) {
+    switch (isa) {
+    case IsaSimd::AVX2: return "AVX2";
+    case IsaSimd::SSE2: return "SSE2";
+    case IsaSimd::ESCALAR:
+    default: return "escalar";
+    }
+}
+
+// --- Instancias ---
+template const KernelsParticulasT<float>& kernelsPara<float>(IsaSimd isa);
+template const KernelsParticulasT<double>& kernelsPara<double>(IsaSimd isa);
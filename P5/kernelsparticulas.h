@@ -0,0 +1,58 @@
+#ifndef KERNELS_PARTICULAS_H
+#define KERNELS_PARTICULAS_H
+
+/**
+ * @brief Conjunto de instrucciones de los kernels vectoriales
+ */
+enum class IsaSimd {
+    ESCALAR,    // Un elemento por vez (cualquier arquitectura)
+    SSE2,       // 2 doubles por instrucción
+    AVX2        // 4 doubles por instrucción
+};
+
+/**
+ * @brief Kernels del paso sobre los arreglos del AlmacenParticulasT<T>
+ *
+ * Cada versión hace exactamente las mismas operaciones que la escalar
+ * (sin FMA), así que los resultados son idénticos bit a bit; solo cambia
+ * cuántas partículas se procesan por instrucción (con float, el doble que
+ * con double). La versión se elige en tiempo de ejecución según lo que
+ * soporte el procesador.
+ */
+template <typename T>
+struct KernelsParticulasT {
+    IsaSimd isa;
+
+    // x += vx * dt, y += vy * dt para las activas
+    void (*integrar)(T* x, T* y, const T* vx, const T* vy,
+                     const unsigned char* activa, int n, T dt);
+
+    // Rebote elástico con las paredes de la caja [0, ancho] x [0, alto]
+    // (mismo criterio que Particula::colisionarPared). En 'paredes' deja las
+    // paredes tocadas por cada partícula (bits AlmacenParticulas::PARED_*,
+    // 0 si no toca ninguna o está inactiva).
+    void (*reflejarParedes)(T* x, T* y, T* vx, T* vy,
+                            const T* radio, const unsigned char* activa,
+                            unsigned char* paredes, int n, T ancho, T alto);
+
+    // Fase fina por lotes: posiciones k en [desde, hasta) de (x, y, radio)
+    // cuyo círculo se solapa con (xi, yi, ri), comparando distancias al
+    // cuadrado: dx² + dy² <= (ri + r)². Las deja en 'salida' en orden
+    // creciente y devuelve cuántas son.
+    int (*solapados)(T xi, T yi, T ri, const T* x, const T* y,
+                     const T* radio, int desde, int hasta, int* salida);
+};
+
+using KernelsParticulas = KernelsParticulasT<double>;
+
+// --- Selección ---
+bool isaDisponible(IsaSimd isa);
+IsaSimd mejorIsaDisponible();
+template <typename T>
+const KernelsParticulasT<T>& kernelsPara(IsaSimd isa);   // Escalar si la ISA no está disponible
+const char* nombreIsa(IsaSimd isa);
+
+extern template const KernelsParticulasT<float>& kernelsPara<float>(IsaSimd isa);
+extern template const KernelsParticulasT<double>& kernelsPara<double>(IsaSimd isa);
+
+#endif // KERNELS_PARTICULAS_H
@@ -0,0 +1,200 @@
+#include "listavecinos.h"
+#include <algorithm>
+
+using namespace std;
+
+template <typename T>
+ListaVecinosT<T>::ListaVecinosT()
+    : piel(0), valida(false), reconstrucciones(0), consultas(0), paresEvaluados(0) {}
+
+// --- Configuración ---
+template <typename T>
+void ListaVecinosT<T>::setPiel(T piel) {
+    this->piel = max(piel, T(0));
+    valida = false;
+}
+
+template <typename T>
+T ListaVecinosT<T>::getPiel() const {
+    return piel;
+}
+
+template <typename T>
+void ListaVecinosT<T>::setIsa(IsaSimd isa) {
+    grilla.setIsa(isa);
+}
+
+template <typename T>
+void ListaVecinosT<T>::invalidar() {
+    valida = false;
+}
+
+template <typename T>
+void ListaVecinosT<T>::remapear(const vector<int>& orden) {
+    int n = orden.size();
+    if (!valida || n != static_cast<int>(id0.size())) {
+        valida = false;
+        return;
+    }
+
+    nuevoIndice.resize(n);
+    for (int k = 0; k < n; k++) nuevoIndice[orden[k]] = k;
+
+    // Mismos pares con los índices nuevos, otra vez como (i < j) ordenados
+    paresLista.clear();
+    paresLista.reserve(vecinos.size());
+    for (int i = 0; i < n; i++) {
+        for (int k = inicioVecinos[i]; k < inicioVecinos[i + 1]; k++) {
+            int a = nuevoIndice[i];
+            int b = nuevoIndice[vecinos[k]];
+            paresLista.emplace_back(min(a, b), max(a, b));
+        }
+    }
+    sort(paresLista.begin(), paresLista.end());
+
+    fill(inicioVecinos.begin(), inicioVecinos.end(), 0);
+    for (const auto& par : paresLista) inicioVecinos[par.first + 1]++;
+    for (int i = 0; i < n; i++) inicioVecinos[i + 1] += inicioVecinos[i];
+    for (size_t k = 0; k < paresLista.size(); k++) vecinos[k] = paresLista[k].second;
+
+    // El estado de referencia viaja con su partícula (sin pedir memoria: el
+    // trabajo se queda con el arreglo viejo y su capacidad)
+    auto permutar = [&orden, n](auto& arreglo, auto& trabajo) {
+        trabajo.resize(n);
+        for (int k = 0; k < n; k++) trabajo[k] = arreglo[orden[k]];
+        arreglo.swap(trabajo);
+    };
+    permutar(x0, trabajoEscalar);
+    permutar(y0, trabajoEscalar);
+    permutar(radio0, trabajoEscalar);
+    permutar(id0, nuevoIndice);
+}
+
+// --- Pares en contacto ---
+template <typename T>
+void ListaVecinosT<T>::obtenerParesEnContacto(const AlmacenParticulasT<T>& particulas,
+                                              vector<pair<int, int>>& pares, PoolHilos* pool) {
+    consultas++;
+    if (necesitaReconstruir(particulas)) reconstruir(particulas, pool);
+
+    pares.clear();
+    int n = particulas.tamano();
+    if (!pool || pool->getNumHilos() == 1) {
+        contactosEnRango(particulas, 0, n, pares);
+    } else {
+        // Bloques de partículas; las listas de cada bloque se unen en orden
+        const int tamBloque = 2048;
+        int numBloques = PoolHilos::numeroBloques(n, tamBloque);
+        paresPorBloque.resize(max<size_t>(paresPorBloque.size(), numBloques));
+        pool->paraCada(n, tamBloque, [this, &particulas](int inicio, int fin, int bloque) {
+            paresPorBloque[bloque].clear();
+            contactosEnRango(particulas, inicio, fin, paresPorBloque[bloque]);
+        });
+        for (int b = 0; b < numBloques; b++) {
+            pares.insert(pares.end(), paresPorBloque[b].begin(), paresPorBloque[b].end());
+        }
+    }
+    paresEvaluados += vecinos.size();
+}
+
+template <typename T>
+void ListaVecinosT<T>::contactosEnRango(const AlmacenParticulasT<T>& particulas, int desde,
+                                        int hasta, vector<pair<int, int>>& pares) const {
+    const T* x = particulas.x.data();
+    const T* y = particulas.y.data();
+    const T* radio = particulas.radio.data();
+    for (int i = desde; i < hasta; i++) {
+        for (int k = inicioVecinos[i]; k < inicioVecinos[i + 1]; k++) {
+            // Misma cuenta que KernelsParticulas::solapados
+            int j = vecinos[k];
+            T dx = x[j] - x[i];
+            T dy = y[j] - y[i];
+            T suma = radio[i] + radio[j];
+            if (dx * dx + dy * dy <= suma * suma) pares.emplace_back(i, j);
+        }
+    }
+}
+
+// --- Reconstrucción ---
+template <typename T>
+bool ListaVecinosT<T>::necesitaReconstruir(const AlmacenParticulasT<T>& particulas) const {
+    int n = particulas.tamano();
+    if (!valida || n != static_cast<int>(id0.size())) return true;
+
+    T limite = (piel / 2) * (piel / 2);
+    for (int i = 0; i < n; i++) {
+        int id = particulas.activa[i] ? particulas.id[i] : -1;
+        if (id != id0[i]) return true;
+        if (id < 0) continue;
+        if (particulas.radio[i] != radio0[i]) return true;
+        T dx = particulas.x[i] - x0[i];
+        T dy = particulas.y[i] - y0[i];
+        if (dx * dx + dy * dy > limite) return true;
+    }
+    return false;
+}
+
+template <typename T>
+void ListaVecinosT<T>::reconstruir(const AlmacenParticulasT<T>& particulas, PoolHilos* pool) {
+    int n = particulas.tamano();
+    radioInflado.resize(n);
+    for (int i = 0; i < n; i++) radioInflado[i] = particulas.radio[i] + piel / 2;
+
+    // Pares a distancia <= ri + rj + piel, ordenados (i < j)
+    grilla.construir(particulas.x.data(), particulas.y.data(), radioInflado.data(),
+                     particulas.activa.data(), n);
+    grilla.obtenerParesEnContacto(paresLista, pool);
+
+    inicioVecinos.assign(n + 1, 0);
+    for (const auto& par : paresLista) inicioVecinos[par.first + 1]++;
+    for (int i = 0; i < n; i++) inicioVecinos[i + 1] += inicioVecinos[i];
+    vecinos.resize(paresLista.size());
+    for (size_t k = 0; k < paresLista.size(); k++) vecinos[k] = paresLista[k].second;
+
+    x0.assign(particulas.x.begin(), particulas.x.end());
+    y0.assign(particulas.y.begin(), particulas.y.end());
+    radio0.assign(particulas.radio.begin(), particulas.radio.end());
+    id0.resize(n);
+    for (int i = 0; i < n; i++) id0[i] = particulas.activa[i] ? particulas.id[i] : -1;
+
+    valida = true;
+    reconstrucciones++;
+}
+
+// --- Estadísticas ---
+template <typename T>
+long long ListaVecinosT<T>::getReconstrucciones() const {
+    return reconstrucciones;
+}
+
+template <typename T>
+long long ListaVecinosT<T>::getConsultas() const {
+    return consultas;
+}
+
+template <typename T>
+double ListaVecinosT<T>::getFrecuenciaReconstruccion() const {
+    return consultas > 0 ? static_cast<double>(reconstrucciones) / consultas : 0.0;
+}
+
+template <typename T>
+long long ListaVecinosT<T>::getParesEnLista() const {
+    return vecinos.size();
+}
+
+template <typename T>
+long long ListaVecinosT<T>::getParesEvaluados() const {
+    return paresEvaluados + grilla.getParesEvaluados();
+}
+
+template <typename T>
+void ListaVecinosT<T>::resetEstadisticas() {
+    reconstrucciones = 0;
+    consultas = 0;
+    paresEvaluados = 0;
+    grilla.resetEstadisticas();
+}
+
+// --- Instancias ---
+template class ListaVecinosT<float>;
+template class ListaVecinosT<double>;
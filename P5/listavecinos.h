@@ -0,0 +1,88 @@
+#ifndef LISTA_VECINOS_H
+#define LISTA_VECINOS_H
+
+#include <vector>
+#include <utility>
+#include "almacenparticulas.h"
+#include "grillaespacial.h"
+#include "poolhilos.h"
+#include "kernelsparticulas.h"
+
+/**
+ * @brief Listas de vecinos de Verlet con piel, reutilizadas entre pasos
+ *
+ * Al construir se guardan, para cada partícula i, los j > i a distancia
+ * <= ri + rj + piel (la grilla con los radios inflados en piel/2). Mientras
+ * ninguna partícula se haya movido más de piel/2 desde entonces, todo par
+ * en contacto estaba en la lista, así que cada paso solo prueba la lista.
+ * Se reconstruye cuando alguna se movió más de piel/2, o si cambió el
+ * almacén (otra cantidad, otro id en un índice, otro radio: fusiones,
+ * partículas nuevas, compactar). Si el almacén solo se permutó, remapear()
+ * traduce la lista a los nuevos índices sin volver a la grilla.
+ *
+ * La prueba de contacto es la misma cuenta que el kernel de la grilla y la
+ * lista va en orden (i, j), así que los pares en contacto son idénticos a
+ * los de GrillaEspacial::obtenerParesEnContacto.
+ */
+template <typename T>
+class ListaVecinosT {
+private:
+    T piel;
+    GrillaEspacialT<T> grilla;              // Solo para reconstruir
+    std::vector<T> radioInflado;
+    std::vector<std::pair<int, int>> paresLista;
+
+    // --- Lista compacta: vecinos de i en [inicioVecinos[i], inicioVecinos[i + 1]) ---
+    std::vector<int> inicioVecinos;
+    std::vector<int> vecinos;
+
+    // --- Estado en la última construcción ---
+    std::vector<T> x0, y0, radio0;
+    std::vector<int> id0;                   // -1 si estaba inactiva
+    std::vector<int> nuevoIndice;           // Trabajo de remapear
+    std::vector<T> trabajoEscalar;
+    bool valida;
+
+    std::vector<std::vector<std::pair<int, int>>> paresPorBloque;
+
+    // --- Estadísticas ---
+    long long reconstrucciones;
+    long long consultas;
+    long long paresEvaluados;
+
+public:
+    ListaVecinosT();
+
+    // --- Configuración ---
+    void setPiel(T piel);                   // Invalida la lista
+    T getPiel() const;
+    void setIsa(IsaSimd isa);
+    void invalidar();
+    void remapear(const std::vector<int>& orden);   // Tras AlmacenParticulas::reordenar
+
+    // --- Pares en contacto (i < j, ordenados), reconstruyendo si hace falta ---
+    void obtenerParesEnContacto(const AlmacenParticulasT<T>& particulas,
+                                std::vector<std::pair<int, int>>& pares,
+                                PoolHilos* pool = nullptr);
+
+    // --- Estadísticas ---
+    long long getReconstrucciones() const;
+    long long getConsultas() const;
+    double getFrecuenciaReconstruccion() const;   // Reconstrucciones por consulta
+    long long getParesEnLista() const;
+    long long getParesEvaluados() const;           // Grilla al reconstruir + listas
+    void resetEstadisticas();
+
+private:
+    bool necesitaReconstruir(const AlmacenParticulasT<T>& particulas) const;
+    void reconstruir(const AlmacenParticulasT<T>& particulas, PoolHilos* pool);
+    void contactosEnRango(const AlmacenParticulasT<T>& particulas, int desde, int hasta,
+                          std::vector<std::pair<int, int>>& pares) const;
+};
+
+using ListaVecinos = ListaVecinosT<double>;
+
+extern template class ListaVecinosT<float>;
+extern template class ListaVecinosT<double>;
+
+#endif // LISTA_VECINOS_H
@@ -4,11 +4,18 @@
 #include <cstdlib>
 #include <ctime>
 #include "simulador.h"
+#include "benchmark.h"
 
 using namespace std;
 namespace fs = std::filesystem;
 
-int main() {
+int main(int argc, char* argv[]) {
+    // --- Modo de mediciones de rendimiento: P5 --benchmark [nombre] ---
+    if (argc > 1 && string(argv[1]) == "--benchmark") {
+        Benchmark::ejecutar(argc > 2 ? argv[2] : "todos");
+        return 0;
+    }
+
     cout << "===============================================" << endl;
     cout << "     SIMULADOR DE COLISIONES DE PARTiCULAS     " << endl;
     cout << "===============================================" << endl << endl;
@@ -21,7 +28,9 @@ int main() {
             if (name.rfind("trayectoria_", 0) == 0 && name.ends_with(".txt")) {
                 fs::remove(entry.path());
             }
-            if (name == "colisiones.txt") {
+            if (name == "colisiones.txt" || name == "trayectorias.bin" ||
+                name == "trayectorias.p5a" || name == "trayectorias.p5z" ||
+                name == "trayectorias.p5e") {
                 fs::remove(entry.path());
             }
         }
@@ -35,6 +44,14 @@ int main() {
     double altoCaja = 600.0;
     double dt = 0.016;   // Paso de tiempo (~60 FPS)
     double tiempoTotal = 50.0;
+    // TEXTO: trayectoria_X.txt por particula; BINARIO: un solo trayectorias.bin;
+    // ARCHIVO: trayectorias.p5a por bloques con indice (acceso por tiempo);
+    // COMPRIMIDO: trayectorias.p5z cuantizado a 1e-3 (~10x menos que BINARIO);
+    // EVENTOS: trayectorias.p5e solo con keyframes en rebotes y fusiones (exacto)
+    FormatoSalida formatoSalida = FormatoSalida::TEXTO;
+    // Precision del nucleo fisico: double (referencia) o float (mitad de
+    // memoria por particula, el doble de particulas por instruccion SIMD)
+    using Precision = double;
 
     cout << "CONFIGURACIoN DE LA SIMULACIoN" << endl;
     cout << "==============================" << endl;
@@ -63,7 +80,9 @@ int main() {
 
     // --- Crear simulador con colisiones completamente inelasticas para particulas ---
     // El coeficiente no importa aqui porque las colisiones entre particulas son fusion
-    Simulador sim(anchoCaja, altoCaja, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+    Simulador<Precision> sim(anchoCaja, altoCaja, dt, TipoColision::COMPLETAMENTE_INELASTICA, 0.0);
+    sim.setFormatoSalida(formatoSalida);
+    sim.setSalidaAsincrona(true);   // Archivos escritos en un hilo aparte
 
     // --- Configurar obstaculos ---
     if (numObstaculos > 0) {
@@ -100,7 +119,16 @@ int main() {
     cout << "               ARCHIVOS GENERADOS              " << endl;
     cout << "===============================================" << endl;
     cout << "Trayectorias:" << endl;
-    cout << "  - trayectoria_X.txt (para cada particula)" << endl;
+    if (formatoSalida == FormatoSalida::BINARIO)
+        cout << "  - trayectorias.bin (un registro por paso)" << endl;
+    else if (formatoSalida == FormatoSalida::ARCHIVO)
+        cout << "  - trayectorias.p5a (bloques con indice por tiempo)" << endl;
+    else if (formatoSalida == FormatoSalida::COMPRIMIDO)
+        cout << "  - trayectorias.p5z (comprimido, precision 1e-3)" << endl;
+    else if (formatoSalida == FormatoSalida::EVENTOS)
+        cout << "  - trayectorias.p5e (keyframes en cada evento)" << endl;
+    else
+        cout << "  - trayectoria_X.txt (para cada particula)" << endl;
     cout << endl;
     cout << "Eventos:" << endl;
     cout << "  - colisiones.txt (registro completo)" << endl;
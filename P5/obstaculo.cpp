@@ -5,37 +5,43 @@
 using namespace std;
 
 // --- Constructor ---
-Obstaculo::Obstaculo(double x, double y, double lado, double coefRestitucion)
+template <typename T>
+ObstaculoT<T>::ObstaculoT(T x, T y, T lado, T coefRestitucion)
     : posicion(x, y), lado(lado), coefRestitucion(coefRestitucion) {}
 
 // --- Detectar colisión con partícula ---
-bool Obstaculo::colisionaCon(const Particula& p) const {
-    Vector posP = p.getPosicion();
-    double radio = p.getRadio();
+template <typename T>
+bool ObstaculoT<T>::colisionaCon(const ParticulaT<T>& p) const {
+    VectorT<T> posP = p.getPosicion();
+    return colisionaCon(posP.getX(), posP.getY(), p.getRadio());
+}
 
+template <typename T>
+bool ObstaculoT<T>::colisionaCon(T x, T y, T radio) const {
     // Encontrar el punto más cercano del cuadrado a la partícula
-    double puntoX = max(getLeft(), min(posP.getX(), getRight()));
-    double puntoY = max(getTop(), min(posP.getY(), getBottom()));
+    T puntoX = max(getLeft(), min(x, getRight()));
+    T puntoY = max(getTop(), min(y, getBottom()));
 
     // Calcular distancia del centro de la partícula al punto más cercano
-    double dx = posP.getX() - puntoX;
-    double dy = posP.getY() - puntoY;
-    double distancia = sqrt(dx * dx + dy * dy);
+    T dx = x - puntoX;
+    T dy = y - puntoY;
+    T distancia = sqrt(dx * dx + dy * dy);
 
     // Hay colisión si la distancia es menor que el radio
     return distancia < radio;
 }
 
 // --- Determinar qué lado colisionó ---
-char Obstaculo::ladoColision(const Vector& posParticula) const {
+template <typename T>
+char ObstaculoT<T>::ladoColision(const VectorT<T>& posParticula) const {
     // Calcular distancias a cada lado
-    double distLeft = abs(posParticula.getX() - getLeft());
-    double distRight = abs(posParticula.getX() - getRight());
-    double distTop = abs(posParticula.getY() - getTop());
-    double distBottom = abs(posParticula.getY() - getBottom());
+    T distLeft = abs(posParticula.getX() - getLeft());
+    T distRight = abs(posParticula.getX() - getRight());
+    T distTop = abs(posParticula.getY() - getTop());
+    T distBottom = abs(posParticula.getY() - getBottom());
 
     // Encontrar la distancia mínima
-    double minDist = min({distLeft, distRight, distTop, distBottom});
+    T minDist = min({distLeft, distRight, distTop, distBottom});
 
     // Devolver el lado correspondiente
     if (minDist == distLeft) return 'L';
@@ -45,20 +51,22 @@ char Obstaculo::ladoColision(const Vector& posParticula) const {
 }
 
 // --- Obtener vector normal al lado ---
-Vector Obstaculo::getNormal(char lado) const {
+template <typename T>
+VectorT<T> ObstaculoT<T>::getNormal(char lado) const {
     switch(lado) {
-    case 'T': return Vector(0, -1);  // Normal apunta hacia arriba
-    case 'B': return Vector(0, 1);   // Normal apunta hacia abajo
-    case 'L': return Vector(-1, 0);  // Normal apunta a la izquierda
-    case 'R': return Vector(1, 0);   // Normal apunta a la derecha
-    default: return Vector(0, 1);
+    case 'T': return VectorT<T>(0, -1);  // Normal apunta hacia arriba
+    case 'B': return VectorT<T>(0, 1);   // Normal apunta hacia abajo
+    case 'L': return VectorT<T>(-1, 0);  // Normal apunta a la izquierda
+    case 'R': return VectorT<T>(1, 0);   // Normal apunta a la derecha
+    default: return VectorT<T>(0, 1);
     }
 }
 
 // --- Corregir posición para evitar solapamiento ---
-void Obstaculo::corregirPosicion(Particula& p, char lado) const {
-    Vector pos = p.getPosicion();
-    double radio = p.getRadio();
+template <typename T>
+void ObstaculoT<T>::corregirPosicion(ParticulaT<T>& p, char lado) const {
+    VectorT<T> pos = p.getPosicion();
+    T radio = p.getRadio();
 
     switch(lado) {
     case 'T':  // Colisión arriba
@@ -87,7 +95,12 @@ void Obstaculo::corregirPosicion(Particula& p, char lado) const {
 }
 
 // --- Obtener centro del obstáculo ---
-Vector Obstaculo::getCentro() const {
-    return Vector(posicion.getX() + lado / 2.0,
-                  posicion.getY() + lado / 2.0);
+template <typename T>
+VectorT<T> ObstaculoT<T>::getCentro() const {
+    return VectorT<T>(posicion.getX() + lado / 2,
+                  posicion.getY() + lado / 2);
 }
+
+// --- Instancias ---
+template class ObstaculoT<float>;
+template class ObstaculoT<double>;
@@ -4,42 +4,49 @@
 #include "vector.h"
 #include "particula.h"
 
-class Obstaculo {
+template <typename T>
+class ObstaculoT {
 private:
-    Vector posicion;           // Esquina superior izquierda
-    double lado;               // Tamaño del cuadrado
-    double coefRestitucion;    // Coeficiente ε (0 < ε < 1)
+    VectorT<T> posicion;       // Esquina superior izquierda
+    T lado;                    // Tamaño del cuadrado
+    T coefRestitucion;         // Coeficiente ε (0 < ε < 1)
 
 public:
     // --- Constructor ---
-    Obstaculo(double x, double y, double lado, double coefRestitucion);
+    ObstaculoT(T x, T y, T lado, T coefRestitucion);
 
     // --- Detección de colisión ---
-    bool colisionaCon(const Particula& p) const;
+    bool colisionaCon(const ParticulaT<T>& p) const;
+    bool colisionaCon(T x, T y, T radio) const;
 
     // --- Determinar lado del cuadrado que colisionó ---
     // Devuelve: 'T' (top), 'B' (bottom), 'L' (left), 'R' (right)
-    char ladoColision(const Vector& posParticula) const;
+    char ladoColision(const VectorT<T>& posParticula) const;
 
     // --- Obtener vector normal al lado ---
-    Vector getNormal(char lado) const;
+    VectorT<T> getNormal(char lado) const;
 
     // --- Corregir posición de partícula para evitar solapamiento ---
-    void corregirPosicion(Particula& p, char lado) const;
+    void corregirPosicion(ParticulaT<T>& p, char lado) const;
 
     // --- Getters ---
-    Vector getPosicion() const { return posicion; }
-    double getLado() const { return lado; }
-    double getCoefRestitucion() const { return coefRestitucion; }
+    VectorT<T> getPosicion() const { return posicion; }
+    T getLado() const { return lado; }
+    T getCoefRestitucion() const { return coefRestitucion; }
 
     // --- Límites del obstáculo ---
-    double getLeft() const { return posicion.getX(); }
-    double getRight() const { return posicion.getX() + lado; }
-    double getTop() const { return posicion.getY(); }
-    double getBottom() const { return posicion.getY() + lado; }
+    T getLeft() const { return posicion.getX(); }
+    T getRight() const { return posicion.getX() + lado; }
+    T getTop() const { return posicion.getY(); }
+    T getBottom() const { return posicion.getY() + lado; }
 
     // --- Centro del obstáculo ---
-    Vector getCentro() const;
+    VectorT<T> getCentro() const;
 };
 
+using Obstaculo = ObstaculoT<double>;
+
+extern template class ObstaculoT<float>;
+extern template class ObstaculoT<double>;
+
 #endif // OBSTACULO_H
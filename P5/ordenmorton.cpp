@@ -0,0 +1,75 @@
+#include "ordenmorton.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Separa los 16 bits bajos con un cero entre cada uno
+uint32_t separarBits(uint32_t v) {
+    v &= 0x0000FFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+} // namespace
+
+template <typename T>
+uint32_t OrdenMortonT<T>::codigo(uint32_t cx, uint32_t cy) {
+    return separarBits(cx) | (separarBits(cy) << 1);
+}
+
+template <typename T>
+void OrdenMortonT<T>::calcular(const AlmacenParticulasT<T>& particulas, vector<int>& orden) {
+    int n = particulas.tamano();
+    orden.resize(n);
+    if (n == 0) return;
+
+    // Caja y celda como en GrillaEspacial (las inactivas cuentan igual: se
+    // eliminan al compactar, no importa dónde queden)
+    double x0 = particulas.x[0], x1 = x0, y0 = particulas.y[0], y1 = y0, radioMaximo = 0;
+    for (int i = 0; i < n; i++) {
+        x0 = min(x0, static_cast<double>(particulas.x[i]));
+        x1 = max(x1, static_cast<double>(particulas.x[i]));
+        y0 = min(y0, static_cast<double>(particulas.y[i]));
+        y1 = max(y1, static_cast<double>(particulas.y[i]));
+        radioMaximo = max(radioMaximo, static_cast<double>(particulas.radio[i]));
+    }
+    const double celdasMaximas = (1 << BITS_POR_EJE) - 1;
+    double tamCelda = max({2.0 * radioMaximo, (x1 - x0) / celdasMaximas,
+                           (y1 - y0) / celdasMaximas, 1e-9});
+
+    codigos.resize(n);
+    for (int i = 0; i < n; i++) {
+        uint32_t cx = static_cast<uint32_t>((particulas.x[i] - x0) / tamCelda);
+        uint32_t cy = static_cast<uint32_t>((particulas.y[i] - y0) / tamCelda);
+        codigos[i] = codigo(cx, cy);
+        orden[i] = i;
+    }
+
+    // Radix sort LSD por bytes; cada pasada es estable
+    codigosTmp.resize(n);
+    indicesTmp.resize(n);
+    for (int desplazamiento = 0; desplazamiento < 32; desplazamiento += 8) {
+        conteo.assign(257, 0);
+        for (int k = 0; k < n; k++) conteo[((codigos[k] >> desplazamiento) & 0xFF) + 1]++;
+        if (*max_element(conteo.begin(), conteo.end()) == n) continue;   // Byte común
+        for (int b = 0; b < 256; b++) conteo[b + 1] += conteo[b];
+
+        for (int k = 0; k < n; k++) {
+            int destino = conteo[(codigos[k] >> desplazamiento) & 0xFF]++;
+            codigosTmp[destino] = codigos[k];
+            indicesTmp[destino] = orden[k];
+        }
+        codigos.swap(codigosTmp);
+        orden.swap(indicesTmp);
+    }
+}
+
+// --- Instancias ---
+template class OrdenMortonT<float>;
+template class OrdenMortonT<double>;
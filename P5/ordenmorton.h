@@ -0,0 +1,41 @@
+#ifndef ORDEN_MORTON_H
+#define ORDEN_MORTON_H
+
+#include <vector>
+#include <cstdint>
+#include "almacenparticulas.h"
+
+/**
+ * @brief Orden de las partículas por código de Morton (curva Z) de su celda
+ *
+ * Con el movimiento, partículas vecinas en el espacio terminan lejos en el
+ * almacén y la grilla y la fase fina saltan por la memoria. El código de
+ * Morton intercala los bits de la celda (x, y), así que celdas cercanas
+ * tienen códigos cercanos; ordenar el almacén por él vuelve contiguos los
+ * vecindarios. La celda es la de la grilla (diámetro máximo) y el orden se
+ * obtiene con radix sort LSD de 8 bits por pasada, estable (los empates
+ * quedan por índice) y sin las pasadas en que todos comparten el byte.
+ */
+template <typename T>
+class OrdenMortonT {
+private:
+    std::vector<std::uint32_t> codigos, codigosTmp;
+    std::vector<int> indicesTmp;
+    std::vector<int> conteo;
+
+public:
+    static constexpr int BITS_POR_EJE = 16;
+
+    // orden[k] = índice que va a la posición k (ver AlmacenParticulas::reordenar)
+    void calcular(const AlmacenParticulasT<T>& particulas, std::vector<int>& orden);
+
+    // Intercala los 16 bits bajos de cx (pares) y cy (impares)
+    static std::uint32_t codigo(std::uint32_t cx, std::uint32_t cy);
+};
+
+using OrdenMorton = OrdenMortonT<double>;
+
+extern template class OrdenMortonT<float>;
+extern template class OrdenMortonT<double>;
+
+#endif // ORDEN_MORTON_H
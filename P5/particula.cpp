@@ -2,17 +2,20 @@
 #include <cmath>
 
 // --- Constructor ---
-Particula::Particula(int id, double x, double y, double vx, double vy, double masa, double radio)
+template <typename T>
+ParticulaT<T>::ParticulaT(int id, T x, T y, T vx, T vy, T masa, T radio)
     : id(id), posicion(x, y), velocidad(vx, vy), masa(masa), radio(radio), activa(true) {}
 
 // --- Movimiento ---
-void Particula::mover(double dt) {
+template <typename T>
+void ParticulaT<T>::mover(T dt) {
     if (!activa) return;
     posicion += velocidad * dt; // Movimiento en tiempo discreto: r = r + v * dt
 }
 
 // --- Colisión con las paredes ---
-void Particula::colisionarPared(double ancho, double alto) {
+template <typename T>
+void ParticulaT<T>::colisionarPared(T ancho, T alto) {
     if (!activa) return;
 
     // Rebote con paredes verticales
@@ -39,24 +42,42 @@ void Particula::colisionarPared(double ancho, double alto) {
 }
 
 // --- Getters ---
-int Particula::getId() const { return id; }
-Vector Particula::getPosicion() const { return posicion; }
-Vector Particula::getVelocidad() const { return velocidad; }
-double Particula::getMasa() const { return masa; }
-double Particula::getRadio() const { return radio; }
-bool Particula::estaActiva() const { return activa; }
+template <typename T>
+int ParticulaT<T>::getId() const { return id; }
+template <typename T>
+VectorT<T> ParticulaT<T>::getPosicion() const { return posicion; }
+template <typename T>
+VectorT<T> ParticulaT<T>::getVelocidad() const { return velocidad; }
+template <typename T>
+T ParticulaT<T>::getMasa() const { return masa; }
+template <typename T>
+T ParticulaT<T>::getRadio() const { return radio; }
+template <typename T>
+bool ParticulaT<T>::estaActiva() const { return activa; }
 
 // --- Setters ---
-void Particula::setPosicion(const Vector& p) { posicion = p; }
-void Particula::setVelocidad(const Vector& v) { velocidad = v; }
-void Particula::setActiva(bool estado) { activa = estado; }
+template <typename T>
+void ParticulaT<T>::setPosicion(const VectorT<T>& p) { posicion = p; }
+template <typename T>
+void ParticulaT<T>::setVelocidad(const VectorT<T>& v) { velocidad = v; }
+template <typename T>
+void ParticulaT<T>::setActiva(bool estado) { activa = estado; }
 
 // --- Detección de colisiones entre partículas ---
-double Particula::distanciaA(const Particula& otra) const {
+template <typename T>
+T ParticulaT<T>::distanciaA(const ParticulaT& otra) const {
     return (posicion - otra.posicion).magnitud();
 }
 
-bool Particula::colisionaCon(const Particula& otra) const {
-    double distancia = distanciaA(otra);
-    return distancia <= (radio + otra.radio);
+template <typename T>
+bool ParticulaT<T>::colisionaCon(const ParticulaT& otra) const {
+    // Distancias al cuadrado: la misma comparación que la fase fina por lotes
+    T dx = otra.posicion.getX() - posicion.getX();
+    T dy = otra.posicion.getY() - posicion.getY();
+    T suma = radio + otra.radio;
+    return dx * dx + dy * dy <= suma * suma;
 }
+
+// --- Instancias ---
+template class ParticulaT<float>;
+template class ParticulaT<double>;
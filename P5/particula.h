@@ -3,39 +3,45 @@
 
 #include "vector.h"
 
-class Particula {
+template <typename T>
+class ParticulaT {
 private:
     int id;                // Identificador único
-    Vector posicion;     // Posición (x, y)
-    Vector velocidad;    // Velocidad (vx, vy)
-    double masa;           // Masa de la partícula
-    double radio;          // Radio de la partícula
+    VectorT<T> posicion;   // Posición (x, y)
+    VectorT<T> velocidad;  // Velocidad (vx, vy)
+    T masa;                // Masa de la partícula
+    T radio;               // Radio de la partícula
     bool activa;           // Si está activa en la simulación
 
 public:
     // --- Constructor ---
-    Particula(int id, double x, double y, double vx, double vy, double masa, double radio);
+    ParticulaT(int id, T x, T y, T vx, T vy, T masa, T radio);
 
     // --- Métodos de movimiento ---
-    void mover(double dt);                         // Actualiza la posición
-    void colisionarPared(double ancho, double alto); // Rebote elástico con las paredes
+    void mover(T dt);                              // Actualiza la posición
+    void colisionarPared(T ancho, T alto);         // Rebote elástico con las paredes
 
     // --- Getters ---
     int getId() const;
-    Vector getPosicion() const;
-    Vector getVelocidad() const;
-    double getMasa() const;
-    double getRadio() const;
+    VectorT<T> getPosicion() const;
+    VectorT<T> getVelocidad() const;
+    T getMasa() const;
+    T getRadio() const;
     bool estaActiva() const;
 
     // --- Setters ---
-    void setPosicion(const Vector& p);
-    void setVelocidad(const Vector& v);
+    void setPosicion(const VectorT<T>& p);
+    void setVelocidad(const VectorT<T>& v);
     void setActiva(bool estado);
 
     // --- Funciones auxiliares ---
-    double distanciaA(const Particula& otra) const;  // Distancia entre centros
-    bool colisionaCon(const Particula& otra) const;  // Detección de colisión simple
+    T distanciaA(const ParticulaT& otra) const;      // Distancia entre centros
+    bool colisionaCon(const ParticulaT& otra) const; // Detección de colisión simple
 };
 
+using Particula = ParticulaT<double>;
+
+extern template class ParticulaT<float>;
+extern template class ParticulaT<double>;
+
 #endif // PARTICULA_H
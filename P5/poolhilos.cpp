@@ -0,0 +1,137 @@
+#include "poolhilos.h"
+#include <algorithm>
+
+using namespace std;
+
+PoolHilos::PoolHilos(int numHilos) : bloquesSinTomar(0), terminar(false), robos(0) {
+    if (numHilos <= 0) numHilos = max(1u, thread::hardware_concurrency());
+
+    for (int k = 0; k < numHilos; k++) {
+        colas.push_back(make_unique<ColaTrabajo>());
+    }
+    // El último participante es el hilo que llama a paraCada()
+    for (int k = 0; k < numHilos - 1; k++) {
+        hilos.emplace_back(&PoolHilos::bucleTrabajador, this, k);
+    }
+}
+
+PoolHilos::~PoolHilos() {
+    {
+        lock_guard<mutex> lock(cerrojo);
+        terminar = true;
+    }
+    hayTrabajo.notify_all();
+    for (thread& hilo : hilos) {
+        if (hilo.joinable()) hilo.join();
+    }
+}
+
+int PoolHilos::getNumHilos() const {
+    return colas.size();
+}
+
+long long PoolHilos::getRobos() const {
+    return robos;
+}
+
+int PoolHilos::numeroBloques(int n, int tamBloque) {
+    return n <= 0 ? 0 : (n + tamBloque - 1) / tamBloque;
+}
+
+// --- Reparto ---
+void PoolHilos::paraCada(int n, int tamBloque, const Tarea& tarea) {
+    tamBloque = max(1, tamBloque);
+    int numBloques = numeroBloques(n, tamBloque);
+    if (numBloques == 0) return;
+
+    // Sin otros hilos o con un solo bloque no hay nada que repartir
+    int participantes = getNumHilos();
+    if (participantes == 1 || numBloques == 1) {
+        for (int b = 0; b < numBloques; b++) {
+            tarea(b * tamBloque, min(n, (b + 1) * tamBloque), b);
+        }
+        return;
+    }
+
+    Trabajo trabajo;
+    trabajo.tarea = &tarea;
+    trabajo.n = n;
+    trabajo.tamBloque = tamBloque;
+    trabajo.pendientes = numBloques;
+
+    {
+        lock_guard<mutex> lock(cerrojo);
+        bloquesSinTomar += numBloques;
+    }
+    // Bloques contiguos por participante: cada hilo recorre memoria vecina
+    for (int p = 0; p < participantes; p++) {
+        int desde = static_cast<long long>(numBloques) * p / participantes;
+        int hasta = static_cast<long long>(numBloques) * (p + 1) / participantes;
+        lock_guard<mutex> lock(colas[p]->cerrojo);
+        for (int b = desde; b < hasta; b++) {
+            colas[p]->bloques.push_back(Bloque{&trabajo, b});
+        }
+    }
+    hayTrabajo.notify_all();
+
+    // El hilo que llama también trabaja
+    int propio = participantes - 1;
+    Bloque bloque;
+    while (tomarBloque(propio, bloque)) {
+        ejecutar(bloque);
+    }
+
+    unique_lock<mutex> lock(cerrojo);
+    terminado.wait(lock, [&]() { return trabajo.pendientes == 0; });
+}
+
+// --- Trabajadores ---
+void PoolHilos::bucleTrabajador(int propio) {
+    Bloque bloque;
+    while (true) {
+        if (tomarBloque(propio, bloque)) {
+            ejecutar(bloque);
+            continue;
+        }
+
+        unique_lock<mutex> lock(cerrojo);
+        hayTrabajo.wait(lock, [this]() { return terminar || bloquesSinTomar > 0; });
+        if (terminar && bloquesSinTomar == 0) return;
+    }
+}
+
+bool PoolHilos::tomarBloque(int propio, Bloque& bloque) {
+    int participantes = getNumHilos();
+    for (int k = 0; k < participantes; k++) {
+        int p = (propio + k) % participantes;
+        ColaTrabajo& cola = *colas[p];
+        lock_guard<mutex> lock(cola.cerrojo);
+        if (cola.bloques.empty()) continue;
+
+        // La cola propia se consume por el frente; a las ajenas se les roba el final
+        if (k == 0) {
+            bloque = cola.bloques.front();
+            cola.bloques.pop_front();
+        } else {
+            bloque = cola.bloques.back();
+            cola.bloques.pop_back();
+            robos++;
+        }
+        bloquesSinTomar--;
+        return true;
+    }
+    return false;
+}
+
+void PoolHilos::ejecutar(const Bloque& bloque) {
+    Trabajo* trabajo = bloque.trabajo;
+    int inicio = bloque.indice * trabajo->tamBloque;
+    int fin = min(trabajo->n, inicio + trabajo->tamBloque);
+    (*trabajo->tarea)(inicio, fin, bloque.indice);
+
+    // Después de este decremento 'trabajo' puede dejar de existir
+    if (--trabajo->pendientes == 0) {
+        lock_guard<mutex> lock(cerrojo);
+        terminado.notify_all();
+    }
+}
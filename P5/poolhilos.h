@@ -0,0 +1,76 @@
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief Pool de hilos con robo de trabajo para bucles por bloques
+ *
+ * paraCada() parte [0, n) en bloques y reparte bloques contiguos entre las
+ * colas de los participantes (los hilos del pool y el hilo que llama).
+ * Cada uno consume su cola por el frente y, al vaciarla, roba bloques del
+ * final de las otras. La llamada vuelve cuando todos los bloques terminaron.
+ *
+ * El índice de bloque que recibe la tarea no depende de qué hilo la
+ * ejecuta, así que escribir resultados por bloque y unirlos en orden da el
+ * mismo resultado que el recorrido serial. No admite paraCada() anidados y
+ * la tarea no debe lanzar excepciones.
+ */
+class PoolHilos {
+public:
+    using Tarea = std::function<void(int inicio, int fin, int bloque)>;
+
+private:
+    struct Trabajo {
+        const Tarea* tarea;
+        int n;
+        int tamBloque;
+        std::atomic<int> pendientes;
+    };
+
+    struct Bloque {
+        Trabajo* trabajo;
+        int indice;
+    };
+
+    struct ColaTrabajo {
+        std::mutex cerrojo;
+        std::deque<Bloque> bloques;
+    };
+
+    std::vector<std::thread> hilos;
+    std::vector<std::unique_ptr<ColaTrabajo>> colas;   // Una por participante
+    std::mutex cerrojo;
+    std::condition_variable hayTrabajo;
+    std::condition_variable terminado;
+    std::atomic<int> bloquesSinTomar;
+    bool terminar;
+    std::atomic<long long> robos;     // Bloques tomados de una cola ajena
+
+public:
+    explicit PoolHilos(int numHilos = 0);   // 0: un participante por núcleo
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    int getNumHilos() const;                // Incluye al hilo que llama
+    long long getRobos() const;
+
+    void paraCada(int n, int tamBloque, const Tarea& tarea);
+    static int numeroBloques(int n, int tamBloque);
+
+private:
+    void bucleTrabajador(int propio);
+    bool tomarBloque(int propio, Bloque& bloque);
+    void ejecutar(const Bloque& bloque);
+};
+
+#endif // POOL_HILOS_H
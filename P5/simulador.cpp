@@ -4,51 +4,73 @@
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <type_traits>
 
 using namespace std;
 
-Simulador::Simulador(double ancho, double alto, double dt, TipoColision tipo, double coefRestitucion)
-    : ancho(ancho), alto(alto), dt(dt), tiempoActual(0.0),
-    tiempoTotal(0.0), pasoActual(0),
-    totalColisionesParticulas(0), totalColisionesObstaculos(0),
-    totalColisionesParedes(0), contadorPasosEstancado(0),
-    ultimoNumParticulas(0), siguienteIdParticula(0),
-    motorColisiones(nullptr), tipoColisionActual(tipo) {
+namespace {
 
-    // Siempre usar fusión para partículas
-    motorColisiones = new ColisionCompletamenteInelastica(siguienteIdParticula);
-}
+// Resultado por partícula de las pasadas de paredes y obstáculos
+enum : unsigned char {
+    SIN_CONTACTO = 0,
+    CONTACTO_NUEVO = 1,          // Se cuenta y se registra
+    CONTACTO_PERSISTENTE = 2     // Ya estaba en contacto el paso anterior
+};
 
-Simulador::~Simulador() {
-    for (Particula* p : particulas) {
-        delete p;
-    }
-    particulas.clear();
+// Partículas (o pares) por tarea del pool
+const int TAMANO_BLOQUE = 4096;
 
-    if (motorColisiones) {
-        delete motorColisiones;
-    }
+} // namespace
+
+template <typename T>
+Simulador<T>::Simulador(double ancho, double alto, double dt, TipoColision tipo, double coefRestitucion)
+    : ancho(ancho), alto(alto), dt(dt), tiempoActual(0.0),
+    tiempoTotal(0.0), pasoActual(0),
+    totalColisionesParticulas(0), totalColisionesObstaculos(0),
+    totalColisionesParedes(0), pasosEnContacto(0), contadorPasosEstancado(0),
+    ultimoNumParticulas(0), siguienteIdParticula(0), bvhObstaculosValido(false),
+    campoDistanciaActivo(false), campoDistanciaValido(false),
+    motorFusion(siguienteIdParticula), motorInelastico(static_cast<T>(coefRestitucion)),
+    tipoColisionActual(tipo), solverActivo(false), barridoPorColores(false),
+    grillaJerarquicaActiva(false),
+    listaVecinosActiva(false),
+    pasosEntreReordenes(0), reordenamientos(0), particulasReordenadas(false),
+    kernels(&kernelsPara<T>(mejorIsaDisponible())), pool(nullptr), dominios(nullptr),
+    escritor(nullptr), escritorAsincrono(nullptr), formatoSalida(FormatoSalida::TEXTO),
+    precisionPosicion(1e-3), precisionVelocidad(1e-3),
+    bytesTrayectorias(0), salidaAsincrona(false), politicaCola(PoliticaCola::BLOQUEAR),
+    capacidadCola(2), segundosEnSalida(0.0),
+    salidaArchivos(true), detallesConsola(true) {}
+
+template <typename T>
+Simulador<T>::~Simulador() {
+    particulas.limpiar();
 
     cerrarArchivos();
+    delete dominios;
+    delete pool;
 }
 
-void Simulador::agregarParticula(double x, double y, double vx, double vy,
-                                 double masa, double radio) {
-    Particula* nueva = new Particula(siguienteIdParticula, x, y, vx, vy, masa, radio);
-    particulas.push_back(nueva);
+template <typename T>
+ManejadorParticula Simulador<T>::agregarParticula(double x, double y, double vx, double vy,
+                                               double masa, double radio) {
+    int indice = particulas.agregar(siguienteIdParticula, x, y, vx, vy, masa, radio);
     siguienteIdParticula++;
 
-    auto* motorFusion = dynamic_cast<ColisionCompletamenteInelastica*>(motorColisiones);
-    if (motorFusion) {
-        motorFusion->setSiguienteId(siguienteIdParticula);
-    }
+    motorFusion.setSiguienteId(siguienteIdParticula);
+    return particulas.manejadorDe(indice);
 }
 
-void Simulador::agregarObstaculo(double x, double y, double lado, double coefRestitucion) {
+template <typename T>
+void Simulador<T>::agregarObstaculo(double x, double y, double lado, double coefRestitucion) {
     obstaculos.emplace_back(x, y, lado, coefRestitucion);
+    bvhObstaculosValido = false;
+    campoDistanciaValido = false;
 }
 
-void Simulador::configurarObstaculos(int cantidad) {
+template <typename T>
+void Simulador<T>::configurarObstaculos(int cantidad) {
     // Coeficiente de restitución para obstáculos (inelástica)
     double coef = 0.7;
     double lado = 50.0;
@@ -60,7 +82,8 @@ void Simulador::configurarObstaculos(int cantidad) {
     }
 }
 
-void Simulador::iniciar() {
+template <typename T>
+void Simulador<T>::iniciar() {
     tiempoActual = 0.0;
     pasoActual = 0;
     abrirArchivos();
@@ -68,7 +91,7 @@ void Simulador::iniciar() {
     cout << "===============================================" << endl;
     cout << "             INICIO DE SIMULACIÓN              " << endl;
     cout << "===============================================" << endl;
-    cout << "Partículas iniciales: " << particulas.size() << endl;
+    cout << "Partículas iniciales: " << particulas.tamano() << endl;
     cout << "Obstáculos: " << obstaculos.size() << endl;
     cout << "Dimensiones: " << ancho << " x " << alto << endl;
     cout << "dt: " << dt << " s" << endl;
@@ -76,15 +99,25 @@ void Simulador::iniciar() {
     cout << "TIPOS DE COLISIÓN CONFIGURADOS:" << endl;
     cout << "  • Partículas ↔ Paredes: ELÁSTICA (e=1.0)" << endl;
     cout << "  • Partículas ↔ Obstáculos: INELÁSTICA (e=0.7)" << endl;
-    cout << "  • Partículas ↔ Partículas: FUSIÓN (e=0.0)" << endl;
+    if (tipoColisionActual == TipoColision::ELASTICA)
+        cout << "  • Partículas ↔ Partículas: ELÁSTICA, modo gas (e=1.0)" << endl;
+    else if (tipoColisionActual == TipoColision::INELASTICA)
+        cout << "  • Partículas ↔ Partículas: INELÁSTICA, modo gas (e="
+             << motorInelastico.getCoeficienteRestitucion() << ")" << endl;
+    else
+        cout << "  • Partículas ↔ Partículas: FUSIÓN (e=0.0)" << endl;
     cout << endl;
 }
 
-void Simulador::ejecutarPaso() {
+template <typename T>
+void Simulador<T>::ejecutarPaso() {
     actualizarPosiciones();
     detectarYResolverColisiones();
     guardarEstadoActual();
     limpiarParticulasInactivas();
+    if (pasosEntreReordenes > 0 && pasoActual % pasosEntreReordenes == 0) {
+        reordenarParticulas();
+    }
 
     int activasAhora = contarParticulasActivas();
     if (activasAhora == ultimoNumParticulas) {
@@ -98,7 +131,8 @@ void Simulador::ejecutarPaso() {
     pasoActual++;
 }
 
-void Simulador::ejecutar(double tiempoFinal) {
+template <typename T>
+void Simulador<T>::ejecutar(double tiempoFinal) {
     tiempoTotal = tiempoFinal;
     int totalPasos = static_cast<int>(tiempoFinal / dt);
     int progresoAnterior = -1;
@@ -127,12 +161,15 @@ void Simulador::ejecutar(double tiempoFinal) {
     }
 }
 
-void Simulador::finalizar() {
+template <typename T>
+void Simulador<T>::finalizar() {
     cerrarArchivos();
     mostrarEstadisticas();
 
-    if (motorColisiones) {
-        motorColisiones->mostrarEstadisticas();
+    switch (tipoColisionActual) {
+    case TipoColision::ELASTICA: motorElastico.mostrarEstadisticas(); break;
+    case TipoColision::INELASTICA: motorInelastico.mostrarEstadisticas(); break;
+    case TipoColision::COMPLETAMENTE_INELASTICA: motorFusion.mostrarEstadisticas(); break;
     }
 
     cout << "===============================================" << endl;
@@ -140,15 +177,34 @@ void Simulador::finalizar() {
     cout << "===============================================" << endl;
 }
 
-void Simulador::actualizarPosiciones() {
-    for (Particula* p : particulas) {
-        if (p->estaActiva()) {
-            p->mover(dt);
-        }
+template <typename T>
+void Simulador<T>::repartir(int n, const PoolHilos::Tarea& tarea) {
+    if (pool) {
+        pool->paraCada(n, TAMANO_BLOQUE, tarea);
+    } else if (n > 0) {
+        tarea(0, n, 0);
     }
 }
 
-void Simulador::detectarYResolverColisiones() {
+template <typename T>
+void Simulador<T>::actualizarPosiciones() {
+    // r = r + v * dt sobre los arreglos contiguos, por bloques
+    T* x = particulas.x.data();
+    T* y = particulas.y.data();
+    const T* vx = particulas.vx.data();
+    const T* vy = particulas.vy.data();
+    const unsigned char* activa = particulas.activa.data();
+    const KernelsParticulasT<T>* k = kernels;
+    T paso = dt;
+
+    repartir(particulas.tamano(), [=](int inicio, int fin, int) {
+        k->integrar(x + inicio, y + inicio, vx + inicio, vy + inicio, activa + inicio,
+                    fin - inicio, paso);
+    });
+}
+
+template <typename T>
+void Simulador<T>::detectarYResolverColisiones() {
     // ORDEN IMPORTANTE:
     // 1. Colisiones con paredes (elásticas)
     detectarColisionesParedes();
@@ -156,157 +212,449 @@ void Simulador::detectarYResolverColisiones() {
     // 2. Colisiones con obstáculos (inelásticas)
     detectarColisionesObstaculos();
 
-    // 3. Colisiones entre partículas (fusión)
+    // 3. Colisiones entre partículas (fusión o modo gas)
     detectarColisionesEntreParticulas();
 }
 
-void Simulador::detectarColisionesParedes() {
+template <typename T>
+void Simulador<T>::detectarColisionesParedes() {
     // COLISIONES ELÁSTICAS: inversión de velocidad perpendicular
-    for (Particula* p : particulas) {
-        if (!p->estaActiva()) continue;
-
-        Vector pos = p->getPosicion();
-        double r = p->getRadio();
-
-        if (pos.getX() - r <= 0 || pos.getX() + r >= ancho ||
-            pos.getY() - r <= 0 || pos.getY() + r >= alto) {
+    // Cada partícula se resuelve por separado (por bloques); los eventos se
+    // registran después, en orden de índice, igual que en el paso serial.
+    int n = particulas.tamano();
+    marcaContacto.resize(n);
+    paredesTocadas.resize(n);
+
+    repartir(n, [this](int inicio, int fin, int) {
+        // Rebote vectorizado (mismo criterio que Particula::colisionarPared)
+        kernels->reflejarParedes(particulas.x.data() + inicio, particulas.y.data() + inicio,
+                                 particulas.vx.data() + inicio, particulas.vy.data() + inicio,
+                                 particulas.radio.data() + inicio,
+                                 particulas.activa.data() + inicio,
+                                 paredesTocadas.data() + inicio, fin - inicio, ancho, alto);
+
+        for (int i = inicio; i < fin; i++) {
+            marcaContacto[i] = SIN_CONTACTO;
+            if (!particulas.activa[i]) continue;
+
+            // Solo cuenta el inicio del contacto con cada pared
+            unsigned char paredes = paredesTocadas[i];
+            if (paredes) {
+                marcaContacto[i] = (paredes & ~particulas.contactoParedes[i])
+                                       ? CONTACTO_NUEVO : CONTACTO_PERSISTENTE;
+            }
+            particulas.contactoParedes[i] = paredes;
+        }
+    });
 
-            p->colisionarPared(ancho, alto);  // Ya implementa colisión elástica
+    for (int i = 0; i < n; i++) {
+        if (marcaContacto[i] == CONTACTO_NUEVO) {
             totalColisionesParedes++;
-            registrarColision("PARED", p->getId());
+            registrarColision("PARED", particulas.id[i]);
+        } else if (marcaContacto[i] == CONTACTO_PERSISTENTE) {
+            pasosEnContacto++;
         }
     }
 }
 
-void Simulador::detectarColisionesObstaculos() {
+template <typename T>
+void Simulador<T>::detectarColisionesObstaculos() {
     // COLISIONES INELÁSTICAS con coeficiente de restitución
-    for (Particula* p : particulas) {
-        if (!p->estaActiva()) continue;
+    // Los obstáculos solo se leen: cada bloque de partículas es independiente
+    int n = particulas.tamano();
+    marcaContacto.resize(n);
+
+    // Con el campo de distancia cada partícula hace una sola consulta; se
+    // hornea con un alcance de dos radios máximos (las que crecen más allá,
+    // por fusión, usan la prueba exacta)
+    bool usarCampo = campoDistanciaActivo && !obstaculos.empty();
+    if (usarCampo && !campoDistanciaValido) {
+        T radioMaximo = 0;
+        for (int i = 0; i < n; i++) {
+            if (particulas.activa[i]) radioMaximo = max(radioMaximo, particulas.radio[i]);
+        }
+        T alcance = max(2 * radioMaximo, static_cast<T>(4 * campoDistancia.getResolucionPedida()));
+        campoDistancia.construir(obstaculos, static_cast<T>(ancho), static_cast<T>(alto), alcance);
+        campoDistanciaValido = true;
+    }
+
+    // Con muchos obstáculos se consulta el BVH (construido una vez); da el
+    // mismo obstáculo que el recorrido lineal: el primero en orden que toca
+    bool usarBvh = static_cast<int>(obstaculos.size()) >= BvhObstaculosT<T>::MIN_OBSTACULOS;
+    if (usarBvh && !bvhObstaculosValido) {
+        bvhObstaculos.construir(obstaculos);
+        bvhObstaculosValido = true;
+    }
+
+    repartir(n, [this, usarCampo, usarBvh](int inicio, int fin, int) {
+        for (int i = inicio; i < fin; i++) {
+            marcaContacto[i] = SIN_CONTACTO;
+            if (!particulas.activa[i]) continue;
+
+            if (usarCampo && particulas.radio[i] < campoDistancia.getAlcance()) {
+                MuestraDistanciaT<T> muestra = campoDistancia.muestrear(particulas.x[i], particulas.y[i]);
+                int tocado = muestra.distancia < particulas.radio[i] ? muestra.obstaculo : -1;
+                if (tocado >= 0) {
+                    VectorT<T> vel(particulas.vx[i], particulas.vy[i]);
+                    if (vel.magnitud() > 0.1) {
+                        ParticulaT<T> p = particulas.obtener(i);
+                        ColisionManagerT<T>::colisionCampoDistancia(
+                            p, muestra, obstaculos[tocado].getCoefRestitucion());
+                        particulas.guardar(i, p);
+                        marcaContacto[i] = (particulas.contactoObstaculo[i] != tocado)
+                                               ? CONTACTO_NUEVO : CONTACTO_PERSISTENTE;
+                    }
+                }
+                particulas.contactoObstaculo[i] = tocado;
+                continue;
+            }
+
+            int tocado = -1;
+            if (usarBvh) {
+                tocado = bvhObstaculos.primerContacto(particulas.x[i], particulas.y[i],
+                                                      particulas.radio[i], obstaculos);
+            } else {
+                for (size_t k = 0; k < obstaculos.size(); k++) {
+                    if (obstaculos[k].colisionaCon(particulas.x[i], particulas.y[i],
+                                                   particulas.radio[i])) {
+                        tocado = k;
+                        break;
+                    }
+                }
+            }
 
-        for (Obstaculo& obs : obstaculos) {
-            if (obs.colisionaCon(*p)) {
-                Vector vel = p->getVelocidad();
+            if (tocado >= 0) {
+                VectorT<T> vel(particulas.vx[i], particulas.vy[i]);
                 if (vel.magnitud() > 0.1) {
                     // Usa ColisionManager que aplica coeficiente de restitución
-                    ColisionManager::colisionInelastica(*p, obs);
-                    totalColisionesObstaculos++;
-                    registrarColision("OBSTACULO", p->getId());
+                    ParticulaT<T> p = particulas.obtener(i);
+                    ColisionManagerT<T>::colisionInelastica(p, obstaculos[tocado]);
+                    particulas.guardar(i, p);
+
+                    // Solo cuenta el inicio del contacto con el obstáculo
+                    marcaContacto[i] = (particulas.contactoObstaculo[i] != tocado)
+                                           ? CONTACTO_NUEVO : CONTACTO_PERSISTENTE;
                 }
-                break;
             }
+            particulas.contactoObstaculo[i] = tocado;
+        }
+    });
+
+    for (int i = 0; i < n; i++) {
+        if (marcaContacto[i] == CONTACTO_NUEVO) {
+            totalColisionesObstaculos++;
+            registrarColision("OBSTACULO", particulas.id[i]);
+        } else if (marcaContacto[i] == CONTACTO_PERSISTENTE) {
+            pasosEnContacto++;
         }
     }
 }
 
-void Simulador::detectarColisionesEntreParticulas() {
-    // COLISIONES COMPLETAMENTE INELÁSTICAS: fusión de partículas
-    int fusionesEnEstePaso = 0;
-    const int MAX_FUSIONES_POR_PASO = 1;  // Procesar una fusión a la vez
-
-    for (size_t i = 0; i < particulas.size() && fusionesEnEstePaso < MAX_FUSIONES_POR_PASO; i++) {
-        if (!particulas[i]->estaActiva()) continue;
+template <typename T>
+void Simulador<T>::detectarColisionesEntreParticulas() {
+    // Lista compacta de pares en contacto (i < j, ordenada) al inicio del
+    // barrido; cada modo la consume a su manera
+    if (dominios) {
+        // Cada franja resuelve sus pares con su propia grilla (con halo)
+        dominios->obtenerParesEnContacto(particulas, pool, paresContacto);
+    } else if (listaVecinosActiva) {
+        // Solo se prueban los pares de la lista; la grilla se usa al reconstruir
+        listaVecinos.obtenerParesEnContacto(particulas, paresContacto, pool);
+    } else if (grillaJerarquicaActiva) {
+        grillaJerarquica.construir(particulas);
+        grillaJerarquica.obtenerParesEnContacto(paresContacto, pool);
+    } else {
+        grilla.construir(particulas);
+        grilla.obtenerParesEnContacto(paresContacto, pool);
+    }
 
-        for (size_t j = i + 1; j < particulas.size(); j++) {
-            if (!particulas[j]->estaActiva()) continue;
+    // El modelo se elige una vez por paso; cada rama es un bucle de pares
+    // instanciado para su modelo
+    switch (tipoColisionActual) {
+    case TipoColision::ELASTICA: resolverChoquesGas(motorElastico); break;
+    case TipoColision::INELASTICA: resolverChoquesGas(motorInelastico); break;
+    case TipoColision::COMPLETAMENTE_INELASTICA: fusionarContactos(); break;
+    }
+}
 
-            if (particulas[i]->colisionaCon(*particulas[j])) {
-                fusionarParticulas(particulas[i], particulas[j]);
-                fusionesEnEstePaso++;
-                break;
+template <typename T>
+template <typename Modelo>
+void Simulador<T>::resolverChoquesGas(Modelo& modelo) {
+    // MODO GAS: choques por impulso (elásticos o inelásticos) sin fusión.
+    ContadoresColisionT<T> contadores;
+
+    if (solverActivo || barridoPorColores) {
+        // Lotes de contactos sin partículas compartidas (colores), en paralelo;
+        // cada bloque lleva sus contadores y se suman en orden de bloque
+        if (solverActivo) {
+            contadores = solver.resolver(particulas, paresContacto,
+                                         modelo.getCoeficienteRestitucion(), pool);
+        } else {
+            contadores = solver.barrerPorColores(particulas, paresContacto, modelo, pool);
+        }
+        const vector<unsigned char>& choques = solver.getChoques();
+        for (size_t k = 0; k < paresContacto.size(); k++) {
+            if (choques[k]) {
+                registrarColision("CHOQUE", particulas.id[paresContacto[k].first],
+                                  particulas.id[paresContacto[k].second]);
+            }
+        }
+    } else {
+        // Los pares van en orden y cada uno se vuelve a comprobar con las
+        // posiciones ya corregidas por los anteriores, como en
+        // ColisionT::detectarYResolverColisiones (serial: comparten partículas,
+        // así que basta un contador)
+        for (const auto& par : paresContacto) {
+            if (modelo.resolverColision(particulas, par.first, par.second, contadores)) {
+                registrarColision("CHOQUE", particulas.id[par.first], particulas.id[par.second]);
             }
         }
     }
+
+    totalColisionesParticulas += contadores.colisiones;
+    modelo.acumular(contadores);
+}
+
+template <typename T>
+void Simulador<T>::fusionarContactos() {
+    // COLISIONES COMPLETAMENTE INELÁSTICAS: fusión de partículas
+    // Todas las fusiones del paso se resuelven juntas: las cadenas de
+    // partículas solapadas se agrupan con union-find y cada grupo se
+    // fusiona en una sola partícula. Nada cambia hasta unir los grupos,
+    // así que la lista de pares se usa entera antes de fusionar.
+    if (paresContacto.empty()) return;
+    int n = particulas.tamano();
+
+    raizFusion.resize(n);
+    for (int i = 0; i < n; i++) raizFusion[i] = i;
+
+    for (const auto& par : paresContacto) {
+        int ri = buscarRaiz(par.first);
+        int rj = buscarRaiz(par.second);
+        if (ri != rj) {
+            raizFusion[max(ri, rj)] = min(ri, rj);   // La raíz es el menor índice
+        }
+    }
+
+    // Reunir los miembros de cada grupo (ordenados por raíz y por índice)
+    miembrosFusion.clear();
+    for (int i = 0; i < n; i++) {
+        int r = buscarRaiz(i);
+        if (r != i) {
+            miembrosFusion.emplace_back(r, i);
+        }
+    }
+    sort(miembrosFusion.begin(), miembrosFusion.end());
+
+    for (size_t k = 0; k < miembrosFusion.size();) {
+        int raiz = miembrosFusion[k].first;
+        grupoIndices.clear();
+        grupoIndices.push_back(raiz);
+        for (; k < miembrosFusion.size() && miembrosFusion[k].first == raiz; k++) {
+            grupoIndices.push_back(miembrosFusion[k].second);
+        }
+        fusionarGrupo(grupoIndices);
+    }
 }
 
-void Simulador::fusionarParticulas(Particula* p1, Particula* p2) {
-    auto* motorFusion = dynamic_cast<ColisionCompletamenteInelastica*>(motorColisiones);
+template <typename T>
+int Simulador<T>::buscarRaiz(int i) {
+    while (raizFusion[i] != i) {
+        raizFusion[i] = raizFusion[raizFusion[i]];   // Compresión por mitades
+        i = raizFusion[i];
+    }
+    return i;
+}
 
-    if (motorFusion) {
-        // Separar partículas antes de fusionar
-        ColisionManager::separarParticulas(*p1, *p2);
+template <typename T>
+void Simulador<T>::fusionarGrupo(const vector<int>& miembros) {
+    vector<ParticulaT<T>>& grupo = grupoFusion;
+    grupo.clear();
+    for (int i : miembros) {
+        grupo.push_back(particulas.obtener(i));
+    }
 
-        // Crear nueva partícula fusionada
-        Particula* nueva = motorFusion->fusionarParticulas(*p1, *p2);
-        siguienteIdParticula = nueva->getId() + 1;
-        motorFusion->setSiguienteId(siguienteIdParticula);
+    // Crear nueva partícula fusionada (conserva masa, momento y área)
+    ParticulaT<T> nueva = motorFusion.fusionarParticulas(grupo);
+    siguienteIdParticula = nueva.getId() + 1;
+    motorFusion.setSiguienteId(siguienteIdParticula);
 
-        // Desactivar partículas originales
-        p1->setActiva(false);
-        p2->setActiva(false);
+    // Desactivar partículas originales (sus slots se reciclan al compactar)
+    for (int i : miembros) {
+        particulas.activa[i] = 0;
+    }
 
-        // Agregar nueva partícula
-        particulas.push_back(nueva);
+    // Agregar nueva partícula
+    VectorT<T> pos = nueva.getPosicion();
+    VectorT<T> vel = nueva.getVelocidad();
+    particulas.agregar(nueva.getId(), pos.getX(), pos.getY(), vel.getX(), vel.getY(),
+                       nueva.getMasa(), nueva.getRadio());
 
+    // Un evento por cada partícula absorbida por la primera del grupo
+    for (size_t k = 1; k < grupo.size(); k++) {
         totalColisionesParticulas++;
-        registrarColision("FUSION", p1->getId(), p2->getId());
+        registrarColision("FUSION", grupo[0].getId(), grupo[k].getId());
+    }
 
-        cout << "  Fusión: P" << p1->getId() << " + P" << p2->getId()
-             << " → P" << nueva->getId()
-             << " (m=" << fixed << setprecision(2) << nueva->getMasa()
-             << ", r=" << nueva->getRadio()
+    if (detallesConsola) {
+        cout << "  Fusión: P" << grupo[0].getId();
+        for (size_t k = 1; k < grupo.size(); k++) {
+            cout << " + P" << grupo[k].getId();
+        }
+        cout << " → P" << nueva.getId()
+             << " (m=" << fixed << setprecision(2) << nueva.getMasa()
+             << ", r=" << nueva.getRadio()
              << ", t=" << setprecision(3) << tiempoActual << "s)" << endl;
     }
 }
 
-void Simulador::guardarEstadoActual() {
-    for (Particula* p : particulas) {
-        if (p->estaActiva()) {
-            int id = p->getId();
-            Vector pos = p->getPosicion();
+template <typename T>
+void Simulador<T>::guardarEstadoActual() {
+    if (!salidaArchivos) return;
+    auto inicio = chrono::steady_clock::now();
+
+    if (!escritor) {
+        escritor = EscritorTrayectorias::crear(formatoSalida, dt, ancho, alto,
+                                               precisionPosicion, precisionVelocidad,
+                                               is_same_v<T, float>);
+        escritor->abrir();
+        if (salidaAsincrona) {
+            // EVENTOS no admite perder frames: el keyframe de un rebote pasaría
+            // al paso siguiente y el lector cruzaría la pared en balístico
+            PoliticaCola politica = (formatoSalida == FormatoSalida::EVENTOS &&
+                                     politicaCola == PoliticaCola::DESCARTAR)
+                                        ? PoliticaCola::BLOQUEAR : politicaCola;
+            escritorAsincrono = new EscritorAsincrono(escritor, &registroColisiones,
+                                                      politica, capacidadCola);
+        }
+    }
 
-            if (archivosTrayectorias.find(id) == archivosTrayectorias.end()) {
-                ofstream* nuevoArchivo = new ofstream();
-                nuevoArchivo->open("trayectoria_" + to_string(id) + ".txt");
-                archivosTrayectorias[id] = nuevoArchivo;
+    // Copiar las partículas activas al frame del paso
+    frame.limpiarParticulas();
+    frame.paso = pasoActual;
+    frame.tiempo = tiempoActual;
+    int n = particulas.tamano();
+    if (!particulasReordenadas) {
+        // Sin reordenar, el índice sigue el orden de alta (el de id)
+        for (int i = 0; i < n; i++) {
+            if (particulas.activa[i]) {
+                frame.id.push_back(particulas.id[i]);
+                frame.x.push_back(particulas.x[i]);
+                frame.y.push_back(particulas.y[i]);
+                frame.vx.push_back(particulas.vx[i]);
+                frame.vy.push_back(particulas.vy[i]);
             }
-
-            *archivosTrayectorias[id] << fixed << setprecision(3)
-                                      << pos.getX() << " " << pos.getY() << endl;
+        }
+    } else {
+        // Tras un reorden de Morton se recorre por id: el archivo no cambia
+        indicePorId.assign(siguienteIdParticula, -1);
+        for (int i = 0; i < n; i++) {
+            if (particulas.activa[i]) indicePorId[particulas.id[i]] = i;
+        }
+        for (int i : indicePorId) {
+            if (i < 0) continue;
+            frame.id.push_back(particulas.id[i]);
+            frame.x.push_back(particulas.x[i]);
+            frame.y.push_back(particulas.y[i]);
+            frame.vx.push_back(particulas.vx[i]);
+            frame.vy.push_back(particulas.vy[i]);
         }
     }
-}
 
-void Simulador::registrarColision(const string& tipo, int id1, int id2) {
-    archivoColisiones << fixed << setprecision(3)
-    << tiempoActual << " " << tipo << " " << id1;
-    if (id2 != -1)
-        archivoColisiones << " " << id2;
-    archivoColisiones << endl;
+    if (escritorAsincrono) {
+        // Solo se intercambia el buffer; el disco lo atiende el otro hilo
+        escritorAsincrono->encolar(frame);
+    } else {
+        escritor->escribirFrame(frame);
+        registroColisiones.escribir(frame.eventos);
+        frame.limpiar();
+    }
+
+    segundosEnSalida += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
 }
 
-void Simulador::abrirArchivos() {
-    archivoColisiones.open("colisiones.txt");
-    if (!archivoColisiones.is_open()) {
-        cerr << "Error al abrir archivo de colisiones" << endl;
-    }
-    archivoColisiones << "# tiempo tipo id1 [id2]" << endl;
+template <typename T>
+void Simulador<T>::registrarColision(const char* tipo, int id1, int id2) {
+    if (!salidaArchivos) return;
+
+    // Se escribe con el frame del paso, en guardarEstadoActual()
+    frame.eventos.push_back(EventoColision{tiempoActual, tipo, id1, id2});
 }
 
-void Simulador::cerrarArchivos() {
-    if (archivoColisiones.is_open()) archivoColisiones.close();
+template <typename T>
+void Simulador<T>::abrirArchivos() {
+    if (!salidaArchivos) return;
+
+    registroColisiones.abrir();
+}
 
-    for (auto& par : archivosTrayectorias) {
-        if (par.second && par.second->is_open()) {
-            par.second->close();
-            delete par.second;
+template <typename T>
+void Simulador<T>::cerrarArchivos() {
+    if (escritorAsincrono) {
+        escritorAsincrono->detener();   // Escribe los frames pendientes
+        if (detallesConsola) {
+            cout << "Escritura asíncrona: " << fixed << setprecision(2)
+                 << escritorAsincrono->getSegundosBloqueado() * 1000.0 << " ms de espera, "
+                 << escritorAsincrono->getFramesDescartados() << " frames descartados, "
+                 << "máximo en cola " << escritorAsincrono->getMaximoEnCola() << endl;
         }
+        delete escritorAsincrono;
+        escritorAsincrono = nullptr;
+    }
+    registroColisiones.cerrar();
+
+    if (escritor) {
+        escritor->cerrar();
+        bytesTrayectorias += escritor->getBytesEscritos();
+        delete escritor;
+        escritor = nullptr;
     }
-    archivosTrayectorias.clear();
 }
 
-void Simulador::limpiarParticulasInactivas() {
-    // No eliminar de memoria, solo mantener marcadas como inactivas
+template <typename T>
+void Simulador<T>::limpiarParticulasInactivas() {
+    // Las partículas fusionadas salen de los arreglos densos y su slot
+    // queda libre para las próximas; el id de las vivas no cambia
+    particulas.compactar();
+}
+
+template <typename T>
+void Simulador<T>::reordenarParticulas() {
+    // Lo que se indexa por posición en el almacén viaja con la permutación:
+    // estado de contacto y slots (dentro del almacén) y listas de vecinos.
+    // El arranque en caliente del solver va por id y no cambia
+    ordenMorton.calcular(particulas, ordenParticulas);
+    particulas.reordenar(ordenParticulas);
+    listaVecinos.remapear(ordenParticulas);
+    particulasReordenadas = true;
+    reordenamientos++;
+}
+
+template <typename T>
+long long Simulador<T>::getColisionesParticulas() const {
+    return totalColisionesParticulas;
+}
+
+template <typename T>
+double Simulador<T>::getEnergiaPerdidaParticulas() const {
+    switch (tipoColisionActual) {
+    case TipoColision::ELASTICA: return motorElastico.getEnergiaPerdida();
+    case TipoColision::INELASTICA: return motorInelastico.getEnergiaPerdida();
+    default: return motorFusion.getEnergiaPerdida();
+    }
 }
 
-int Simulador::contarParticulasActivas() const {
+template <typename T>
+int Simulador<T>::contarParticulasActivas() const {
     int count = 0;
-    for (const Particula* p : particulas) {
-        if (p->estaActiva()) count++;
+    for (unsigned char a : particulas.activa) {
+        if (a) count++;
     }
     return count;
 }
 
-void Simulador::mostrarEstadisticas() const {
+template <typename T>
+void Simulador<T>::mostrarEstadisticas() const {
     cout << endl;
     cout << "===============================================" << endl;
     cout << "             ESTADÍSTICAS FINALES              " << endl;
@@ -314,15 +662,212 @@ void Simulador::mostrarEstadisticas() const {
     cout << "Tiempo simulado: " << fixed << setprecision(2) << tiempoActual << " s" << endl;
     cout << "Pasos ejecutados: " << pasoActual << endl;
     cout << "Partículas activas: " << contarParticulasActivas()
-         << " / " << particulas.size() << endl;
+         << " / " << siguienteIdParticula << " creadas" << endl;
     cout << endl;
     cout << "COLISIONES DETECTADAS:" << endl;
     cout << "  • Con paredes (elásticas): " << totalColisionesParedes << endl;
     cout << "  • Con obstáculos (inelásticas): " << totalColisionesObstaculos << endl;
-    cout << "  • Fusiones de partículas: " << totalColisionesParticulas << endl;
+    if (tipoColisionActual == TipoColision::COMPLETAMENTE_INELASTICA)
+        cout << "  • Fusiones de partículas: " << totalColisionesParticulas << endl;
+    else
+        cout << "  • Entre partículas (modo gas): " << totalColisionesParticulas << endl;
     cout << "  • Total: " << (totalColisionesParedes + totalColisionesObstaculos + totalColisionesParticulas) << endl;
+    cout << "  • Pasos en contacto sin nueva colisión: " << pasosEnContacto << endl;
+    cout << "Pares evaluados (broadphase): " << getParesEvaluados() << endl;
+    cout << "Tiempo en salida (hilo de simulación): "
+         << segundosEnSalida * 1000.0 << " ms" << endl;
+    if (solverActivo) {
+        cout << "Solver de contactos: " << solver.getIteraciones() << " pasada(s)"
+             << (solver.getArranqueEnCaliente() ? ", arranque en caliente" : "")
+             << ", " << solver.getNumColores() << " colores en el último paso" << endl;
+    }
+    if (grillaJerarquicaActiva && !dominios && !listaVecinosActiva) {
+        cout << "Grilla jerárquica: " << grillaJerarquica.getNumeroNiveles()
+             << " niveles en el último paso" << endl;
+    }
+    if (listaVecinosActiva && !dominios) {
+        cout << "Listas de vecinos (piel " << listaVecinos.getPiel() << "): "
+             << listaVecinos.getReconstrucciones() << " reconstrucciones en "
+             << listaVecinos.getConsultas() << " pasos ("
+             << listaVecinos.getFrecuenciaReconstruccion() * 100.0 << "%)" << endl;
+    }
+    if (dominios) dominios->mostrarEstadisticas();
+}
+
+template <typename T>
+void Simulador<T>::setSalidaArchivos(bool habilitada) {
+    salidaArchivos = habilitada;
+}
+
+template <typename T>
+void Simulador<T>::setFormatoSalida(FormatoSalida formato) {
+    formatoSalida = formato;
+}
+
+template <typename T>
+void Simulador<T>::setPrecisionSalida(double posicion, double velocidad) {
+    precisionPosicion = posicion;
+    precisionVelocidad = velocidad;
+}
+
+template <typename T>
+void Simulador<T>::setSalidaAsincrona(bool habilitada, PoliticaCola politica, int capacidad) {
+    salidaAsincrona = habilitada;
+    politicaCola = politica;
+    capacidadCola = capacidad;
+}
+
+template <typename T>
+void Simulador<T>::setHilos(int numHilos) {
+    delete pool;
+    pool = (numHilos > 1) ? new PoolHilos(numHilos) : nullptr;
+}
+
+template <typename T>
+int Simulador<T>::getHilos() const {
+    return pool ? pool->getNumHilos() : 1;
+}
+
+template <typename T>
+void Simulador<T>::setDominios(int numDominios, bool rebalanceo) {
+    delete dominios;
+    dominios = nullptr;
+    if (numDominios > 1) {
+        dominios = new DescomposicionDominiosT<T>(numDominios, ancho);
+        dominios->setRebalanceo(rebalanceo);
+        dominios->setIsa(getIsa());
+    }
+}
+
+template <typename T>
+const DescomposicionDominiosT<T>* Simulador<T>::getDominios() const {
+    return dominios;
+}
+
+template <typename T>
+void Simulador<T>::setIsa(IsaSimd isa) {
+    kernels = &kernelsPara<T>(isa);
+    grilla.setIsa(isa);
+    grillaJerarquica.setIsa(isa);
+    listaVecinos.setIsa(isa);
+    if (dominios) dominios->setIsa(isa);
+}
+
+template <typename T>
+IsaSimd Simulador<T>::getIsa() const {
+    return kernels->isa;
+}
+
+template <typename T>
+void Simulador<T>::setSolverContactos(bool activo, int iteraciones, bool arranqueEnCaliente) {
+    solverActivo = activo;
+    solver.setIteraciones(iteraciones);
+    solver.setArranqueEnCaliente(arranqueEnCaliente);
+}
+
+template <typename T>
+const SolverContactosT<T>& Simulador<T>::getSolverContactos() const {
+    return solver;
+}
+
+template <typename T>
+void Simulador<T>::setBarridoPorColores(bool activo) {
+    barridoPorColores = activo;
+}
+
+template <typename T>
+bool Simulador<T>::getBarridoPorColores() const {
+    return barridoPorColores;
+}
+
+template <typename T>
+void Simulador<T>::setGrillaJerarquica(bool activa) {
+    grillaJerarquicaActiva = activa;
+}
+
+template <typename T>
+const GrillaJerarquicaT<T>& Simulador<T>::getGrillaJerarquica() const {
+    return grillaJerarquica;
+}
+
+template <typename T>
+void Simulador<T>::setListaVecinos(bool activa, double piel) {
+    listaVecinosActiva = activa;
+    listaVecinos.setPiel(static_cast<T>(piel));
+}
+
+template <typename T>
+const ListaVecinosT<T>& Simulador<T>::getListaVecinos() const {
+    return listaVecinos;
+}
+
+template <typename T>
+void Simulador<T>::setReordenMorton(int cadaPasos) {
+    pasosEntreReordenes = max(cadaPasos, 0);
+}
+
+template <typename T>
+long long Simulador<T>::getReordenamientos() const {
+    return reordenamientos;
+}
+
+template <typename T>
+void Simulador<T>::setCampoDistancia(bool activo, double resolucion, double cotaError) {
+    campoDistanciaActivo = activo;
+    campoDistancia.configurar(static_cast<T>(resolucion), static_cast<T>(cotaError));
+    campoDistanciaValido = false;
+}
+
+template <typename T>
+const CampoDistanciaT<T>& Simulador<T>::getCampoDistancia() const {
+    return campoDistancia;
+}
+
+template <typename T>
+void Simulador<T>::setDetallesConsola(bool habilitados) {
+    detallesConsola = habilitados;
+}
+
+template <typename T>
+long long Simulador<T>::getBytesTrayectorias() const {
+    return bytesTrayectorias + (escritor ? escritor->getBytesEscritos() : 0);
+}
+
+template <typename T>
+long long Simulador<T>::getTotalColisiones() const {
+    return static_cast<long long>(totalColisionesParedes) + totalColisionesObstaculos +
+           totalColisionesParticulas;
 }
 
-bool Simulador::verificarEstancamiento() const {
+template <typename T>
+double Simulador<T>::getSegundosEnSalida() const {
+    return segundosEnSalida;
+}
+
+template <typename T>
+long long Simulador<T>::getFramesDescartados() const {
+    return escritorAsincrono ? escritorAsincrono->getFramesDescartados() : 0;
+}
+
+template <typename T>
+const AlmacenParticulasT<T>& Simulador<T>::getParticulas() const {
+    return particulas;
+}
+
+template <typename T>
+long long Simulador<T>::getParesEvaluados() const {
+    return grilla.getParesEvaluados() + grillaJerarquica.getParesEvaluados() +
+           listaVecinos.getParesEvaluados() +
+           (dominios ? dominios->getParesEvaluados() : 0);
+}
+
+template <typename T>
+bool Simulador<T>::verificarEstancamiento() const {
+    // En el modo gas el número de partículas nunca cambia
+    if (tipoColisionActual != TipoColision::COMPLETAMENTE_INELASTICA) return false;
     return contadorPasosEstancado > 1000;
 }
+
+// --- Instancias ---
+template class Simulador<float>;
+template class Simulador<double>;
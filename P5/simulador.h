@@ -6,24 +6,46 @@
 #include <string>
 #include <fstream>
 #include "particula.h"
+#include "almacenparticulas.h"
 #include "obstaculo.h"
+#include "bvhobstaculos.h"
+#include "campodistancia.h"
 #include "colision.h"
 #include "colisionmanager.h"
-
-enum class TipoColision {
-    ELASTICA,
-    INELASTICA,
-    COMPLETAMENTE_INELASTICA
-};
+#include "grillaespacial.h"
+#include "grillajerarquica.h"
+#include "listavecinos.h"
+#include "ordenmorton.h"
+#include "poolhilos.h"
+#include "descomposiciondominios.h"
+#include "solvercontactos.h"
+#include "kernelsparticulas.h"
+#include "escritortrayectorias.h"
+#include "escritorasincrono.h"
 
 /**
  * @brief Clase principal que gestiona toda la simulación de partículas.
  *
  * Tipos de colisiones implementados:
  * 1. Partículas vs Paredes: ELÁSTICAS (conserva energía)
- * 2. Partículas vs Obstáculos: INELÁSTICAS (con coeficiente de restitución)
- * 3. Partículas vs Partículas: COMPLETAMENTE INELÁSTICAS (fusión)
+ * 2. Partículas vs Obstáculos: INELÁSTICAS (con coeficiente de restitución);
+ *    con setCampoDistancia, contra un campo de distancia horneado
+ * 3. Partículas vs Partículas: según el TipoColision del constructor
+ *    - COMPLETAMENTE_INELASTICA: fusión (el modo original)
+ *    - ELASTICA / INELASTICA: modo gas, choques por impulso sin fusión; el
+ *      número de partículas no cambia y el bucle de pares se instancia
+ *      con el modelo concreto (sin virtuales). Con setSolverContactos los
+ *      contactos se resuelven por colores en paralelo (SolverContactos);
+ *      con setBarridoPorColores, el mismo choque por par repartido por
+ *      colores en el pool
+ *
+ * T es el escalar del estado físico: Simulador<double> (por defecto) o
+ * Simulador<float>, con la mitad de memoria por partícula y el doble de
+ * partículas por instrucción SIMD. Tiempo, archivos y estadísticas siguen
+ * en double. Las definiciones están en simulador.cpp, instanciadas para
+ * ambos.
  */
+template <typename T = double>
 class Simulador {
 private:
     // --- Parámetros de la simulación ---
@@ -35,9 +57,10 @@ private:
     int pasoActual;
 
     // --- Estadísticas ---
-    int totalColisionesParticulas;
+    long long totalColisionesParticulas;   // Fusiones o choques del modo gas
     int totalColisionesObstaculos;
     int totalColisionesParedes;
+    long long pasosEnContacto;         // Pasos con un contacto ya registrado (no se cuentan)
 
     // --- Control de estado ---
     int contadorPasosEstancado;
@@ -45,16 +68,61 @@ private:
     int siguienteIdParticula;
 
     // --- Entidades ---
-    std::vector<Particula*> particulas;
-    std::vector<Obstaculo> obstaculos;
+    AlmacenParticulasT<T> particulas;  // Estructura de arreglos (SoA)
+    std::vector<ObstaculoT<T>> obstaculos;
+    BvhObstaculosT<T> bvhObstaculos;   // Se reconstruye si cambian los obstáculos
+    bool bvhObstaculosValido;
+    CampoDistanciaT<T> campoDistancia; // Opcional: una consulta por partícula
+    bool campoDistanciaActivo;
+    bool campoDistanciaValido;
 
     // --- Sistema de colisiones ---
-    Colision* motorColisiones;
+    ModeloColision<T, TipoColision::COMPLETAMENTE_INELASTICA> motorFusion;   // Sin virtuales
+    ModeloColision<T, TipoColision::ELASTICA> motorElastico;                 // Modo gas
+    ModeloColision<T, TipoColision::INELASTICA> motorInelastico;             // Modo gas
     TipoColision tipoColisionActual;
+    SolverContactosT<T> solver;                         // Modo gas por colores (opcional)
+    bool solverActivo;
+    bool barridoPorColores;                             // Modo gas: pares por colores en el pool
+    GrillaEspacialT<T> grilla;                          // Broadphase y fase fina
+    GrillaJerarquicaT<T> grillaJerarquica;              // Opcional: radios muy dispares
+    bool grillaJerarquicaActiva;
+    ListaVecinosT<T> listaVecinos;                      // Opcional: pares reutilizados entre pasos
+    bool listaVecinosActiva;
+    std::vector<std::pair<int, int>> paresContacto;     // Reutilizado cada paso
+    OrdenMortonT<T> ordenMorton;                        // Reorden periódico del almacén
+    std::vector<int> ordenParticulas;
+    std::vector<int> indicePorId;                       // Salida en orden de id tras reordenar
+    int pasosEntreReordenes;           // 0: nunca
+    long long reordenamientos;
+    bool particulasReordenadas;        // El índice ya no sigue el orden de id
+    std::vector<int> raizFusion;                        // Union-find de grupos solapados
+    std::vector<std::pair<int, int>> miembrosFusion;    // (raíz, índice) de cada absorbida
+    std::vector<int> grupoIndices;                      // Trabajo de fusionarGrupo
+    std::vector<ParticulaT<T>> grupoFusion;             // Trabajo de fusionarGrupo
+    std::vector<unsigned char> marcaContacto;           // Evento de pared/obstáculo por índice
+    std::vector<unsigned char> paredesTocadas;          // Salida de reflejarParedes
+    const KernelsParticulasT<T>* kernels;               // Integración y paredes (SIMD)
+
+    // --- Paralelismo ---
+    PoolHilos* pool;                   // nullptr: paso serial
+    DescomposicionDominiosT<T>* dominios;  // nullptr: una sola grilla para toda la caja
 
     // --- Archivos ---
-    std::ofstream archivoColisiones;
-    std::map<int, std::ofstream*> archivosTrayectorias;
+    RegistroColisiones registroColisiones;
+    EscritorTrayectorias* escritor;    // Se crea con el primer frame
+    EscritorAsincrono* escritorAsincrono;
+    FormatoSalida formatoSalida;
+    double precisionPosicion;          // Cuantización del formato COMPRIMIDO
+    double precisionVelocidad;
+    FrameTrayectoria frame;            // Colisiones y estado del paso en curso
+    long long bytesTrayectorias;       // De escritores ya cerrados
+    bool salidaAsincrona;              // Escritura en un hilo aparte
+    PoliticaCola politicaCola;
+    int capacidadCola;
+    double segundosEnSalida;           // Tiempo del hilo de simulación en la salida
+    bool salidaArchivos;       // Escribir trayectorias y colisiones
+    bool detallesConsola;      // Mensaje por cada fusión
 
 public:
     // --- Constructores / Destructores ---
@@ -62,7 +130,8 @@ public:
     ~Simulador();
 
     // --- Gestión de entidades ---
-    void agregarParticula(double x, double y, double vx, double vy, double masa, double radio);
+    ManejadorParticula agregarParticula(double x, double y, double vx, double vy,
+                                        double masa, double radio);
     void agregarObstaculo(double x, double y, double lado, double coefRestitucion);
     void configurarObstaculos(int cantidad);
 
@@ -72,27 +141,96 @@ public:
     void ejecutarPaso();
     void finalizar();
 
+    // --- Configuración de salida ---
+    void setSalidaArchivos(bool habilitada);
+    void setFormatoSalida(FormatoSalida formato);
+    void setPrecisionSalida(double posicion, double velocidad);
+    void setSalidaAsincrona(bool habilitada, PoliticaCola politica = PoliticaCola::BLOQUEAR,
+                            int capacidad = 2);
+    void cerrarArchivos();     // Vacía y cierra la salida (también lo hace finalizar)
+    void setDetallesConsola(bool habilitados);
+
+    // --- Paralelismo (mismo resultado, bit a bit, que el paso serial) ---
+    void setHilos(int numHilos);       // <= 1: paso serial
+    int getHilos() const;
+    void setDominios(int numDominios, bool rebalanceo = true);   // <= 1: una sola grilla
+    const DescomposicionDominiosT<T>* getDominios() const;
+    void setIsa(IsaSimd isa);          // Por defecto la mejor que soporte el procesador
+    IsaSimd getIsa() const;
+
+    // --- Modo gas: solver de contactos por colores (paralelo, mismo
+    //     resultado con cualquier número de hilos) o barrido serial por pares ---
+    void setSolverContactos(bool activo, int iteraciones = 1, bool arranqueEnCaliente = false);
+    const SolverContactosT<T>& getSolverContactos() const;
+    // Choque por par (como el barrido serial) en orden de colores y en el
+    // pool: mismo resultado con cualquier número de hilos, distinto del
+    // orden de la lista. setSolverContactos tiene prioridad
+    void setBarridoPorColores(bool activo);
+    bool getBarridoPorColores() const;
+
+    // --- Obstáculos por campo de distancia horneado (resolución y cota de
+    //     error en píxeles); si no, se prueba obstáculo por obstáculo ---
+    void setCampoDistancia(bool activo, double resolucion = 2.0, double cotaError = 0.5);
+    const CampoDistanciaT<T>& getCampoDistancia() const;
+
+    // --- Broadphase por niveles (un nivel por escala de radio): mismos
+    //     pares que la grilla única, sin degradarse cuando las fusiones
+    //     crean partículas enormes. Sin efecto con setDominios ---
+    void setGrillaJerarquica(bool activa);
+    const GrillaJerarquicaT<T>& getGrillaJerarquica() const;
+
+    // --- Listas de vecinos de Verlet (mismos pares que la grilla; se
+    //     reconstruyen cuando alguna partícula se mueve más de piel/2).
+    //     Sin efecto con setDominios ---
+    void setListaVecinos(bool activa, double piel = 5.0);
+    const ListaVecinosT<T>& getListaVecinos() const;
+
+    // --- Localidad: reordenar el almacén por código de Morton de la celda
+    //     cada tantos pasos (0 = nunca). La salida sigue en orden de id y
+    //     las listas de vecinos se remapean; el orden de los pares cambia,
+    //     así que el resultado no es idéntico bit a bit al sin reorden ---
+    void setReordenMorton(int cadaPasos);
+    long long getReordenamientos() const;
+
+    // --- Estadísticas ---
+    long long getParesEvaluados() const;
+    long long getBytesTrayectorias() const;
+    double getSegundosEnSalida() const;
+    long long getFramesDescartados() const;
+    long long getTotalColisiones() const;      // Paredes + obstáculos + fusiones (o choques)
+    long long getColisionesParticulas() const; // Fusiones o choques del modo gas
+    double getEnergiaPerdidaParticulas() const;   // Del modelo entre partículas
+    int contarParticulasActivas() const;
+    const AlmacenParticulasT<T>& getParticulas() const;
+
 private:
     // --- Lógica interna ---
     void actualizarPosiciones();
     void detectarYResolverColisiones();
     void detectarColisionesParedes();      // Elásticas
     void detectarColisionesObstaculos();   // Inelásticas
-    void detectarColisionesEntreParticulas(); // Fusión
+    void detectarColisionesEntreParticulas(); // Fusión o modo gas
+    void fusionarContactos();
+    template <typename Modelo>
+    void resolverChoquesGas(Modelo& modelo);
 
-    void fusionarParticulas(Particula* p1, Particula* p2);
+    void repartir(int n, const PoolHilos::Tarea& tarea);   // Serial si no hay pool
+    void fusionarGrupo(const std::vector<int>& miembros);
+    int buscarRaiz(int i);
 
     // --- Archivos y registro ---
     void abrirArchivos();
-    void cerrarArchivos();
     void guardarEstadoActual();
-    void registrarColision(const std::string& tipo, int id1, int id2 = -1);
+    void registrarColision(const char* tipo, int id1, int id2 = -1);
 
     // --- Utilidades ---
     void limpiarParticulasInactivas();
-    int contarParticulasActivas() const;
+    void reordenarParticulas();
     bool verificarEstancamiento() const;
     void mostrarEstadisticas() const;
 };
 
+extern template class Simulador<float>;
+extern template class Simulador<double>;
+
 #endif // SIMULADOR_H
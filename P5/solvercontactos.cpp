@@ -0,0 +1,283 @@
+#include "solvercontactos.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Velocidad de acercamiento (px/s) bajo la cual un contacto no rebota: queda
+// en reposo (objetivo 0) y su impulso sirve para el arranque en caliente
+const double UMBRAL_REBOTE = 1.0;
+
+// Clave de un contacto entre dos ids (independiente del orden de los índices)
+uint64_t claveContacto(int idA, int idB) {
+    uint32_t menor = static_cast<uint32_t>(min(idA, idB));
+    uint32_t mayor = static_cast<uint32_t>(max(idA, idB));
+    return (static_cast<uint64_t>(menor) << 32) | mayor;
+}
+
+} // namespace
+
+template <typename T>
+SolverContactosT<T>::SolverContactosT()
+    : iteraciones(1), arranqueEnCaliente(false),
+    numColores(0), contactosResto(0), contactosCalientes(0) {}
+
+// --- Configuración ---
+template <typename T>
+void SolverContactosT<T>::setIteraciones(int n) {
+    iteraciones = max(1, n);
+}
+
+template <typename T>
+void SolverContactosT<T>::setArranqueEnCaliente(bool activo) {
+    arranqueEnCaliente = activo;
+    if (!activo) impulsosPrevios.clear();
+}
+
+template <typename T>
+int SolverContactosT<T>::getIteraciones() const {
+    return iteraciones;
+}
+
+template <typename T>
+bool SolverContactosT<T>::getArranqueEnCaliente() const {
+    return arranqueEnCaliente;
+}
+
+// --- Resolución ---
+template <typename T>
+ContadoresColisionT<T> SolverContactosT<T>::resolver(AlmacenParticulasT<T>& particulas,
+                                                     const vector<pair<int, int>>& pares,
+                                                     T restitucion, PoolHilos* pool) {
+    ContadoresColisionT<T> total;
+    choques.assign(pares.size(), 0);
+    if (pares.empty()) {
+        impulsosPrevios.clear();
+        return total;
+    }
+
+    colorear(pares, particulas.tamano());
+
+    // Normal, masa efectiva, objetivo e impulso inicial (solo lectura del almacén)
+    ContadoresColisionT<T> c = porBloques(0, contactos.size(), pool,
+        [&](int desde, int hasta, ContadoresColisionT<T>& contadores) {
+            preparar(particulas, restitucion, desde, hasta, contadores);
+        });
+    total.colisiones += c.colisiones;
+
+    // Arranque en caliente: el impulso del paso anterior se aplica de entrada
+    contactosCalientes = 0;
+    if (arranqueEnCaliente) {
+        for (const Contacto& contacto : contactos) {
+            if (contacto.impulso > 0) contactosCalientes++;
+        }
+        if (contactosCalientes > 0) {
+            c = porColores(pool, [&](int desde, int hasta, ContadoresColisionT<T>& contadores) {
+                for (int k = desde; k < hasta; k++) {
+                    Contacto& contacto = contactos[k];
+                    if (contacto.impulso > 0) {
+                        aplicarImpulso(particulas, contacto, contacto.impulso, contadores);
+                    }
+                }
+            });
+            total.energiaPerdida += c.energiaPerdida;
+        }
+    }
+
+    // Pasadas de impulsos secuenciales con impulso acumulado no negativo
+    for (int it = 0; it < iteraciones; it++) {
+        c = porColores(pool, [&](int desde, int hasta, ContadoresColisionT<T>& contadores) {
+            for (int k = desde; k < hasta; k++) {
+                Contacto& contacto = contactos[k];
+                int i = contacto.i;
+                int j = contacto.j;
+                T vn = (particulas.vx[i] - particulas.vx[j]) * contacto.nx +
+                       (particulas.vy[i] - particulas.vy[j]) * contacto.ny;
+                T delta = (vn - contacto.vnObjetivo) * contacto.masaEfectiva;
+                T nuevo = max(T(0), contacto.impulso + delta);
+                delta = nuevo - contacto.impulso;
+                contacto.impulso = nuevo;
+                if (delta != 0) aplicarImpulso(particulas, contacto, delta, contadores);
+            }
+        });
+        total.energiaPerdida += c.energiaPerdida;
+    }
+
+    // Separación de solapamientos, también por colores
+    porColores(pool, [&](int desde, int hasta, ContadoresColisionT<T>&) {
+        for (int k = desde; k < hasta; k++) {
+            int i = contactos[k].i;
+            int j = contactos[k].j;
+            VectorT<T> r1(particulas.x[i], particulas.y[i]);
+            VectorT<T> r2(particulas.x[j], particulas.y[j]);
+            if (separarSolapados(r1, r2, particulas.radio[i] + particulas.radio[j],
+                                 particulas.masa[i], particulas.masa[j])) {
+                particulas.x[i] = r1.getX(); particulas.y[i] = r1.getY();
+                particulas.x[j] = r2.getX(); particulas.y[j] = r2.getY();
+            }
+        }
+    });
+
+    if (arranqueEnCaliente) guardarImpulsos(particulas);
+    return total;
+}
+
+template <typename T>
+void SolverContactosT<T>::colorear(const vector<pair<int, int>>& pares, int n) {
+    // Greedy en el orden de la lista: el menor color libre en ambos extremos.
+    // Los contactos sin color libre (más de MAX_COLORES) van al color resto
+    int total = pares.size();
+    mascara.resize(max<size_t>(mascara.size(), n), 0);
+    colorDe.resize(total);
+    numColores = 0;
+    contactosResto = 0;
+
+    for (int k = 0; k < total; k++) {
+        int i = pares[k].first;
+        int j = pares[k].second;
+        uint64_t usados = mascara[i] | mascara[j];
+        int color = MAX_COLORES;
+        if (usados != ~uint64_t(0)) {
+            color = countr_zero(~usados);
+            mascara[i] |= uint64_t(1) << color;
+            mascara[j] |= uint64_t(1) << color;
+            numColores = max(numColores, color + 1);
+        } else {
+            contactosResto++;
+        }
+        colorDe[k] = color;
+    }
+    for (const auto& par : pares) {
+        mascara[par.first] = 0;
+        mascara[par.second] = 0;
+    }
+
+    // Ordenamiento por conteo: los colores en orden y el resto al final
+    int grupos = contactosResto > 0 ? MAX_COLORES + 1 : numColores;
+    inicioColor.assign(grupos + 1, 0);
+    for (int k = 0; k < total; k++) inicioColor[min(colorDe[k], grupos - 1) + 1]++;
+    for (int c = 0; c < grupos; c++) inicioColor[c + 1] += inicioColor[c];
+
+    contactos.resize(total);
+    vector<int> inicio(inicioColor.begin(), inicioColor.end() - 1);
+    for (int k = 0; k < total; k++) {
+        int posicion = inicio[min(colorDe[k], grupos - 1)]++;
+        contactos[posicion].i = pares[k].first;
+        contactos[posicion].j = pares[k].second;
+        contactos[posicion].origen = k;
+    }
+}
+
+template <typename T>
+void SolverContactosT<T>::preparar(const AlmacenParticulasT<T>& particulas, T restitucion,
+                                   int desde, int hasta, ContadoresColisionT<T>& contadores) {
+    for (int k = desde; k < hasta; k++) {
+        Contacto& c = contactos[k];
+        int i = c.i;
+        int j = c.j;
+
+        VectorT<T> n = VectorT<T>(particulas.x[j] - particulas.x[i],
+                                  particulas.y[j] - particulas.y[i]).normalizadoOCero();
+        if (n == VectorT<T>()) n = VectorT<T>(1, 0);   // Centros coincidentes
+        c.nx = n.getX();
+        c.ny = n.getY();
+        c.masaEfectiva = 1 / (1 / particulas.masa[i] + 1 / particulas.masa[j]);
+
+        // n va de i a j: se acercan si (vi - vj)·n > 0
+        T vn0 = (particulas.vx[i] - particulas.vx[j]) * c.nx +
+                (particulas.vy[i] - particulas.vy[j]) * c.ny;
+        c.vnObjetivo = vn0 > UMBRAL_REBOTE ? -restitucion * vn0 : T(0);
+        if (vn0 > 0) {
+            choques[c.origen] = 1;
+            contadores.colisiones++;
+        }
+
+        c.impulso = 0;
+        if (arranqueEnCaliente && !impulsosPrevios.empty()) {
+            uint64_t clave = claveContacto(particulas.id[i], particulas.id[j]);
+            auto it = lower_bound(impulsosPrevios.begin(), impulsosPrevios.end(), clave,
+                                  [](const pair<uint64_t, T>& e, uint64_t v) { return e.first < v; });
+            if (it != impulsosPrevios.end() && it->first == clave) c.impulso = it->second;
+        }
+    }
+}
+
+template <typename T>
+void SolverContactosT<T>::aplicarImpulso(AlmacenParticulasT<T>& particulas, Contacto& c, T delta,
+                                         ContadoresColisionT<T>& contadores) const {
+    // delta > 0 separa: i pierde velocidad a lo largo de n y j la gana
+    int i = c.i;
+    int j = c.j;
+    T m1 = particulas.masa[i];
+    T m2 = particulas.masa[j];
+    VectorT<T> n(c.nx, c.ny);
+    VectorT<T> v1(particulas.vx[i], particulas.vy[i]);
+    VectorT<T> v2(particulas.vx[j], particulas.vy[j]);
+
+    T energiaAntes = T(0.5) * m1 * v1.magnitudCuadrada() + T(0.5) * m2 * v2.magnitudCuadrada();
+    v1.sumarEscalado(n, -delta / m1);
+    v2.sumarEscalado(n, delta / m2);
+    T energiaDespues = T(0.5) * m1 * v1.magnitudCuadrada() + T(0.5) * m2 * v2.magnitudCuadrada();
+    contadores.energiaPerdida += energiaAntes - energiaDespues;
+
+    particulas.vx[i] = v1.getX(); particulas.vy[i] = v1.getY();
+    particulas.vx[j] = v2.getX(); particulas.vy[j] = v2.getY();
+}
+
+template <typename T>
+void SolverContactosT<T>::guardarImpulsos(const AlmacenParticulasT<T>& particulas) {
+    // Solo los contactos en reposo: el impulso de un rebote no se repite
+    impulsosPrevios.clear();
+    for (const Contacto& c : contactos) {
+        if (c.impulso > 0 && c.vnObjetivo == 0) {
+            impulsosPrevios.emplace_back(claveContacto(particulas.id[c.i], particulas.id[c.j]),
+                                         c.impulso);
+        }
+    }
+    sort(impulsosPrevios.begin(), impulsosPrevios.end());
+}
+
+// --- Estadísticas ---
+template <typename T>
+void SolverContactosT<T>::calcularResiduo(const AlmacenParticulasT<T>& particulas,
+                                          double& medio, double& maximo) const {
+    medio = maximo = 0.0;
+    for (const Contacto& c : contactos) {
+        double vn = (particulas.vx[c.i] - particulas.vx[c.j]) * c.nx +
+                    (particulas.vy[c.i] - particulas.vy[c.j]) * c.ny;
+        // Solo cuenta un contacto que empuja (impulso > 0) o aún se acerca
+        double exceso = vn - c.vnObjetivo;
+        if (c.impulso == 0 && exceso < 0) exceso = 0;
+        exceso = abs(exceso);
+        medio += exceso;
+        maximo = max(maximo, exceso);
+    }
+    if (!contactos.empty()) medio /= contactos.size();
+}
+
+template <typename T>
+const vector<unsigned char>& SolverContactosT<T>::getChoques() const {
+    return choques;
+}
+
+template <typename T>
+int SolverContactosT<T>::getNumColores() const {
+    return numColores;
+}
+
+template <typename T>
+int SolverContactosT<T>::getContactosResto() const {
+    return contactosResto;
+}
+
+template <typename T>
+long long SolverContactosT<T>::getContactosCalientes() const {
+    return contactosCalientes;
+}
+
+// --- Instancias ---
+template class SolverContactosT<float>;
+template class SolverContactosT<double>;
@@ -0,0 +1,196 @@
+#ifndef SOLVER_CONTACTOS_H
+#define SOLVER_CONTACTOS_H
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include "almacenparticulas.h"
+#include "colision.h"
+#include "poolhilos.h"
+
+/**
+ * @brief Resolución en paralelo de los contactos del modo gas por colores
+ *
+ * El barrido par por par de ColisionInelastica depende del orden: cada
+ * separación mueve partículas que comparten otros contactos. Aquí los
+ * contactos son las aristas de un grafo sobre las partículas y se colorean
+ * (greedy, en el orden de la lista) de modo que ningún color repite
+ * partícula. Cada color es un lote de contactos independientes que se
+ * reparte en el pool sin carreras; los colores van en orden, así que el
+ * resultado es el mismo con cualquier número de hilos.
+ *
+ * Cada pasada aplica impulsos secuenciales (Gauss-Seidel por colores) con
+ * impulso acumulado no negativo por contacto; el objetivo es la velocidad
+ * normal de rebote -e·vn0 si se acercan a más de UMBRAL_REBOTE, y 0 si no.
+ * Con una pasada y sin arranque en caliente, un contacto aislado que se
+ * acerca a más de UMBRAL_REBOTE recibe el mismo impulso que en
+ * resolverColision; si una partícula tiene varios contactos, el orden por
+ * colores no es el de la lista y las velocidades ya difieren. Con más pasadas
+ * los contactos de un montón denso se ajustan entre sí, y el arranque en
+ * caliente empieza cada contacto que persiste con el impulso acumulado del
+ * paso anterior, así que converge en pocas pasadas. Al final una pasada por
+ * colores separa los solapamientos.
+ *
+ * Los contadores (choques y energía perdida) se llevan por bloque de
+ * trabajo y se suman en orden de bloque.
+ *
+ * barrerPorColores reparte igual los pares pero resuelve cada uno con el
+ * resolverColision del modelo (el mismo choque por par que el barrido serial
+ * de la lista, en orden de colores); es el modo gas en paralelo sin pasadas.
+ */
+template <typename T>
+class SolverContactosT {
+private:
+    struct Contacto {
+        int i;
+        int j;
+        int origen;           // Posición en la lista de pares recibida
+        T nx, ny;             // Normal de i a j al inicio del paso
+        T masaEfectiva;       // 1 / (1/m1 + 1/m2)
+        T vnObjetivo;         // Velocidad normal buscada tras el choque
+        T impulso;            // Acumulado en el paso (>= 0)
+    };
+
+    // --- Configuración ---
+    int iteraciones;
+    bool arranqueEnCaliente;
+
+    // --- Contactos ordenados por color ---
+    std::vector<Contacto> contactos;
+    std::vector<int> inicioColor;            // Inicio de cada color en 'contactos'
+    std::vector<int> colorDe;                // Trabajo de colorear
+    std::vector<std::uint64_t> mascara;      // Colores usados por cada partícula
+    std::vector<unsigned char> choques;      // Por par recibido: se acercaba al inicio
+    std::vector<ContadoresColisionT<T>> contadoresPorBloque;
+
+    // --- Arranque en caliente: (clave de ids, impulso) del paso anterior ---
+    std::vector<std::pair<std::uint64_t, T>> impulsosPrevios;
+
+    // --- Estadísticas ---
+    int numColores;
+    int contactosResto;                      // Sin color libre: se resuelven en serie
+    long long contactosCalientes;            // Empezados con impulso previo
+
+public:
+    static constexpr int MAX_COLORES = 64;   // Bits de la máscara por partícula
+    static constexpr int TAMANO_BLOQUE = 2048;   // Contactos por tarea del pool
+
+    SolverContactosT();
+
+    // --- Configuración ---
+    void setIteraciones(int n);              // Pasadas de impulsos (>= 1)
+    void setArranqueEnCaliente(bool activo);
+    int getIteraciones() const;
+    bool getArranqueEnCaliente() const;
+
+    // Resuelve los pares en contacto (índices del almacén) con restitución e
+    ContadoresColisionT<T> resolver(AlmacenParticulasT<T>& particulas,
+                                    const std::vector<std::pair<int, int>>& pares,
+                                    T restitucion, PoolHilos* pool);
+
+    // Cada par con modelo.resolverColision, color por color; los pares de
+    // un color no comparten partículas y van en paralelo
+    template <typename Modelo>
+    ContadoresColisionT<T> barrerPorColores(AlmacenParticulasT<T>& particulas,
+                                            const std::vector<std::pair<int, int>>& pares,
+                                            const Modelo& modelo, PoolHilos* pool);
+
+    // Por par de la última llamada: 1 si se acercaba al inicio (un choque)
+    const std::vector<unsigned char>& getChoques() const;
+
+    // Velocidad normal que aún excede el objetivo, media y máxima sobre los
+    // contactos del último paso (0 = convergido); para medir las pasadas
+    void calcularResiduo(const AlmacenParticulasT<T>& particulas,
+                         double& medio, double& maximo) const;
+
+    // --- Estadísticas ---
+    int getNumColores() const;
+    int getContactosResto() const;
+    long long getContactosCalientes() const;
+
+private:
+    void colorear(const std::vector<std::pair<int, int>>& pares, int n);
+    void preparar(const AlmacenParticulasT<T>& particulas, T restitucion,
+                  int desde, int hasta, ContadoresColisionT<T>& contadores);
+    void aplicarImpulso(AlmacenParticulasT<T>& particulas, Contacto& c, T delta,
+                        ContadoresColisionT<T>& contadores) const;
+    void guardarImpulsos(const AlmacenParticulasT<T>& particulas);
+
+    // Tarea(desde, hasta, contadores) sobre cada color en orden, repartida
+    // por bloques; los contadores de los bloques se suman en orden
+    template <typename Tarea>
+    ContadoresColisionT<T> porBloques(int desde, int hasta, PoolHilos* pool, const Tarea& tarea);
+    template <typename Tarea>
+    ContadoresColisionT<T> porColores(PoolHilos* pool, const Tarea& tarea);
+};
+
+// --- Barrido y reparto (plantillas sobre la tarea o el modelo) ---
+template <typename T>
+template <typename Modelo>
+ContadoresColisionT<T> SolverContactosT<T>::barrerPorColores(AlmacenParticulasT<T>& particulas,
+                                                             const std::vector<std::pair<int, int>>& pares,
+                                                             const Modelo& modelo, PoolHilos* pool) {
+    choques.assign(pares.size(), 0);
+    if (pares.empty()) return ContadoresColisionT<T>();
+
+    colorear(pares, particulas.tamano());
+    return porColores(pool, [&](int desde, int hasta, ContadoresColisionT<T>& contadores) {
+        for (int k = desde; k < hasta; k++) {
+            if (modelo.resolverColision(particulas, contactos[k].i, contactos[k].j, contadores)) {
+                choques[contactos[k].origen] = 1;
+            }
+        }
+    });
+}
+
+template <typename T>
+template <typename Tarea>
+ContadoresColisionT<T> SolverContactosT<T>::porBloques(int desde, int hasta, PoolHilos* pool,
+                                                       const Tarea& tarea) {
+    // Mismos bloques con y sin pool: los contadores se suman igual
+    int n = hasta - desde;
+    int numBloques = PoolHilos::numeroBloques(n, TAMANO_BLOQUE);
+    contadoresPorBloque.assign(numBloques, ContadoresColisionT<T>());
+
+    if (pool && pool->getNumHilos() > 1 && numBloques > 1) {
+        pool->paraCada(n, TAMANO_BLOQUE, [&](int inicio, int fin, int bloque) {
+            tarea(desde + inicio, desde + fin, contadoresPorBloque[bloque]);
+        });
+    } else {
+        for (int b = 0; b < numBloques; b++) {
+            tarea(desde + b * TAMANO_BLOQUE, desde + std::min(n, (b + 1) * TAMANO_BLOQUE),
+                  contadoresPorBloque[b]);
+        }
+    }
+
+    ContadoresColisionT<T> total;
+    for (const ContadoresColisionT<T>& c : contadoresPorBloque) {
+        total.colisiones += c.colisiones;
+        total.energiaPerdida += c.energiaPerdida;
+    }
+    return total;
+}
+
+template <typename T>
+template <typename Tarea>
+ContadoresColisionT<T> SolverContactosT<T>::porColores(PoolHilos* pool, const Tarea& tarea) {
+    ContadoresColisionT<T> total;
+    int grupos = inicioColor.size() - 1;
+    for (int c = 0; c < grupos; c++) {
+        // El resto comparte partículas entre sí: en serie
+        bool resto = (c == MAX_COLORES);
+        ContadoresColisionT<T> parcial = porBloques(inicioColor[c], inicioColor[c + 1],
+                                                    resto ? nullptr : pool, tarea);
+        total.colisiones += parcial.colisiones;
+        total.energiaPerdida += parcial.energiaPerdida;
+    }
+    return total;
+}
+
+using SolverContactos = SolverContactosT<double>;
+
+extern template class SolverContactosT<float>;
+extern template class SolverContactosT<double>;
+
+#endif // SOLVER_CONTACTOS_H
@@ -4,41 +4,89 @@
 #include <cmath>
 #include <iostream>
 
-class Vector {
+/**
+ * @brief Vector 2D con el escalar como parámetro (float o double)
+ *
+ * Solo cabecera: todas las operaciones son inline (constexpr salvo las que
+ * usan sqrt o atan2), así que en los bucles de colisión el compilador las
+ * expande en el sitio en vez de hacer una llamada por operación.
+ *
+ * Operaciones fusionadas para los caminos calientes:
+ * - magnitudCuadrada(): |v|² sin raíz (energías, comparaciones de distancia)
+ * - normalizadoOCero(): v/|v|, o (0,0) si |v| == 0, con una sola raíz
+ * - sumarEscalado(v, s): this += v*s sin temporal intermedio
+ */
+template <typename T>
+class VectorT {
 private:
-    double x;
-    double y;
+    T x;
+    T y;
 
 public:
     // --- Constructores ---
-    Vector();                       // Vector (0,0)
-    Vector(double x, double y);     // Vector (x, y)
+    constexpr VectorT() noexcept : x(0), y(0) {}                 // Vector (0,0)
+    constexpr VectorT(T x, T y) noexcept : x(x), y(y) {}         // Vector (x, y)
 
     // --- Getters y setters ---
-    double getX() const;
-    double getY() const;
-    void setX(double nx);
-    void setY(double ny);
+    constexpr T getX() const noexcept { return x; }
+    constexpr T getY() const noexcept { return y; }
+    constexpr void setX(T nx) noexcept { x = nx; }
+    constexpr void setY(T ny) noexcept { y = ny; }
 
     // --- Operaciones básicas ---
-    double magnitud() const;            // |v|
-    void normalizar();                  // v -> v/|v|
-    double angulo() const;              // ángulo en radianes
+    constexpr T magnitudCuadrada() const noexcept { return x * x + y * y; }   // |v|²
+    T magnitud() const noexcept { return std::sqrt(magnitudCuadrada()); }    // |v|
+    T angulo() const noexcept { return std::atan2(y, x); }                   // ángulo en radianes
+
+    // v -> v/|v| (sin cambios si |v| == 0)
+    void normalizar() noexcept {
+        T m = magnitud();
+        if (m != 0) {
+            x /= m;
+            y /= m;
+        }
+    }
+
+    // v/|v|, o (0,0) si |v| == 0
+    VectorT normalizadoOCero() const noexcept {
+        T m = magnitud();
+        return m != 0 ? VectorT(x / m, y / m) : VectorT();
+    }
+
+    // this += v*s (mismo redondeo que *this += v * s)
+    constexpr VectorT& sumarEscalado(const VectorT& v, T s) noexcept {
+        x += v.x * s;
+        y += v.y * s;
+        return *this;
+    }
 
     // --- Operadores sobrecargados ---
-    Vector operator+(const Vector& v) const;
-    Vector operator-(const Vector& v) const;
-    Vector operator*(double escalar) const;
-    Vector operator/(double escalar) const;
-    Vector& operator+=(const Vector& v);
-    Vector& operator-=(const Vector& v);
-    bool operator==(const Vector& v) const;
+    constexpr VectorT operator+(const VectorT& v) const noexcept { return VectorT(x + v.x, y + v.y); }
+    constexpr VectorT operator-(const VectorT& v) const noexcept { return VectorT(x - v.x, y - v.y); }
+    constexpr VectorT operator*(T escalar) const noexcept { return VectorT(x * escalar, y * escalar); }
+    constexpr VectorT operator/(T escalar) const noexcept { return VectorT(x / escalar, y / escalar); }
+
+    constexpr VectorT& operator+=(const VectorT& v) noexcept {
+        x += v.x;
+        y += v.y;
+        return *this;
+    }
+
+    constexpr VectorT& operator-=(const VectorT& v) noexcept {
+        x -= v.x;
+        y -= v.y;
+        return *this;
+    }
+
+    constexpr bool operator==(const VectorT& v) const noexcept { return x == v.x && y == v.y; }
 
     // --- Producto punto ---
-    double dot(const Vector& v) const;
+    constexpr T dot(const VectorT& v) const noexcept { return x * v.x + y * v.y; }
 
     // --- Mostrar vector ---
-    void mostrar() const;
+    void mostrar() const { std::cout << "(" << x << ", " << y << ")"; }
 };
 
+using Vector = VectorT<double>;
+
 #endif // VECTOR_H